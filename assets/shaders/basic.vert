@@ -14,6 +14,7 @@ layout(std140) uniform FrameData
 };
 
 uniform mat4 uModel;
+uniform mat3x4 uNormalMatrix;
 
 out vec3 vWorldPos;
 out vec3 vNormal;
@@ -24,7 +25,6 @@ void main()
     vec4 worldPosition = uModel * vec4(aPosition, 1.0);
     gl_Position = uViewProjection * worldPosition;
     vWorldPos = worldPosition.xyz;
-    mat3 normalMatrix = mat3(uModel);
-    vNormal = normalize(normalMatrix * aNormal);
+    vNormal = normalize(mat3(uNormalMatrix) * aNormal);
     vUV = aTexCoord;
 }
@@ -0,0 +1,39 @@
+#version 410 core
+
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+
+// Per-instance Matrix3x4: three row vectors [R | t], 48 bytes per instance (divisor 1).
+layout(location = 3) in vec4 aModelRow0;
+layout(location = 4) in vec4 aModelRow1;
+layout(location = 5) in vec4 aModelRow2;
+// Per-instance inverse-transpose of the upper 3x3, as three columns padded to vec4 (divisor 1).
+layout(location = 6) in vec4 aNormalColumn0;
+layout(location = 7) in vec4 aNormalColumn1;
+layout(location = 8) in vec4 aNormalColumn2;
+
+layout(std140) uniform FrameData
+{
+    mat4 uViewProjection;
+    mat4 uView;
+    vec4 uCameraPositionTime;
+    vec4 uLightDirection;
+    vec4 uLightColor;
+};
+
+out vec3 vWorldPos;
+out vec3 vNormal;
+out vec2 vUV;
+
+void main()
+{
+    // Row-vector product against the columns of mat3x4(rows) gives dot(row_i, (p, 1)) per component.
+    mat3x4 model = mat3x4(aModelRow0, aModelRow1, aModelRow2);
+    vec3 worldPosition = vec4(aPosition, 1.0) * model;
+    gl_Position = uViewProjection * vec4(worldPosition, 1.0);
+    vWorldPos = worldPosition;
+    mat3 normalMatrix = mat3(aNormalColumn0.xyz, aNormalColumn1.xyz, aNormalColumn2.xyz);
+    vNormal = normalize(normalMatrix * aNormal);
+    vUV = aTexCoord;
+}
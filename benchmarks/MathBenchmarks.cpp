@@ -0,0 +1,573 @@
+// Micro-benchmarks for the math hot paths.
+//
+// Usage: nre_math_bench [--filter <substring>] [--level scalar|sse41|avx2|avx512]
+//                       [--min-time-ms <ms>] [--json <results.json>]
+//                       [--baseline <baseline.json>] [--tolerance <percent>]
+//
+// With --baseline, every result is compared against the entry with the same name and batch size
+// in a file previously written with --json; the process exits with 1 if any case got slower by
+// more than the tolerance (default 10%).
+
+#include "Math/FastMath.h"
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+#include "Math/SIMD_Math.h"
+#include "Math/Vector3.h"
+#include "Scene/Transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t kBatchSizes[] = {1, 16, 256, 4096};
+constexpr int kSamples = 5;
+
+struct Options
+{
+    std::string filter;
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerancePercent = 10.0;
+    double minTimeMs = 50.0;
+    bool overrideLevel = false;
+    nre::SIMDLevel level = nre::SIMDLevel::Scalar;
+};
+
+struct Result
+{
+    std::string name;
+    std::size_t batch = 0;
+    double nsPerOp = 0.0;
+    double opsPerSecond = 0.0;
+};
+
+// Keeps the optimizer from discarding benchmark results.
+template <typename T>
+void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Runs body (which performs `batch` operations) until minTimeMs elapses, then reports the median
+// of kSamples such runs.
+double measureNsPerOp(const std::function<void()>& body, std::size_t batch, double minTimeMs)
+{
+    using Clock = std::chrono::steady_clock;
+
+    body();
+
+    std::size_t iterations = 1;
+    for (;;)
+    {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            body();
+        }
+        const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (elapsedMs >= minTimeMs / kSamples || iterations >= (std::size_t{1} << 30))
+        {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    for (int sample = 0; sample < kSamples; ++sample)
+    {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            body();
+        }
+        const double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        samples.push_back(elapsedNs / static_cast<double>(iterations * batch));
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+struct Fixture
+{
+    explicit Fixture(std::size_t count)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> dist(-1.0F, 1.0F);
+
+        matricesA.resize(count);
+        matricesB.resize(count);
+        matricesOut.resize(count);
+        vectors.resize(count);
+        vectorsOut.resize(count);
+        angles.resize(count);
+        floatsOut.resize(count);
+        floatsOut2.resize(count);
+        transforms.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (float& value : matricesA[i].data)
+            {
+                value = dist(rng);
+            }
+            for (float& value : matricesB[i].data)
+            {
+                value = dist(rng);
+            }
+            vectors[i] = {dist(rng) * 10.0F, dist(rng) * 10.0F, dist(rng) * 10.0F};
+            angles[i] = dist(rng) * 10.0F;
+
+            transforms[i].setPosition({dist(rng), dist(rng), dist(rng)});
+            transforms[i].setRotation(nre::Quaternion(dist(rng), dist(rng), dist(rng), dist(rng)).normalized());
+            transforms[i].setScale({1.0F + dist(rng) * 0.5F, 1.0F + dist(rng) * 0.5F, 1.0F + dist(rng) * 0.5F});
+
+            positionX.push_back(transforms[i].position().x);
+            positionY.push_back(transforms[i].position().y);
+            positionZ.push_back(transforms[i].position().z);
+            rotationX.push_back(transforms[i].rotation().x);
+            rotationY.push_back(transforms[i].rotation().y);
+            rotationZ.push_back(transforms[i].rotation().z);
+            rotationW.push_back(transforms[i].rotation().w);
+            scaleX.push_back(transforms[i].scale().x);
+            scaleY.push_back(transforms[i].scale().y);
+            scaleZ.push_back(transforms[i].scale().z);
+        }
+
+        streams.positionX = positionX.data();
+        streams.positionY = positionY.data();
+        streams.positionZ = positionZ.data();
+        streams.rotationX = rotationX.data();
+        streams.rotationY = rotationY.data();
+        streams.rotationZ = rotationZ.data();
+        streams.rotationW = rotationW.data();
+        streams.scaleX = scaleX.data();
+        streams.scaleY = scaleY.data();
+        streams.scaleZ = scaleZ.data();
+    }
+
+    std::vector<nre::Matrix4> matricesA;
+    std::vector<nre::Matrix4> matricesB;
+    std::vector<nre::Matrix4> matricesOut;
+    std::vector<nre::Vector3> vectors;
+    std::vector<nre::Vector3> vectorsOut;
+    std::vector<float> angles;
+    std::vector<float> floatsOut;
+    std::vector<float> floatsOut2;
+    std::vector<nre::Transform> transforms;
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> positionZ;
+    std::vector<float> rotationX;
+    std::vector<float> rotationY;
+    std::vector<float> rotationZ;
+    std::vector<float> rotationW;
+    std::vector<float> scaleX;
+    std::vector<float> scaleY;
+    std::vector<float> scaleZ;
+    nre::TransformStreams streams;
+};
+
+struct Benchmark
+{
+    const char* name;
+    std::function<void(Fixture&, std::size_t)> body;
+};
+
+std::vector<Benchmark> makeBenchmarks()
+{
+    return {
+        {"Matrix4::operator*",
+         [](Fixture& f, std::size_t count)
+         {
+             for (std::size_t i = 0; i < count; ++i)
+             {
+                 f.matricesOut[i] = f.matricesA[i] * f.matricesB[i];
+             }
+             doNotOptimize(f.matricesOut.back());
+         }},
+        {"SIMDMath::multiply4x4",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::SIMDMath::multiply4x4(
+                 f.matricesA.front().dataPtr(), f.matricesB.front().dataPtr(), f.matricesOut.front().dataPtr(), count);
+             doNotOptimize(f.matricesOut.back());
+         }},
+        {"Transform::localMatrix",
+         [](Fixture& f, std::size_t count)
+         {
+             for (std::size_t i = 0; i < count; ++i)
+             {
+                 f.matricesOut[i] = f.transforms[i].localMatrix();
+             }
+             doNotOptimize(f.matricesOut.back());
+         }},
+        {"Transform::composeLocalMatrices",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::Transform::composeLocalMatrices(f.streams, f.matricesOut.data(), count);
+             doNotOptimize(f.matricesOut.back());
+         }},
+        {"Vector3::normalized",
+         [](Fixture& f, std::size_t count)
+         {
+             for (std::size_t i = 0; i < count; ++i)
+             {
+                 const nre::Vector3 n = f.vectors[i].normalized();
+                 doNotOptimize(n);
+             }
+         }},
+        {"FastMath::normalize",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::FastMath::normalize(f.vectors.data(), f.vectorsOut.data(), count);
+             doNotOptimize(f.vectorsOut.back());
+         }},
+        {"std::sin+std::cos",
+         [](Fixture& f, std::size_t count)
+         {
+             for (std::size_t i = 0; i < count; ++i)
+             {
+                 f.floatsOut[i] = std::sin(f.angles[i]);
+                 f.floatsOut2[i] = std::cos(f.angles[i]);
+             }
+             doNotOptimize(f.floatsOut.back());
+         }},
+        {"FastMath::sinCos",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::FastMath::sinCos(f.angles.data(), f.floatsOut.data(), f.floatsOut2.data(), count);
+             doNotOptimize(f.floatsOut.back());
+         }},
+        {"FastMath::rsqrt",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::FastMath::rsqrt(f.scaleX.data(), f.floatsOut.data(), count);
+             doNotOptimize(f.floatsOut.back());
+         }},
+        {"FastMath::exp",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::FastMath::exp(f.angles.data(), f.floatsOut.data(), count);
+             doNotOptimize(f.floatsOut.back());
+         }},
+        {"FastMath::log",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::FastMath::log(f.scaleX.data(), f.floatsOut.data(), count);
+             doNotOptimize(f.floatsOut.back());
+         }},
+        {"FastMath::atan2",
+         [](Fixture& f, std::size_t count)
+         {
+             nre::FastMath::atan2(f.angles.data(), f.positionX.data(), f.floatsOut.data(), count);
+             doNotOptimize(f.floatsOut.back());
+         }},
+        {"Matrix4::lookAt",
+         [](Fixture& f, std::size_t count)
+         {
+             const nre::Vector3 up{0.0F, 1.0F, 0.0F};
+             for (std::size_t i = 0; i < count; ++i)
+             {
+                 f.matricesOut[i] = nre::Matrix4::lookAt(f.vectors[i], nre::Vector3{}, up);
+             }
+             doNotOptimize(f.matricesOut.back());
+         }},
+        {"Matrix4::perspective",
+         [](Fixture& f, std::size_t count)
+         {
+             for (std::size_t i = 0; i < count; ++i)
+             {
+                 const float fov = 0.5F + static_cast<float>(i & 7U) * 0.1F;
+                 f.matricesOut[i] = nre::Matrix4::perspective(fov, 16.0F / 9.0F, 0.1F, 1000.0F);
+             }
+             doNotOptimize(f.matricesOut.back());
+         }},
+    };
+}
+
+bool parseLevel(const std::string& text, nre::SIMDLevel& level)
+{
+    if (text == "scalar")
+    {
+        level = nre::SIMDLevel::Scalar;
+    }
+    else if (text == "sse41")
+    {
+        level = nre::SIMDLevel::SSE41;
+    }
+    else if (text == "avx2")
+    {
+        level = nre::SIMDLevel::AVX2;
+    }
+    else if (text == "avx512")
+    {
+        level = nre::SIMDLevel::AVX512;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--json" && hasValue)
+        {
+            options.jsonPath = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue)
+        {
+            options.baselinePath = argv[++i];
+        }
+        else if (arg == "--tolerance" && hasValue)
+        {
+            options.tolerancePercent = std::atof(argv[++i]);
+        }
+        else if (arg == "--min-time-ms" && hasValue)
+        {
+            options.minTimeMs = std::atof(argv[++i]);
+        }
+        else if (arg == "--level" && hasValue)
+        {
+            if (!parseLevel(argv[++i], options.level))
+            {
+                std::cerr << "Unknown SIMD level: " << argv[i] << '\n';
+                return false;
+            }
+            options.overrideLevel = true;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter <substring>] [--level scalar|sse41|avx2|avx512] [--min-time-ms <ms>]"
+                         " [--json <file>] [--baseline <file>] [--tolerance <percent>]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open benchmark output file: " + path);
+    }
+
+    // One result per line keeps the file diffable and lets readBaseline() stay a line scanner.
+    file << "{\n";
+    file << "  \"simdLevel\": \"" << nre::SIMDMath::levelName(nre::SIMDMath::activeLevel()) << "\",\n";
+    file << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        char line[256];
+        std::snprintf(line,
+                      sizeof(line),
+                      "    {\"name\": \"%s\", \"batch\": %zu, \"nsPerOp\": %.4f, \"opsPerSecond\": %.1f}%s\n",
+                      r.name.c_str(),
+                      r.batch,
+                      r.nsPerOp,
+                      r.opsPerSecond,
+                      i + 1 < results.size() ? "," : "");
+        file << line;
+    }
+    file << "  ]\n";
+    file << "}\n";
+}
+
+bool extractString(const std::string& line, const char* key, std::string& value)
+{
+    const std::string pattern = std::string("\"") + key + "\": \"";
+    const std::size_t begin = line.find(pattern);
+    if (begin == std::string::npos)
+    {
+        return false;
+    }
+    const std::size_t start = begin + pattern.size();
+    const std::size_t end = line.find('"', start);
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+    value = line.substr(start, end - start);
+    return true;
+}
+
+bool extractNumber(const std::string& line, const char* key, double& value)
+{
+    const std::string pattern = std::string("\"") + key + "\": ";
+    const std::size_t begin = line.find(pattern);
+    if (begin == std::string::npos)
+    {
+        return false;
+    }
+    value = std::strtod(line.c_str() + begin + pattern.size(), nullptr);
+    return true;
+}
+
+std::vector<Result> readBaseline(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open benchmark baseline: " + path);
+    }
+
+    std::vector<Result> results;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        Result result;
+        double batch = 0.0;
+        if (extractString(line, "name", result.name) && extractNumber(line, "batch", batch)
+            && extractNumber(line, "nsPerOp", result.nsPerOp))
+        {
+            result.batch = static_cast<std::size_t>(batch);
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+// Returns the number of regressions beyond the tolerance.
+int compareWithBaseline(const std::vector<Result>& results, const std::vector<Result>& baseline, double tolerance)
+{
+    int regressions = 0;
+    std::cout << "\nComparison against baseline (tolerance " << tolerance << "%):\n";
+    for (const Result& current : results)
+    {
+        const auto match = std::find_if(baseline.begin(),
+                                        baseline.end(),
+                                        [&current](const Result& entry)
+                                        { return entry.name == current.name && entry.batch == current.batch; });
+        if (match == baseline.end() || match->nsPerOp <= 0.0)
+        {
+            continue;
+        }
+
+        const double change = (current.nsPerOp - match->nsPerOp) / match->nsPerOp * 100.0;
+        const bool regressed = change > tolerance;
+        regressions += regressed ? 1 : 0;
+
+        char line[256];
+        std::snprintf(line,
+                      sizeof(line),
+                      "  %-36s %6zu  %10.3f -> %10.3f ns/op  %+7.1f%%%s\n",
+                      current.name.c_str(),
+                      current.batch,
+                      match->nsPerOp,
+                      current.nsPerOp,
+                      change,
+                      regressed ? "  REGRESSION" : "");
+        std::cout << line;
+    }
+    return regressions;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 2;
+    }
+    if (options.overrideLevel)
+    {
+        nre::SIMDMath::setActiveLevel(options.level);
+    }
+
+    std::cout << "SIMD level: " << nre::SIMDMath::levelName(nre::SIMDMath::activeLevel()) << " (supported "
+              << nre::SIMDMath::levelName(nre::SIMDMath::supportedLevel()) << ")\n\n";
+
+    char header[128];
+    std::snprintf(header, sizeof(header), "%-36s %6s %12s %14s\n", "benchmark", "batch", "ns/op", "Mops/s");
+    std::cout << header;
+
+    std::vector<Result> results;
+    const std::vector<Benchmark> benchmarks = makeBenchmarks();
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (!options.filter.empty() && std::strstr(benchmark.name, options.filter.c_str()) == nullptr)
+        {
+            continue;
+        }
+
+        for (const std::size_t batch : kBatchSizes)
+        {
+            Fixture fixture(batch);
+            const double nsPerOp = measureNsPerOp(
+                [&benchmark, &fixture, batch]() { benchmark.body(fixture, batch); }, batch, options.minTimeMs);
+
+            Result result;
+            result.name = benchmark.name;
+            result.batch = batch;
+            result.nsPerOp = nsPerOp;
+            result.opsPerSecond = nsPerOp > 0.0 ? 1.0e9 / nsPerOp : 0.0;
+            results.push_back(result);
+
+            char line[128];
+            std::snprintf(line,
+                          sizeof(line),
+                          "%-36s %6zu %12.3f %14.2f\n",
+                          benchmark.name,
+                          batch,
+                          nsPerOp,
+                          result.opsPerSecond / 1.0e6);
+            std::cout << line;
+        }
+    }
+
+    try
+    {
+        if (!options.jsonPath.empty())
+        {
+            writeJson(options.jsonPath, results);
+            std::cout << "\nWrote " << options.jsonPath << '\n';
+        }
+        if (!options.baselinePath.empty())
+        {
+            const int regressions =
+                compareWithBaseline(results, readBaseline(options.baselinePath), options.tolerancePercent);
+            if (regressions > 0)
+            {
+                std::cout << regressions << " regression(s) beyond tolerance.\n";
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
@@ -120,7 +120,7 @@ int main()
                 glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
                 shader_->bind();
-                shader_->setMatrix4("uModel", nre::Matrix4::identity().dataPtr());
+                setModelMatrix(nre::Matrix4::identity());
                 shader_->setInt("uAlbedo", 0);
                 shader_->unbind();
 
@@ -276,7 +276,7 @@ int main()
                         shader_->reload(reloadResult.sources);
                         shader_->bindUniformBlock("FrameData", 0);
                         shader_->bind();
-                        shader_->setMatrix4("uModel", nre::Matrix4::identity().dataPtr());
+                        setModelMatrix(nre::Matrix4::identity());
                         shader_->setInt("uAlbedo", 0);
                         shader_->unbind();
                     }
@@ -387,6 +387,14 @@ int main()
         }
 
     private:
+        void setModelMatrix(const nre::Matrix4& model)
+        {
+            float normalMatrix[12];
+            nre::Matrix4::normalMatrices(&model, normalMatrix, 1);
+            shader_->setMatrix4("uModel", model.dataPtr());
+            shader_->setMatrix3x4("uNormalMatrix", normalMatrix);
+        }
+
         void captureCursor(bool capture)
         {
             cursorCaptured_ = capture;
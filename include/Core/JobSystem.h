@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nre
+{
+// Fixed pool of worker threads for fork-join data parallelism. The calling thread takes part in
+// every parallelFor(), so a pool with zero workers runs everything inline.
+class JobSystem
+{
+public:
+    // hardware_concurrency() - 1, leaving one core for the calling thread.
+    static std::size_t defaultWorkerCount() noexcept;
+
+    explicit JobSystem(std::size_t workerCount = defaultWorkerCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    std::size_t workerCount() const noexcept { return workers_.size(); }
+
+    // Calls body(index) once for every index in [0, count), in no particular order, and returns when all
+    // calls have finished. The first exception thrown by body is rethrown here. Calls from several
+    // threads are serialized; calling parallelFor() from inside body deadlocks.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+    // Number of contiguous blocks to split count elements into: one per thread, but no block smaller than
+    // minBlockSize, and a single block when jobs is nullptr.
+    static std::size_t blockCount(const JobSystem* jobs, std::size_t count, std::size_t minBlockSize) noexcept;
+    // Calls body(block, begin, end) for blockCount contiguous blocks covering [0, count), inline when there
+    // is a single block and through jobs->parallelFor() otherwise.
+    static void forEachBlock(JobSystem* jobs,
+                             std::size_t blockCount,
+                             std::size_t count,
+                             const std::function<void(std::size_t, std::size_t, std::size_t)>& body);
+
+private:
+    void workerLoop();
+    void runIndices();
+
+    std::vector<std::thread> workers_;
+    std::mutex callMutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(std::size_t)>* body_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::size_t busyWorkers_ = 0;
+    std::uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+} // namespace nre
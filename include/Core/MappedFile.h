@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace nre
+{
+// Read-only memory mapping of a whole file. Pages are loaded on first touch, so opening is cheap and
+// only the parts that are read cost I/O.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    // Throws std::runtime_error when the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Page aligned; nullptr for an empty or closed file.
+    const std::byte* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    void release() noexcept;
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
+} // namespace nre
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+namespace nre
+{
+struct BoundingBox
+{
+    Vector3 min;
+    Vector3 max;
+};
+
+struct BoundingSphere
+{
+    Vector3 center;
+    float radius = 0.0F;
+};
+
+// Inverted box: merging into it yields the other box, and it overlaps nothing.
+inline BoundingBox emptyBox()
+{
+    constexpr float kHuge = std::numeric_limits<float>::max();
+    return {{kHuge, kHuge, kHuge}, {-kHuge, -kHuge, -kHuge}};
+}
+
+inline BoundingBox merge(const BoundingBox& a, const BoundingBox& b)
+{
+    return {{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+            {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}};
+}
+
+// Touching boxes overlap.
+inline bool overlaps(const BoundingBox& a, const BoundingBox& b)
+{
+    return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y
+           && a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+inline bool encloses(const BoundingBox& outer, const BoundingBox& inner)
+{
+    return outer.min.x <= inner.min.x && outer.max.x >= inner.max.x && outer.min.y <= inner.min.y
+           && outer.max.y >= inner.max.y && outer.min.z <= inner.min.z && outer.max.z >= inner.max.z;
+}
+
+inline bool encloses(const BoundingSphere& sphere, const BoundingBox& box)
+{
+    const Vector3 farthest{std::max(std::abs(box.min.x - sphere.center.x), std::abs(box.max.x - sphere.center.x)),
+                           std::max(std::abs(box.min.y - sphere.center.y), std::abs(box.max.y - sphere.center.y)),
+                           std::max(std::abs(box.min.z - sphere.center.z), std::abs(box.max.z - sphere.center.z))};
+    return farthest.lengthSquared() <= sphere.radius * sphere.radius;
+}
+
+// Zero for points inside the box.
+inline float squaredDistanceToBox(const Vector3& point, const BoundingBox& box)
+{
+    const Vector3 closest{std::clamp(point.x, box.min.x, box.max.x),
+                          std::clamp(point.y, box.min.y, box.max.y),
+                          std::clamp(point.z, box.min.z, box.max.z)};
+    return (closest - point).lengthSquared();
+}
+
+// Box around the transformed corners under an affine matrix: the center moves, and each world axis
+// gathers the local extents weighted by the absolute matrix entries.
+inline BoundingBox transformBounds(const BoundingBox& bounds, const Matrix4& matrix)
+{
+    const Vector3 center = (bounds.min + bounds.max) * 0.5F;
+    const Vector3 extent = (bounds.max - bounds.min) * 0.5F;
+    const auto transformRow = [&matrix, &center, &extent](int row, float& worldCenter, float& worldExtent)
+    {
+        worldCenter = matrix.at(row, 0) * center.x + matrix.at(row, 1) * center.y + matrix.at(row, 2) * center.z
+                      + matrix.at(row, 3);
+        worldExtent = std::abs(matrix.at(row, 0)) * extent.x + std::abs(matrix.at(row, 1)) * extent.y
+                      + std::abs(matrix.at(row, 2)) * extent.z;
+    };
+    Vector3 worldCenter;
+    Vector3 worldExtent;
+    transformRow(0, worldCenter.x, worldExtent.x);
+    transformRow(1, worldCenter.y, worldExtent.y);
+    transformRow(2, worldCenter.z, worldExtent.z);
+    return {worldCenter - worldExtent, worldCenter + worldExtent};
+}
+
+// Half the surface area, the SAH cost measure; zero for empty boxes.
+inline float halfSurfaceArea(const BoundingBox& box)
+{
+    const float x = box.max.x - box.min.x;
+    const float y = box.max.y - box.min.y;
+    const float z = box.max.z - box.min.z;
+    if (x < 0.0F)
+    {
+        return 0.0F;
+    }
+    return x * y + y * z + z * x;
+}
+
+// Structure-of-arrays views over N bounds; every stream must hold at least N floats.
+struct BoundingSphereStreams
+{
+    const float* centerX = nullptr;
+    const float* centerY = nullptr;
+    const float* centerZ = nullptr;
+    const float* radius = nullptr;
+};
+
+struct BoundingBoxStreams
+{
+    const float* minX = nullptr;
+    const float* minY = nullptr;
+    const float* minZ = nullptr;
+    const float* maxX = nullptr;
+    const float* maxY = nullptr;
+    const float* maxZ = nullptr;
+};
+} // namespace nre
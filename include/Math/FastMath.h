@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Math/Vector3.h"
+
+namespace nre
+{
+// Polynomial approximations of the <cmath> transcendentals over float arrays, dispatched on
+// SIMDMath::activeLevel(). Error bounds are maximum ulp against the correctly rounded result,
+// measured over the stated domain at every SIMD level. Outputs may alias the matching input.
+class FastMath
+{
+public:
+    // sin and cos of each angle (radians). For |x| <= 8192: max 2 ulp where |result| >= 1e-3 and
+    // 1e-9 absolute closer to the zeros. Accuracy degrades beyond that; non-finite angles produce NaN.
+    static void sinCos(const float* angles, float* sines, float* cosines, std::size_t count) noexcept;
+    // 1 / sqrt(x): hardware estimate plus one Newton-Raphson step, max 4 ulp. Inputs smaller in
+    // magnitude than FLT_MIN return +-infinity; infinity returns 0 and negative inputs NaN.
+    static void rsqrt(const float* in, float* out, std::size_t count) noexcept;
+    // e^x, max 1 ulp for normal results. Overflows to infinity above ~88.72 and underflows
+    // gradually through the denormal range to 0.
+    static void exp(const float* in, float* out, std::size_t count) noexcept;
+    // Natural logarithm, max 1 ulp. log(0) is -infinity and negative inputs return NaN.
+    static void log(const float* in, float* out, std::size_t count) noexcept;
+    // atan2(y, x) in [-pi, pi], max 4 ulp, with the signed-zero and infinity conventions of std::atan2.
+    static void atan2(const float* y, const float* x, float* out, std::size_t count) noexcept;
+
+    // out[i] = in[i].normalized(), using rsqrt() for the reciprocal lengths. out may alias in.
+    static void normalize(const Vector3* in, Vector3* out, std::size_t count) noexcept;
+};
+} // namespace nre
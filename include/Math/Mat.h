@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Math/Vec.h"
+
+namespace nre
+{
+// R x C matrix stored column-major (element (row, column) at data[column * R + row]), matching OpenGL.
+// Default-constructs to zero; use identity() for square matrices.
+template <typename T, std::size_t R, std::size_t C>
+struct Mat
+{
+    static constexpr std::size_t rows = R;
+    static constexpr std::size_t columns = C;
+
+    std::array<T, R * C> data{};
+
+    static constexpr Mat identity() noexcept
+    {
+        Mat result;
+        for (std::size_t i = 0; i < (R < C ? R : C); ++i)
+        {
+            result.data[i * R + i] = T{1};
+        }
+        return result;
+    }
+
+    constexpr T& at(int row, int column) noexcept
+    {
+        return data[static_cast<std::size_t>(column) * R + static_cast<std::size_t>(row)];
+    }
+    constexpr T at(int row, int column) const noexcept
+    {
+        return data[static_cast<std::size_t>(column) * R + static_cast<std::size_t>(row)];
+    }
+
+    constexpr Vec<T, R> column(std::size_t index) const noexcept
+    {
+        Vec<T, R> result;
+        for (std::size_t row = 0; row < R; ++row)
+        {
+            result[row] = data[index * R + row];
+        }
+        return result;
+    }
+
+    constexpr Vec<T, C> row(std::size_t index) const noexcept
+    {
+        Vec<T, C> result;
+        for (std::size_t col = 0; col < C; ++col)
+        {
+            result[col] = data[col * R + index];
+        }
+        return result;
+    }
+
+    constexpr Mat<T, C, R> transposed() const noexcept
+    {
+        Mat<T, C, R> result;
+        for (std::size_t col = 0; col < C; ++col)
+        {
+            for (std::size_t row = 0; row < R; ++row)
+            {
+                result.data[row * C + col] = data[col * R + row];
+            }
+        }
+        return result;
+    }
+
+    template <std::size_t K>
+    constexpr Mat<T, R, K> operator*(const Mat<T, C, K>& rhs) const noexcept
+    {
+        Mat<T, R, K> result;
+        for (std::size_t col = 0; col < K; ++col)
+        {
+            for (std::size_t row = 0; row < R; ++row)
+            {
+                T sum{};
+                for (std::size_t i = 0; i < C; ++i)
+                {
+                    sum += data[i * R + row] * rhs.data[col * C + i];
+                }
+                result.data[col * R + row] = sum;
+            }
+        }
+        return result;
+    }
+
+    constexpr Vec<T, R> operator*(const Vec<T, C>& vector) const noexcept
+    {
+        Vec<T, R> result;
+        for (std::size_t col = 0; col < C; ++col)
+        {
+            for (std::size_t row = 0; row < R; ++row)
+            {
+                result[row] += data[col * R + row] * vector[col];
+            }
+        }
+        return result;
+    }
+
+    constexpr bool operator==(const Mat& rhs) const noexcept
+    {
+        for (std::size_t i = 0; i < R * C; ++i)
+        {
+            if (data[i] != rhs.data[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr bool operator!=(const Mat& rhs) const noexcept { return !(*this == rhs); }
+
+    T* dataPtr() noexcept { return data.data(); }
+    const T* dataPtr() const noexcept { return data.data(); }
+};
+} // namespace nre
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+
+#include "Math/Matrix4.h"
+#include "Math/Vec.h"
+
+namespace nre
+{
+// Affine transform stored as three aligned row vectors [R | t]; the (0, 0, 0, 1) last row is implied.
+// Unlike Matrix4 this is row-major: each row is one 16-byte register and transforming a point is
+// three 4-wide dot products against (x, y, z, 1). 48 bytes instead of 64.
+//
+// GPU convention: upload the three rows as-is, either as three vec4 instance attributes or as a
+// std140 `vec4 rows[3]` (array stride 48), and rebuild in GLSL with
+// `mat4 model = transpose(mat4(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0)));`.
+// See assets/shaders/instanced.vert.
+struct alignas(16) Matrix3x4
+{
+    std::array<Vector4, 3> rows{Vector4{1.0F, 0.0F, 0.0F, 0.0F},
+                                Vector4{0.0F, 1.0F, 0.0F, 0.0F},
+                                Vector4{0.0F, 0.0F, 1.0F, 0.0F}};
+
+    static constexpr Matrix3x4 identity() noexcept { return {}; }
+
+    // Drops the last row of an affine matrix.
+    static constexpr Matrix3x4 fromMatrix4(const Matrix4& matrix) noexcept
+    {
+        Matrix3x4 result;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                result.at(row, column) = matrix.at(row, column);
+            }
+        }
+        return result;
+    }
+
+    constexpr Matrix4 toMatrix4() const noexcept
+    {
+        Matrix4 result;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                result.at(row, column) = at(row, column);
+            }
+        }
+        return result;
+    }
+
+    constexpr float& at(int row, int column) noexcept
+    {
+        return rows[static_cast<std::size_t>(row)][static_cast<std::size_t>(column)];
+    }
+    constexpr float at(int row, int column) const noexcept
+    {
+        return rows[static_cast<std::size_t>(row)][static_cast<std::size_t>(column)];
+    }
+
+    constexpr Vector3 transformPoint(const Vector3& point) const noexcept
+    {
+        const Vector4 p{point.x, point.y, point.z, 1.0F};
+        return {Vector4::dot(rows[0], p), Vector4::dot(rows[1], p), Vector4::dot(rows[2], p)};
+    }
+
+    constexpr Vector3 transformVector(const Vector3& vector) const noexcept
+    {
+        const Vector4 v{vector.x, vector.y, vector.z, 0.0F};
+        return {Vector4::dot(rows[0], v), Vector4::dot(rows[1], v), Vector4::dot(rows[2], v)};
+    }
+
+    // Affine composition: (*this * rhs) applies rhs first.
+    constexpr Matrix3x4 operator*(const Matrix3x4& rhs) const noexcept
+    {
+        Matrix3x4 result;
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            const Vector4& r = rows[row];
+            Vector4 value = rhs.rows[0] * r.x + rhs.rows[1] * r.y + rhs.rows[2] * r.z;
+            value.w += r.w;
+            result.rows[row] = value;
+        }
+        return result;
+    }
+
+    float* dataPtr() noexcept { return &rows[0].x; }
+    const float* dataPtr() const noexcept { return &rows[0].x; }
+};
+
+static_assert(sizeof(Matrix3x4) == 48, "Matrix3x4 is uploaded as three tightly packed vec4 rows");
+} // namespace nre
@@ -1,31 +1,42 @@
 #pragma once
 
-#include <array>
+#include <cstddef>
 
-#include "Math/Vector3.h"
+#include "Math/Mat.h"
+#include "Math/Vec.h"
 
 namespace nre
 {
-struct Matrix4
+// Column-major 4x4 float matrix. Default-constructs to identity, and the 4x4 product
+// routes through the SIMD kernels; everything else is inherited from Mat.
+struct alignas(16) Matrix4 : Mat<float, 4, 4>
 {
-    std::array<float, 16> data{1.0F, 0.0F, 0.0F, 0.0F,
-                               0.0F, 1.0F, 0.0F, 0.0F,
-                               0.0F, 0.0F, 1.0F, 0.0F,
-                               0.0F, 0.0F, 0.0F, 1.0F};
+    constexpr Matrix4() noexcept : Mat(Mat::identity()) {}
+    constexpr Matrix4(const Mat<float, 4, 4>& matrix) noexcept : Mat(matrix) {}
 
-    static Matrix4 identity();
+    static constexpr Matrix4 identity() noexcept { return {}; }
     static Matrix4 perspective(float fovRadians, float aspectRatio, float nearPlane, float farPlane);
     static Matrix4 translation(const Vector3& translation);
     static Matrix4 scale(const Vector3& scale);
     static Matrix4 lookAt(const Vector3& eye, const Vector3& target, const Vector3& up);
 
+    using Mat::operator*;
     Matrix4 operator*(const Matrix4& rhs) const noexcept;
     Matrix4& operator*=(const Matrix4& rhs) noexcept;
 
-    float* dataPtr() noexcept { return data.data(); }
-    const float* dataPtr() const noexcept { return data.data(); }
+    float determinant() const noexcept;
+    constexpr Matrix4 transposed() const noexcept { return Mat::transposed(); }
+    // General inverse; returns identity when the matrix is singular.
+    Matrix4 inverse() const noexcept;
+    // Assumes the last row is (0, 0, 0, 1).
+    Matrix4 inverseAffine() const noexcept;
+    // Assumes an orthonormal upper 3x3 (rotation + translation only).
+    Matrix4 inverseRigid() const noexcept;
+    // Inverse-transpose of the upper 3x3, embedded in an otherwise identity matrix.
+    Matrix4 normalMatrix() const noexcept;
 
-    float& at(int row, int column) noexcept;
-    float at(int row, int column) const noexcept;
+    // Writes the inverse-transpose upper 3x3 of each model matrix as three columns padded to vec4
+    // (12 floats, 48 bytes per matrix): the std140 layout of a GLSL mat3 and of a mat3x4 uniform.
+    static void normalMatrices(const Matrix4* models, float* out, std::size_t count);
 };
 } // namespace nre
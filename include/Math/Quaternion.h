@@ -1,7 +1,29 @@
 #pragma once
 
+#include <cstddef>
+
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
 namespace nre
 {
+// Structure-of-arrays views over N quaternions.
+struct QuaternionStreams
+{
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const float* z = nullptr;
+    const float* w = nullptr;
+};
+
+struct QuaternionOutputStreams
+{
+    float* x = nullptr;
+    float* y = nullptr;
+    float* z = nullptr;
+    float* w = nullptr;
+};
+
 struct Quaternion
 {
     float x = 0.0F;
@@ -11,5 +33,40 @@ struct Quaternion
 
     constexpr Quaternion() = default;
     constexpr Quaternion(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+    static Quaternion identity() noexcept;
+    static Quaternion fromAxisAngle(const Vector3& axis, float radians) noexcept;
+    // Uses the rotation part of the upper 3x3; per-axis scale is divided out.
+    static Quaternion fromMatrix(const Matrix4& matrix) noexcept;
+
+    Quaternion operator*(const Quaternion& rhs) const noexcept;
+    Quaternion& operator*=(const Quaternion& rhs) noexcept;
+
+    float length() const noexcept;
+    float lengthSquared() const noexcept;
+    Quaternion normalized() const noexcept;
+    Quaternion conjugate() const noexcept;
+    Quaternion inverse() const noexcept;
+
+    Vector3 rotate(const Vector3& vector) const noexcept;
+    Matrix4 toMatrix() const noexcept;
+
+    static float dot(const Quaternion& lhs, const Quaternion& rhs) noexcept;
+    // Both interpolations take the shortest arc and expect unit-length inputs.
+    static Quaternion nlerp(const Quaternion& from, const Quaternion& to, float t) noexcept;
+    static Quaternion slerp(const Quaternion& from, const Quaternion& to, float t) noexcept;
+
+    // Batched blends over SoA arrays: out[i] = blend(from[i], to[i], t[i]). slerpBatch evaluates the slerp
+    // weights with a trig-free polynomial; results stay within about 1e-6 per component of slerp().
+    static void nlerpBatch(const QuaternionStreams& from,
+                           const QuaternionStreams& to,
+                           const float* t,
+                           const QuaternionOutputStreams& out,
+                           std::size_t count);
+    static void slerpBatch(const QuaternionStreams& from,
+                           const QuaternionStreams& to,
+                           const float* t,
+                           const QuaternionOutputStreams& out,
+                           std::size_t count);
 };
 } // namespace nre
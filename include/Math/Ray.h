@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Math/Bounds.h"
+#include "Math/Vector3.h"
+
+namespace nre
+{
+class Ray
+{
+public:
+    Ray() = default;
+    // direction need not be normalized; hit distances are then in units of its length.
+    Ray(const Vector3& origin, const Vector3& direction) noexcept;
+
+    void setOrigin(const Vector3& origin) noexcept { origin_ = origin; }
+    void setDirection(const Vector3& direction) noexcept;
+
+    const Vector3& origin() const noexcept { return origin_; }
+    const Vector3& direction() const noexcept { return direction_; }
+    // Component-wise 1 / direction, cached for slab tests; infinite for axis-parallel rays.
+    const Vector3& inverseDirection() const noexcept { return inverseDirection_; }
+
+    Vector3 at(float t) const noexcept { return origin_ + direction_ * t; }
+
+private:
+    Vector3 origin_;
+    Vector3 direction_{0.0F, 0.0F, -1.0F};
+    Vector3 inverseDirection_{0.0F, 0.0F, -1.0F};
+};
+
+struct RayHit
+{
+    float t = 0.0F;
+    // Barycentric weights of the second and third vertex.
+    float u = 0.0F;
+    float v = 0.0F;
+};
+
+// Eight triangles in SoA lanes, stored as v0 and the edges v1 - v0, v2 - v0. Default lanes are
+// degenerate and never hit.
+struct alignas(32) TrianglePacket8
+{
+    float v0X[8]{};
+    float v0Y[8]{};
+    float v0Z[8]{};
+    float edge1X[8]{};
+    float edge1Y[8]{};
+    float edge1Z[8]{};
+    float edge2X[8]{};
+    float edge2Y[8]{};
+    float edge2Z[8]{};
+
+    void set(std::size_t lane, const Vector3& v0, const Vector3& v1, const Vector3& v2) noexcept;
+};
+
+// Eight boxes in SoA lanes. Default lanes are inverted (min > max) and never hit.
+struct alignas(32) BoxPacket8
+{
+    float minX[8];
+    float minY[8];
+    float minZ[8];
+    float maxX[8];
+    float maxY[8];
+    float maxZ[8];
+
+    BoxPacket8() noexcept;
+    void set(std::size_t lane, const BoundingBox& box) noexcept;
+};
+
+// Eight rays in SoA lanes, e.g. a 2x4 pixel tile or a bundle of bake samples.
+struct alignas(32) RayPacket8
+{
+    float originX[8]{};
+    float originY[8]{};
+    float originZ[8]{};
+    float directionX[8]{};
+    float directionY[8]{};
+    float directionZ[8]{};
+    float inverseDirectionX[8]{};
+    float inverseDirectionY[8]{};
+    float inverseDirectionZ[8]{};
+
+    void set(std::size_t lane, const Ray& ray) noexcept;
+};
+
+// Per-lane results; only lanes whose bit is set in the returned hit mask are meaningful.
+struct alignas(32) HitPacket8
+{
+    float t[8];
+    float u[8];
+    float v[8];
+};
+
+// Ray queries accept hits with t in (0, tMax]. Packet variants return a mask with bit i set when lane i hit.
+class RayMath
+{
+public:
+    // Scalar Moller-Trumbore; two-sided.
+    static bool intersectTriangle(const Ray& ray,
+                                  const Vector3& v0,
+                                  const Vector3& v1,
+                                  const Vector3& v2,
+                                  float tMax,
+                                  RayHit& hit) noexcept;
+    // Scalar slab test; tEntry is clamped to 0 when the origin is inside the box.
+    static bool intersectBox(const Ray& ray, const BoundingBox& box, float tMax, float& tEntry) noexcept;
+
+    // One ray against eight triangles / boxes.
+    static std::uint32_t intersectTriangles8(const Ray& ray,
+                                             const TrianglePacket8& triangles,
+                                             float tMax,
+                                             HitPacket8& hits) noexcept;
+    static std::uint32_t intersectBoxes8(const Ray& ray, const BoxPacket8& boxes, float tMax, float* tEntry) noexcept;
+
+    // Eight rays against one triangle / box; tMax holds one limit per ray.
+    static std::uint32_t intersectTriangle8(const RayPacket8& rays,
+                                            const Vector3& v0,
+                                            const Vector3& v1,
+                                            const Vector3& v2,
+                                            const float* tMax,
+                                            HitPacket8& hits) noexcept;
+    static std::uint32_t intersectBox8(const RayPacket8& rays,
+                                       const BoundingBox& box,
+                                       const float* tMax,
+                                       float* tEntry) noexcept;
+};
+} // namespace nre
@@ -0,0 +1,66 @@
+#pragma once
+
+// Shared configuration for translation units that contain hand-written SIMD kernels.
+// Kernels are compiled per instruction set with function-level target attributes so the
+// library itself can be built for the baseline ISA and select the widest path at runtime.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NRE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(NRE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NRE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NRE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define NRE_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx2,fma")))
+#else
+#define NRE_TARGET_SSE41
+#define NRE_TARGET_AVX2
+#define NRE_TARGET_AVX512
+#endif
+
+// GCC 12 reports _mm512_undefined_ps() inside its own AVX-512 intrinsics as maybe-uninitialized.
+#if defined(__GNUC__) && !defined(__clang__)
+#define NRE_AVX512_KERNELS_BEGIN \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define NRE_AVX512_KERNELS_END _Pragma("GCC diagnostic pop")
+#else
+#define NRE_AVX512_KERNELS_BEGIN
+#define NRE_AVX512_KERNELS_END
+#endif
+
+#if defined(NRE_SIMD_X86)
+namespace nre::simd
+{
+// out[i] = lane i of in[0..7]; converts between eight AoS records and eight SoA registers.
+NRE_TARGET_AVX2 inline void transpose8x8(const __m256* in, __m256* out)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(in[0], in[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(in[0], in[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(in[2], in[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(in[2], in[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(in[4], in[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(in[4], in[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(in[6], in[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(in[6], in[7]);
+
+    const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    out[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    out[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    out[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    out[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    out[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    out[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    out[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    out[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+} // namespace nre::simd
+#endif
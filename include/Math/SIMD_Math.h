@@ -1,12 +1,40 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 namespace nre
 {
+struct Matrix3x4;
+struct Matrix4;
+
+enum class SIMDLevel : std::uint8_t
+{
+    Scalar,
+    SSE41,
+    AVX2,
+    AVX512
+};
+
 class SIMDMath
 {
 public:
+    // Widest instruction set reported by CPUID and enabled by the OS.
+    static SIMDLevel supportedLevel() noexcept;
+    // Instruction set used by the batch kernels; defaults to supportedLevel().
+    static SIMDLevel activeLevel() noexcept;
+    // Clamped to supportedLevel(). Intended for benchmarks and reference comparisons.
+    static void setActiveLevel(SIMDLevel level) noexcept;
+    static const char* levelName(SIMDLevel level) noexcept;
+
+    // Column-major 4x4 products: out[i] = lhs[i] * rhs[i]. out may alias lhs or rhs.
     static void multiply4x4(const float* lhs, const float* rhs, float* out, std::size_t count);
+    static void multiply4x4Scalar(const float* lhs, const float* rhs, float* out, std::size_t count);
+    static void multiply4x4Aligned(const Matrix4* lhs, const Matrix4* rhs, Matrix4* out, std::size_t count);
+
+    // Affine products out[i] = lhs[i] * rhs[i] with the implied (0, 0, 0, 1) row. out may alias lhs or rhs.
+    static void multiply3x4(const Matrix3x4* lhs, const Matrix3x4* rhs, Matrix3x4* out, std::size_t count);
+    // Drops the last row of each affine Matrix4, e.g. when filling 48-byte instance or bone buffers.
+    static void packAffine(const Matrix4* in, Matrix3x4* out, std::size_t count);
 };
 } // namespace nre
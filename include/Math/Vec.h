@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace nre
+{
+namespace detail
+{
+// Storage is split out so the common sizes get named members while Vec keeps one set of operators.
+template <typename T, std::size_t N>
+struct VecStorage
+{
+    T elements[N]{};
+
+    constexpr T& get(std::size_t index) noexcept { return elements[index]; }
+    constexpr const T& get(std::size_t index) const noexcept { return elements[index]; }
+};
+
+template <typename T>
+struct VecStorage<T, 2>
+{
+    T x{};
+    T y{};
+
+    constexpr VecStorage() = default;
+    constexpr VecStorage(T x_, T y_) : x(x_), y(y_) {}
+
+    constexpr T& get(std::size_t index) noexcept { return index == 0 ? x : y; }
+    constexpr const T& get(std::size_t index) const noexcept { return index == 0 ? x : y; }
+};
+
+template <typename T>
+struct VecStorage<T, 3>
+{
+    T x{};
+    T y{};
+    T z{};
+
+    constexpr VecStorage() = default;
+    constexpr VecStorage(T x_, T y_, T z_) : x(x_), y(y_), z(z_) {}
+
+    constexpr T& get(std::size_t index) noexcept { return index == 0 ? x : (index == 1 ? y : z); }
+    constexpr const T& get(std::size_t index) const noexcept { return index == 0 ? x : (index == 1 ? y : z); }
+};
+
+// Four-wide vectors are register sized and aligned so loads and stores can use aligned moves.
+template <typename T>
+struct alignas(sizeof(T) * 4) VecStorage<T, 4>
+{
+    T x{};
+    T y{};
+    T z{};
+    T w{};
+
+    constexpr VecStorage() = default;
+    constexpr VecStorage(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+    constexpr T& get(std::size_t index) noexcept
+    {
+        return index == 0 ? x : (index == 1 ? y : (index == 2 ? z : w));
+    }
+    constexpr const T& get(std::size_t index) const noexcept
+    {
+        return index == 0 ? x : (index == 1 ? y : (index == 2 ? z : w));
+    }
+};
+} // namespace detail
+
+template <typename T, std::size_t N>
+struct Vec : detail::VecStorage<T, N>
+{
+    static_assert(std::is_arithmetic_v<T>, "Vec requires an arithmetic element type");
+
+    using value_type = T;
+    static constexpr std::size_t size = N;
+
+    using detail::VecStorage<T, N>::VecStorage;
+    constexpr Vec() = default;
+
+    constexpr T& operator[](std::size_t index) noexcept
+    {
+        assert(index < N && "Vec index out of range");
+        return this->get(index);
+    }
+    constexpr T operator[](std::size_t index) const noexcept
+    {
+        assert(index < N && "Vec index out of range");
+        return this->get(index);
+    }
+
+    constexpr Vec operator+(const Vec& rhs) const noexcept
+    {
+        Vec result;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            result.get(i) = this->get(i) + rhs.get(i);
+        }
+        return result;
+    }
+
+    constexpr Vec operator-(const Vec& rhs) const noexcept
+    {
+        Vec result;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            result.get(i) = this->get(i) - rhs.get(i);
+        }
+        return result;
+    }
+
+    constexpr Vec operator-() const noexcept
+    {
+        Vec result;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            result.get(i) = -this->get(i);
+        }
+        return result;
+    }
+
+    constexpr Vec operator*(T scalar) const noexcept
+    {
+        Vec result;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            result.get(i) = this->get(i) * scalar;
+        }
+        return result;
+    }
+
+    constexpr Vec operator/(T scalar) const noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return *this * (T{1} / scalar);
+        }
+        else
+        {
+            Vec result;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                result.get(i) = this->get(i) / scalar;
+            }
+            return result;
+        }
+    }
+
+    constexpr Vec& operator+=(const Vec& rhs) noexcept { return *this = *this + rhs; }
+    constexpr Vec& operator-=(const Vec& rhs) noexcept { return *this = *this - rhs; }
+    constexpr Vec& operator*=(T scalar) noexcept { return *this = *this * scalar; }
+    constexpr Vec& operator/=(T scalar) noexcept { return *this = *this / scalar; }
+
+    constexpr bool operator==(const Vec& rhs) const noexcept
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (this->get(i) != rhs.get(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr bool operator!=(const Vec& rhs) const noexcept { return !(*this == rhs); }
+
+    constexpr T lengthSquared() const noexcept { return dot(*this, *this); }
+    T length() const noexcept { return std::sqrt(lengthSquared()); }
+
+    // Returns the zero vector for zero-length input.
+    Vec normalized() const noexcept
+    {
+        const T len = length();
+        if (len > T{0})
+        {
+            return *this / len;
+        }
+        return Vec{};
+    }
+
+    static constexpr T dot(const Vec& lhs, const Vec& rhs) noexcept
+    {
+        T result{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            result += lhs.get(i) * rhs.get(i);
+        }
+        return result;
+    }
+
+    template <std::size_t M = N, std::enable_if_t<M == 3, int> = 0>
+    static constexpr Vec cross(const Vec& lhs, const Vec& rhs) noexcept
+    {
+        return Vec{lhs.y * rhs.z - lhs.z * rhs.y, lhs.z * rhs.x - lhs.x * rhs.z, lhs.x * rhs.y - lhs.y * rhs.x};
+    }
+};
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> operator*(T scalar, const Vec<T, N>& vector) noexcept
+{
+    return vector * scalar;
+}
+
+using Vector2 = Vec<float, 2>;
+using Vector3 = Vec<float, 3>;
+using Vector4 = Vec<float, 4>;
+} // namespace nre
@@ -15,6 +15,7 @@ public:
     void upload(const std::vector<Vertex>& vertices,
                 const std::vector<std::uint32_t>& indices) override;
     void draw() const override;
+    void drawInstanced(const Matrix3x4* instances, const float* normalMatrices, std::size_t count) const override;
     std::size_t indexCount() const noexcept override { return indexCount_; }
     std::size_t vertexCount() const noexcept override { return vertexCount_; }
 
@@ -22,6 +23,10 @@ private:
     unsigned int vao_ = 0;
     unsigned int vbo_ = 0;
     unsigned int ebo_ = 0;
+    // Created by the first drawInstanced() and grown to the largest instance count seen.
+    mutable unsigned int instanceVbo_ = 0;
+    mutable unsigned int instanceNormalVbo_ = 0;
+    mutable std::size_t instanceCapacity_ = 0;
     std::uint32_t indexCount_ = 0;
     std::uint32_t vertexCount_ = 0;
 };
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Math/Matrix3x4.h"
+#include "Math/Matrix4.h"
+
+namespace nre
+{
+class Material;
+class Mesh;
+class Shader;
+
+// Draws sharing a mesh, shader and material; their transforms are instances()[first, first + count) and
+// their normal matrices start at normalMatrices() + first * 12.
+struct InstanceBatch
+{
+    const Mesh* mesh = nullptr;
+    const Shader* shader = nullptr;
+    const Material* material = nullptr;
+    std::uint32_t first = 0;
+    std::uint32_t count = 0;
+};
+
+// Per-frame grouping of visible objects into instanced draws: add() every visible object, build(), then
+// submit() issues one Mesh::drawInstanced() per unique (mesh, shader, material) instead of one draw and
+// one model-matrix uniform per object. Shaders must follow the instance attribute convention of
+// Mesh::kInstanceAttributeLocation. Storage is kept across frames, so a steady frame does not allocate.
+class InstanceBatcher
+{
+public:
+    // Starts a new frame.
+    void clear();
+
+    // World matrices must be affine; their last row is dropped. Any scale is allowed, as each instance also
+    // gets its own normal matrix. shader and material may be nullptr when the caller binds its own.
+    void add(const Mesh& mesh, const Shader* shader, const Material* material, const Matrix4& world);
+    void add(const Mesh& mesh,
+             const Shader* shader,
+             const Material* material,
+             const Matrix4* worlds,
+             std::size_t count);
+
+    // Packs the transforms and derives the normal matrices batch by batch. Batches are ordered by shader,
+    // then material, then mesh, so submit() changes state as little as possible.
+    void build();
+    const std::vector<InstanceBatch>& batches() const noexcept { return batches_; }
+    const Matrix3x4* instances() const noexcept { return instances_.data(); }
+    // 12 floats per instance, laid out as by Matrix4::normalMatrices().
+    const float* normalMatrices() const noexcept { return normalMatrices_.data(); }
+    std::size_t instanceCount() const noexcept { return instances_.size(); }
+
+    // Binds each shader and material once per run of batches using it and draws every batch. Returns the
+    // number of draw calls issued.
+    std::size_t submit() const;
+
+private:
+    struct BatchKey
+    {
+        const Mesh* mesh;
+        const Shader* shader;
+        const Material* material;
+
+        bool operator==(const BatchKey& other) const noexcept
+        {
+            return mesh == other.mesh && shader == other.shader && material == other.material;
+        }
+    };
+
+    struct BatchKeyHash
+    {
+        std::size_t operator()(const BatchKey& key) const noexcept;
+    };
+
+    std::unordered_map<BatchKey, std::uint32_t, BatchKeyHash> batchIndex_;
+    std::vector<InstanceBatch> batches_;
+    // Added objects in add() order and the batch each belongs to.
+    std::vector<Matrix4> worlds_;
+    std::vector<std::uint32_t> itemBatches_;
+    // Build scratch: batches in sorted order, the sorted position of each batch and the next free
+    // instance of each sorted batch.
+    std::vector<std::uint32_t> order_;
+    std::vector<InstanceBatch> sortedBatches_;
+    std::vector<std::uint32_t> remap_;
+    std::vector<std::uint32_t> cursors_;
+    std::vector<Matrix4> sortedWorlds_;
+    std::vector<Matrix3x4> instances_;
+    std::vector<float> normalMatrices_;
+};
+} // namespace nre
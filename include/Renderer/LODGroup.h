@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Renderer/Mesh.h"
+
+namespace nre
+{
+// Ordered detail levels of one mesh, finest first. Each level records its geometric error: the largest
+// object-space distance between its surface and the full-detail mesh, so it can be projected to pixels
+// by LODSelector.
+class LODGroup
+{
+public:
+    static constexpr std::size_t kMaxLevels = 16;
+
+    // Throws std::runtime_error for a null mesh, a negative error, an error below the previous level's,
+    // or more than kMaxLevels levels.
+    void addLevel(std::shared_ptr<Mesh> mesh, float geometricError);
+    void clear();
+
+    std::size_t levelCount() const noexcept { return meshes_.size(); }
+    const std::shared_ptr<Mesh>& mesh(std::size_t level) const { return meshes_.at(level); }
+    float geometricError(std::size_t level) const { return errors_.at(level); }
+    // levelCount() non-decreasing errors.
+    const float* geometricErrors() const noexcept { return errors_.data(); }
+
+private:
+    std::vector<std::shared_ptr<Mesh>> meshes_;
+    std::vector<float> errors_;
+};
+} // namespace nre
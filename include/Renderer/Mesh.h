@@ -3,8 +3,12 @@
 #include <cstdint>
 #include <vector>
 
+#include "Renderer/MeshBounds.h"
+
 namespace nre
 {
+struct Matrix3x4;
+
 struct Vertex
 {
     float position[3];
@@ -15,12 +19,29 @@ struct Vertex
 class Mesh
 {
 public:
+    // Per-instance transforms occupy this and the next two attribute locations, one Matrix3x4 row each
+    // with a divisor of 1, followed by the three vec4 columns of the instance's normal matrix at
+    // kInstanceNormalAttributeLocation; see assets/shaders/instanced.vert.
+    static constexpr std::uint32_t kInstanceAttributeLocation = 3;
+    static constexpr std::uint32_t kInstanceNormalAttributeLocation = kInstanceAttributeLocation + 3;
+
     virtual ~Mesh();
 
     virtual void upload(const std::vector<Vertex>& vertices,
                         const std::vector<std::uint32_t>& indices) = 0;
     virtual void draw() const = 0;
+    // Draws count instances in one call, copying their transforms into the mesh's instance buffers first.
+    // normalMatrices holds 12 floats per instance in the layout of Matrix4::normalMatrices(). The bound
+    // shader must read the instance attributes instead of model and normal matrix uniforms.
+    virtual void drawInstanced(const Matrix3x4* instances, const float* normalMatrices, std::size_t count) const = 0;
     virtual std::size_t indexCount() const noexcept = 0;
     virtual std::size_t vertexCount() const noexcept = 0;
+
+    // Object-space bounds of the uploaded vertices, as set by whoever uploaded them (MeshCache does).
+    const MeshBounds& bounds() const noexcept { return bounds_; }
+    void setBounds(const MeshBounds& bounds) noexcept { bounds_ = bounds; }
+
+private:
+    MeshBounds bounds_;
 };
 } // namespace nre
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Math/Bounds.h"
+
+namespace nre
+{
+struct Vertex;
+
+// Object-space bounds of a mesh's vertex positions; all zero for an empty mesh.
+struct MeshBounds
+{
+    BoundingBox box;
+    BoundingSphere sphere;
+};
+
+// The box comes from a SIMD min/max reduction over the positions. The sphere is the smaller of two
+// candidates, both shrunk to the farthest vertex: the box's circumsphere center and a Ritter sphere grown
+// from the most distant pair of axis-extreme vertices.
+MeshBounds computeMeshBounds(const Vertex* vertices, std::size_t count);
+} // namespace nre
@@ -4,7 +4,9 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "Renderer/LODGroup.h"
 #include "Renderer/Mesh.h"
 #include "Renderer/MeshFactory.h"
 
@@ -12,6 +14,12 @@ namespace nre
 {
 class RenderAPI;
 
+struct LODSource
+{
+    std::function<MeshData()> generator;
+    float geometricError = 0.0F;
+};
+
 class MeshCache
 {
 public:
@@ -19,9 +27,18 @@ public:
 
     std::shared_ptr<Mesh> loadFromFile(const std::string& path);
 
+    // Uses the bounds the generator filled in, and computes them when it left them at zero.
     std::shared_ptr<Mesh> loadFromGenerator(const std::string& key,
                                             const std::function<MeshData()>& generator);
 
+    // Uploads data decoded earlier, e.g. by loadMeshFromFile() on a loader thread, and caches it under
+    // key unless that key is already loaded. The bounds in data are used as they are.
+    std::shared_ptr<Mesh> loadFromData(const std::string& key, const MeshData& data);
+
+    // Level i is cached under "<key>#lod<i>", so groups sharing a key share their meshes. Sources go
+    // from finest to coarsest.
+    LODGroup loadLODGroup(const std::string& key, const std::vector<LODSource>& levels);
+
     void clear();
 
 private:
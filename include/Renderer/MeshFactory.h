@@ -1,9 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "Renderer/Mesh.h"
+#include "Renderer/MeshBounds.h"
 
 namespace nre
 {
@@ -11,6 +13,8 @@ struct MeshData
 {
     std::vector<Vertex> vertices;
     std::vector<std::uint32_t> indices;
+    // Filled in by the functions below; recompute with computeMeshBounds() after editing vertices.
+    MeshBounds bounds;
 };
 
 MeshData makeTriangle();
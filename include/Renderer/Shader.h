@@ -32,6 +32,8 @@ public:
     virtual void bind() const = 0;
     virtual void unbind() const = 0;
     virtual void setMatrix4(std::string_view name, const float* data) = 0;
+    // Three column-major vec4 columns, as produced by Matrix4::normalMatrices.
+    virtual void setMatrix3x4(std::string_view name, const float* data) = 0;
     virtual void setInt(std::string_view name, int value) = 0;
     virtual void bindUniformBlock(std::string_view name, unsigned int binding) = 0;
 };
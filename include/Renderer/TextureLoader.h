@@ -1,20 +1,36 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace nre
 {
 class Texture;
 class RenderAPI;
 
+// Decoded RGBA8 pixels, bottom row first.
+struct TextureImage
+{
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::vector<unsigned char> rgba;
+};
+
 class TextureLoader
 {
 public:
     explicit TextureLoader(RenderAPI& api);
 
+    // Reads and decodes an image without touching the RenderAPI, so it may run on any thread. Unreadable
+    // files decode to a magenta/black checkerboard.
+    static TextureImage decode(const std::string& path);
+
     std::shared_ptr<Texture> load(const std::string& path);
+    // Uploads an image decoded earlier and caches it under path, unless that path is already loaded.
+    std::shared_ptr<Texture> load(const std::string& path, const TextureImage& image);
     void clear();
 
 private:
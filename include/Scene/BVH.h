@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+#include "Math/Ray.h"
+#include "Math/Vector3.h"
+#include "Renderer/MeshFactory.h"
+#include "Scene/Frustum.h"
+
+namespace nre
+{
+class JobSystem;
+
+// 32 bytes, two nodes per cache line.
+struct BVHNode
+{
+    Vector3 min;
+    // Leaves: first primitive slot. Inner nodes: index of the first child; the second follows it.
+    std::uint32_t offset = 0;
+    Vector3 max;
+    // Number of primitives; zero for inner nodes.
+    std::uint32_t count = 0;
+
+    bool isLeaf() const noexcept { return count != 0; }
+    BoundingBox bounds() const noexcept { return {min, max}; }
+};
+
+static_assert(sizeof(BVHNode) == 32, "BVHNode should stay two per cache line");
+
+struct BVHHit
+{
+    // Object index or triangle index, as passed to build().
+    std::uint32_t primitive = 0;
+    float t = 0.0F;
+    // Barycentrics for triangle BVHs; zero for object BVHs.
+    float u = 0.0F;
+    float v = 0.0F;
+};
+
+// Bounding volume hierarchy built with a binned surface-area heuristic. Primitives are either
+// caller-supplied object bounds (rays then hit the bounds themselves, which suits picking) or the
+// triangles of a MeshData. The top of the tree is split on the calling thread, binning large nodes
+// across the JobSystem's workers, and the remaining subtrees are built as independent tasks. Only the node
+// order depends on the number of workers, not the shape of the tree.
+class BVH
+{
+public:
+    static constexpr std::size_t kMaxLeafSize = 8;
+
+    void build(const BoundingBox* bounds, std::size_t count, JobSystem* jobs = nullptr);
+    // Uses indices when present, otherwise every three vertices form a triangle. Throws
+    // std::runtime_error for out-of-range indices.
+    void build(const MeshData& mesh, JobSystem* jobs = nullptr);
+    void clear();
+
+    std::size_t primitiveCount() const noexcept { return primitiveIndices_.size(); }
+    const std::vector<BVHNode>& nodes() const noexcept { return nodes_; }
+    // Primitive indices in leaf order; a leaf covers [offset, offset + count).
+    const std::vector<std::uint32_t>& primitiveIndices() const noexcept { return primitiveIndices_; }
+
+    // Closest primitive with t in (0, tMax].
+    bool intersect(const Ray& ray, float tMax, BVHHit& hit) const;
+    // True as soon as any primitive is hit within (0, tMax].
+    bool occluded(const Ray& ray, float tMax) const;
+    // Same contract as the octree queries: returns the total number of primitives whose bounds touch the
+    // frustum, writes at most capacity of them and never allocates.
+    std::size_t queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const;
+
+private:
+    // Build scratch: the primitive's bounds travel with its index so splits stream through memory.
+    struct PrimitiveRef
+    {
+        Vector3 min;
+        std::uint32_t index;
+        Vector3 max;
+        std::uint32_t padding;
+    };
+
+    struct BuildTask
+    {
+        std::uint32_t node;
+        std::uint32_t begin;
+        std::uint32_t end;
+        std::uint32_t depth;
+    };
+
+    void buildPrimitives(JobSystem* jobs);
+    void buildParallel(const BuildTask& root, JobSystem& jobs);
+    void buildSubtree(std::vector<BVHNode>& nodes,
+                      const BuildTask& root,
+                      std::size_t taskSize,
+                      std::vector<BuildTask>* deferred,
+                      JobSystem* jobs);
+    bool intersectPrimitive(const Ray& ray, std::uint32_t slot, float tMax, RayHit& hit) const noexcept;
+
+    std::vector<BVHNode> nodes_;
+    std::vector<std::uint32_t> primitiveIndices_;
+    // Triangle BVHs only: three corners per primitive slot, in leaf order.
+    std::vector<Vector3> triangleVertices_;
+    // Indexed by primitive.
+    std::vector<BoundingBox> primitiveBounds_;
+    std::vector<PrimitiveRef> refs_;
+};
+} // namespace nre
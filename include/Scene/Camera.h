@@ -2,6 +2,7 @@
 
 #include "Math/Matrix4.h"
 #include "Math/Vector3.h"
+#include "Scene/Frustum.h"
 
 namespace nre
 {
@@ -17,6 +18,7 @@ public:
     const Matrix4& view() const noexcept { return view_; }
     const Matrix4& projection() const noexcept { return projection_; }
     Matrix4 viewProjection() const noexcept { return projection_ * view_; }
+    Frustum frustum() const { return Frustum(viewProjection()); }
 
 private:
     Matrix4 view_;
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+#include "Math/Ray.h"
+#include "Scene/Frustum.h"
+
+namespace nre
+{
+// Incrementally maintained AABB tree for moving objects. Each leaf stores a fat box, the object's bounds
+// grown by a margin, so small motions only touch the object itself. Objects that leave their fat box
+// are queued and refit() repairs their ancestors bottom-up in one pass; every node on an insertion,
+// removal or refit path is then offered a tree rotation (swapping a child with a grandchild) when that
+// shrinks its surface area, so the tree stays close to a fresh build while objects drift. Rotations also
+// keep the heights of siblings within a few levels, which bounds the depth of any traversal.
+//
+// Ids index an internal table and should be dense, as for Octree. Queries test the exact object bounds.
+class DynamicBVH
+{
+public:
+    explicit DynamicBVH(float margin = 0.1F);
+
+    // Inserting an id that is already present moves it.
+    void insert(std::uint32_t id, const BoundingBox& bounds);
+    // Unknown ids are ignored.
+    void remove(std::uint32_t id);
+    // O(1) while the bounds stay inside the fat box. Otherwise the fat box is regrown and the leaf waits
+    // for refit(); objects that jumped clear of their old fat box are reinserted right away instead.
+    // Returns true when the tree needs a refit().
+    bool update(std::uint32_t id, const BoundingBox& bounds);
+    // Refits and rotates the ancestors of every leaf moved since the last call. Queries only see those
+    // moves once this has run.
+    void refit();
+    void clear();
+
+    bool contains(std::uint32_t id) const noexcept;
+    std::size_t size() const noexcept { return objectCount_; }
+    std::size_t nodeCount() const noexcept { return nodes_.size() - freeCount_; }
+    // Leaves have height zero; zero for an empty tree.
+    std::size_t height() const noexcept;
+    float margin() const noexcept { return margin_; }
+    // Union of all fat boxes; empty when size() == 0.
+    BoundingBox bounds() const noexcept;
+
+    // Traversal prunes by the fat boxes, but a leaf only matches when its exact bounds pass the test.
+    std::size_t queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const;
+    std::size_t queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const;
+    std::size_t querySphere(const BoundingSphere& sphere, std::uint32_t* out, std::size_t capacity) const;
+    // Objects whose bounds the ray enters within (0, tMax].
+    std::size_t queryRay(const Ray& ray, float tMax, std::uint32_t* out, std::size_t capacity) const;
+
+private:
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFU;
+
+    struct Node
+    {
+        BoundingBox bounds;
+        std::uint32_t parent = kInvalidIndex;
+        // kInvalidIndex for leaves.
+        std::uint32_t left = kInvalidIndex;
+        std::uint32_t right = kInvalidIndex;
+        // Leaves: object id. Free nodes: next free node.
+        std::uint32_t id = kInvalidIndex;
+        std::uint32_t height = 0;
+        // Last refit() that queued this node.
+        std::uint32_t refitPass = 0;
+
+        bool isLeaf() const noexcept { return left == kInvalidIndex; }
+    };
+
+    struct Object
+    {
+        BoundingBox bounds;
+        std::uint32_t leaf = kInvalidIndex;
+        bool moved = false;
+    };
+
+    enum class Overlap
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    std::uint32_t allocateNode();
+    void freeNode(std::uint32_t node);
+    BoundingBox fatten(const BoundingBox& bounds) const noexcept;
+    void insertLeaf(std::uint32_t leaf);
+    void removeLeaf(std::uint32_t leaf);
+    std::uint32_t findSibling(const BoundingBox& bounds) const noexcept;
+    void refitUpwards(std::uint32_t node);
+    void refitNode(std::uint32_t node);
+    void rotate(std::uint32_t node);
+    void swapChild(std::uint32_t parent, std::uint32_t oldChild, std::uint32_t newChild);
+
+    template <typename NodeTest, typename ObjectTest>
+    std::size_t query(const NodeTest& nodeTest,
+                      const ObjectTest& objectTest,
+                      std::uint32_t* out,
+                      std::size_t capacity) const;
+
+    float margin_;
+    std::vector<Node> nodes_;
+    std::uint32_t root_ = kInvalidIndex;
+    std::uint32_t freeList_ = kInvalidIndex;
+    std::size_t freeCount_ = 0;
+    std::vector<Object> objects_;
+    std::size_t objectCount_ = 0;
+    // Ids waiting for refit(), and its scratch list of (height << 32 | node) keys.
+    std::vector<std::uint32_t> moved_;
+    std::vector<std::uint64_t> refitKeys_;
+    std::uint32_t refitPass_ = 0;
+};
+} // namespace nre
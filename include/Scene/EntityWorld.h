@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace nre
+{
+class JobSystem;
+
+// Stable reference to an entity; stays invalid once the entity is destroyed.
+struct Entity
+{
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    constexpr bool operator==(const Entity& other) const noexcept
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    constexpr bool operator!=(const Entity& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    constexpr explicit operator bool() const noexcept { return generation != 0; }
+};
+
+// Bit i is set when a component with ComponentRegistry id i is present.
+using ComponentMask = std::uint64_t;
+
+// Process-wide component ids, assigned on first use. Components are plain data that is moved between
+// chunks with memcpy, hence the trivially copyable requirement.
+class ComponentRegistry
+{
+public:
+    static constexpr std::size_t kMaxComponentTypes = 64;
+
+    // Throws std::runtime_error once more than kMaxComponentTypes types are in use.
+    template <typename T>
+    static std::uint32_t id()
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "Components must be trivially copyable and destructible");
+        static const std::uint32_t value = registerType(sizeof(T), alignof(T));
+        return value;
+    }
+
+    template <typename... Ts>
+    static ComponentMask mask()
+    {
+        return (ComponentMask{0} | ... | (ComponentMask{1} << id<Ts>()));
+    }
+
+    static std::size_t size(std::uint32_t id) noexcept;
+    static std::size_t alignment(std::uint32_t id) noexcept;
+
+private:
+    static std::uint32_t registerType(std::size_t size, std::size_t alignment);
+};
+
+// One chunk's entities and component columns, valid until the next structural change.
+class ChunkView
+{
+public:
+    std::size_t size() const noexcept { return count_; }
+    const Entity* entities() const noexcept { return reinterpret_cast<const Entity*>(data_); }
+
+    // nullptr when the chunk's archetype lacks T.
+    template <typename T>
+    T* column() const
+    {
+        const std::uint32_t offset = offsets_[ComponentRegistry::id<T>()];
+        return offset != 0 ? reinterpret_cast<T*>(data_ + offset) : nullptr;
+    }
+
+private:
+    friend class EntityWorld;
+
+    std::byte* data_ = nullptr;
+    std::size_t count_ = 0;
+    // Column offset per component id; zero (the entity column) for absent components.
+    const std::uint32_t* offsets_ = nullptr;
+};
+
+// Archetype-based entity-component store. Entities with the same component set share an archetype,
+// which keeps them in 16 KB chunks holding one contiguous column per component plus the entity handles,
+// so a system touching a few components streams through exactly those columns. Chunks stay densely
+// packed: destroying or moving an entity fills its row with the archetype's last entity.
+//
+// Structural changes (create, destroy, add, remove) move entities between chunks and invalidate
+// ChunkViews and component pointers, so they must not happen while iterating; record them in an
+// EntityCommandBuffer and play it back afterwards. Functions taking an Entity throw std::runtime_error
+// for handles that are not valid(), except destroy(), has() and get().
+class EntityWorld
+{
+public:
+    static constexpr std::size_t kChunkSize = 16 * 1024;
+
+    EntityWorld();
+    ~EntityWorld();
+
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    Entity create();
+    template <typename... Ts>
+    Entity create(const Ts&... components)
+    {
+        const Entity entity = createWithMask(ComponentRegistry::mask<Ts...>());
+        (std::memcpy(componentData(entity, ComponentRegistry::id<Ts>()), &components, sizeof(Ts)), ...);
+        return entity;
+    }
+    // Invalid handles are ignored.
+    void destroy(Entity entity);
+    void clear();
+
+    bool valid(Entity entity) const noexcept;
+    std::size_t size() const noexcept { return liveCount_; }
+    std::size_t archetypeCount() const noexcept { return archetypes_.size(); }
+
+    // Adding a component the entity already has overwrites it.
+    template <typename T>
+    void add(Entity entity, const T& component)
+    {
+        std::memcpy(addComponent(entity, ComponentRegistry::id<T>()), &component, sizeof(T));
+    }
+    // Removing a missing component does nothing.
+    template <typename T>
+    void remove(Entity entity)
+    {
+        removeComponent(entity, ComponentRegistry::id<T>());
+    }
+    template <typename T>
+    bool has(Entity entity) const
+    {
+        return findComponent(entity, ComponentRegistry::id<T>()) != nullptr;
+    }
+    // nullptr when the entity is invalid or lacks T.
+    template <typename T>
+    T* get(Entity entity)
+    {
+        return static_cast<T*>(findComponent(entity, ComponentRegistry::id<T>()));
+    }
+    template <typename T>
+    const T* get(Entity entity) const
+    {
+        return static_cast<const T*>(findComponent(entity, ComponentRegistry::id<T>()));
+    }
+
+    // Calls fn(const ChunkView&) for every non-empty chunk whose archetype has all of Ts.
+    template <typename... Ts, typename Fn>
+    void forEachChunk(Fn&& fn)
+    {
+        const ComponentMask required = ComponentRegistry::mask<Ts...>();
+        for (const auto& archetype : archetypes_)
+        {
+            if ((archetype->mask & required) != required)
+            {
+                continue;
+            }
+            for (std::size_t chunk = 0; chunk * archetype->capacity < archetype->size; ++chunk)
+            {
+                fn(chunkView(*archetype, chunk));
+            }
+        }
+    }
+
+    // Calls fn(Entity, Ts&...) for every entity that has all of Ts, chunk by chunk.
+    template <typename... Ts, typename Fn>
+    void forEach(Fn&& fn)
+    {
+        forEachChunk<Ts...>([&fn](const ChunkView& chunk)
+                            { forEachRow(fn, chunk.entities(), chunk.size(), chunk.template column<Ts>()...); });
+    }
+
+    // forEachChunk() with the chunks spread across the JobSystem's workers; fn runs concurrently on
+    // different chunks and must not make structural changes or call back into this function.
+    template <typename... Ts>
+    void parallelForEachChunk(JobSystem* jobs, const std::function<void(const ChunkView&)>& fn)
+    {
+        gatherChunks(ComponentRegistry::mask<Ts...>());
+        runChunks(jobs, fn);
+    }
+
+private:
+    friend class EntityCommandBuffer;
+
+    struct alignas(64) ChunkStorage
+    {
+        std::byte bytes[kChunkSize];
+    };
+
+    struct Archetype
+    {
+        ComponentMask mask = 0;
+        std::vector<std::uint32_t> components;
+        std::uint32_t offsets[ComponentRegistry::kMaxComponentTypes] = {};
+        // Entities per chunk.
+        std::size_t capacity = 0;
+        // Entity rows; row r lives in chunk r / capacity. Chunks past the last used one are kept for reuse.
+        std::size_t size = 0;
+        std::vector<std::unique_ptr<ChunkStorage>> chunks;
+    };
+
+    struct EntityRecord
+    {
+        std::uint32_t archetype = 0;
+        std::uint32_t row = 0;
+        std::uint32_t generation = 1;
+        bool alive = false;
+    };
+
+    template <typename Fn, typename... Ts>
+    static void forEachRow(Fn& fn, const Entity* entities, std::size_t count, Ts*... columns)
+    {
+        for (std::size_t row = 0; row < count; ++row)
+        {
+            fn(entities[row], columns[row]...);
+        }
+    }
+
+    static ChunkView chunkView(const Archetype& archetype, std::size_t chunk) noexcept;
+
+    Entity createWithMask(ComponentMask mask);
+    void* addComponent(Entity entity, std::uint32_t component);
+    void removeComponent(Entity entity, std::uint32_t component);
+    void* componentData(Entity entity, std::uint32_t component);
+    void* findComponent(Entity entity, std::uint32_t component) const noexcept;
+
+    std::uint32_t checkedIndex(Entity entity) const;
+    std::uint32_t archetypeFor(ComponentMask mask);
+    std::uint32_t allocateRow(Archetype& archetype);
+    void eraseRow(std::uint32_t archetype, std::uint32_t row);
+    void moveEntity(std::uint32_t index, std::uint32_t archetype);
+    void gatherChunks(ComponentMask required);
+    void runChunks(JobSystem* jobs, const std::function<void(const ChunkView&)>& fn);
+
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::unordered_map<ComponentMask, std::uint32_t> archetypeIndex_;
+    std::vector<EntityRecord> records_;
+    std::vector<std::uint32_t> freeIndices_;
+    std::size_t liveCount_ = 0;
+    // Scratch for parallelForEachChunk().
+    std::vector<ChunkView> queryChunks_;
+};
+
+// Structural changes recorded during iteration and applied later in recording order. Buffers are
+// independent, so parallel tasks can each record into their own and play them back in a fixed order.
+class EntityCommandBuffer
+{
+public:
+    template <typename... Ts>
+    void create(const Ts&... components)
+    {
+        commands_.push_back({CommandType::Create, {}, ComponentRegistry::mask<Ts...>(), 0, data_.size()});
+        (appendComponent(ComponentRegistry::id<Ts>(), &components, sizeof(Ts)), ...);
+        commands_.back().component = static_cast<std::uint32_t>(sizeof...(Ts));
+    }
+    void destroy(Entity entity);
+    template <typename T>
+    void add(Entity entity, const T& component)
+    {
+        commands_.push_back({CommandType::Add, entity, 0, ComponentRegistry::id<T>(), data_.size()});
+        appendData(&component, sizeof(T));
+    }
+    template <typename T>
+    void remove(Entity entity)
+    {
+        commands_.push_back({CommandType::Remove, entity, 0, ComponentRegistry::id<T>(), 0});
+    }
+
+    // Applies and clears the commands. Commands on entities that are no longer valid are dropped.
+    void playback(EntityWorld& world);
+    void clear() noexcept;
+    bool empty() const noexcept { return commands_.empty(); }
+
+private:
+    enum class CommandType : std::uint8_t
+    {
+        Create,
+        Destroy,
+        Add,
+        Remove
+    };
+
+    struct Command
+    {
+        CommandType type;
+        Entity entity;
+        ComponentMask mask;
+        // Add and Remove: component id. Create: number of (id, bytes) records at dataOffset.
+        std::uint32_t component;
+        std::size_t dataOffset;
+    };
+
+    void appendData(const void* data, std::size_t size);
+    void appendComponent(std::uint32_t component, const void* data, std::size_t size);
+
+    std::vector<Command> commands_;
+    std::vector<std::byte> data_;
+};
+} // namespace nre
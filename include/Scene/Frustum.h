@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Math/Bounds.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+namespace nre
+{
+// Points with dot(normal, p) + distance >= 0 lie on the inner side.
+struct Plane
+{
+    Vector3 normal;
+    float distance = 0.0F;
+};
+
+class Frustum
+{
+public:
+    enum PlaneIndex : std::size_t
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    Frustum() = default;
+    // Gribb-Hartmann extraction from an OpenGL-style (clip z in [-w, w]) view-projection matrix.
+    explicit Frustum(const Matrix4& viewProjection);
+
+    const std::array<Plane, PlaneCount>& planes() const noexcept { return planes_; }
+
+    bool intersects(const BoundingSphere& sphere) const noexcept;
+    bool intersects(const BoundingBox& box) const noexcept;
+    // True when the whole box is on the inner side of every plane.
+    bool contains(const BoundingBox& box) const noexcept;
+
+    static constexpr std::uint32_t kAllPlanes = (1U << PlaneCount) - 1U;
+    // For hierarchical culling: tests the box against the planes whose bits are set in planeMask only, and
+    // clears the bits of the planes the box lies fully inside, so everything contained in the box can
+    // skip them. Returns false when the box is outside one of the tested planes; planeMask == 0 afterwards
+    // means the box is inside the whole frustum.
+    bool intersects(const BoundingBox& box, std::uint32_t& planeMask) const noexcept;
+
+    // Writes the indices of potentially visible objects to visibleIndices (capacity >= count) in
+    // ascending order and returns how many were written.
+    std::size_t cullSpheres(const BoundingSphereStreams& spheres,
+                            std::size_t count,
+                            std::uint32_t* visibleIndices) const;
+    std::size_t cullBoxes(const BoundingBoxStreams& boxes, std::size_t count, std::uint32_t* visibleIndices) const;
+
+private:
+    std::array<Plane, PlaneCount> planes_{};
+};
+} // namespace nre
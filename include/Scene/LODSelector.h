@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Math/Bounds.h"
+#include "Math/Vector3.h"
+
+namespace nre
+{
+class Camera;
+class LODGroup;
+
+// Picks mesh detail levels from projected screen-space error. A level's geometric error e seen from
+// distance d covers e * pixelScale / d pixels, where pixelScale is the projection's focal length in
+// pixels; the coarsest level that stays under the threshold wins. Hysteresis keeps an object on its
+// current level until the projected error crosses a level boundary by the given fraction, so objects
+// hovering at a boundary do not pop back and forth every frame.
+//
+// Selection runs over structure-of-arrays bounding spheres in SIMD lanes, one batch per LOD group.
+class LODSelector
+{
+public:
+    // Takes the eye position and vertical focal length from the camera; viewportHeight is in pixels.
+    void setCamera(const Camera& camera, float viewportHeight);
+    // Largest projected error, in pixels, a selected level may show. Defaults to one pixel.
+    void setErrorThreshold(float pixels);
+    // Global detail knob in powers of two: +1 tolerates twice the error everywhere (coarser), -1 half.
+    void setBias(float bias);
+    // Fraction past a level boundary before switching, e.g. 0.2 for 20%. Defaults to 0.15.
+    void setHysteresis(float fraction);
+
+    float errorThreshold() const noexcept { return threshold_; }
+    float bias() const noexcept { return bias_; }
+    float hysteresis() const noexcept { return hysteresis_; }
+
+    // Largest object-space error tolerated at each sphere: zero when the eye is inside it.
+    void computeErrorBudgets(const BoundingSphereStreams& spheres, std::size_t count, float* budgets) const;
+    // Updates levels[i] (the level shown last frame, zero initially) for objects drawn with group. Levels
+    // past the group's last level are clamped to it.
+    void select(const BoundingSphereStreams& spheres,
+                std::size_t count,
+                const LODGroup& group,
+                std::uint8_t* levels) const;
+    // Same for a raw list of levelCount non-decreasing errors, finest first.
+    void select(const BoundingSphereStreams& spheres,
+                std::size_t count,
+                const float* levelErrors,
+                std::size_t levelCount,
+                std::uint8_t* levels) const;
+
+private:
+    void updateBudgetScale() noexcept;
+
+    Vector3 eye_;
+    float pixelScale_ = 1.0F;
+    float threshold_ = 1.0F;
+    float bias_ = 0.0F;
+    float hysteresis_ = 0.15F;
+    // threshold * 2^bias / pixelScale: distance to tolerated error.
+    float budgetScale_ = 1.0F;
+};
+} // namespace nre
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+#include "Scene/Frustum.h"
+
+namespace nre
+{
+class JobSystem;
+
+// Build-once octree for static geometry. Objects are sorted by the 30-bit Morton code of their center,
+// so every node covers a contiguous range of that order and the sorted ids form the only object pool.
+// Nodes are keyed by locational code (a leading 1 bit followed by three bits per level) and stored in
+// key order, which keeps the non-empty children of a node adjacent; their bounds, the union of the
+// objects below them, live in SoA streams so all children are tested against a frustum at once.
+//
+// Rebuilding replaces the whole tree. Use Octree for objects that move.
+class LinearOctree
+{
+public:
+    // Ten levels of three bits fill the 30-bit codes.
+    static constexpr std::size_t kMaxDepth = 10;
+
+    // Object ids are indices into boxes. Nodes stop splitting at maxDepth (clamped to kMaxDepth) or
+    // when they hold at most leafCapacity objects. With a JobSystem the sort and the bounds are spread
+    // across its workers.
+    void build(const BoundingBox* boxes,
+               std::size_t count,
+               std::size_t maxDepth = kMaxDepth,
+               std::size_t leafCapacity = 16,
+               JobSystem* jobs = nullptr);
+    void clear();
+
+    std::size_t size() const noexcept { return ids_.size(); }
+    std::size_t nodeCount() const noexcept { return nodes_.size(); }
+    // Union of all object bounds; empty when size() == 0.
+    BoundingBox bounds() const noexcept;
+
+    // Nodes that lie entirely inside the query emit their whole id range without testing its objects.
+    std::size_t queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const;
+    std::size_t queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const;
+
+private:
+    struct Node
+    {
+        std::uint32_t key = 1;
+        std::uint32_t firstChild = 0;
+        // Zero for leaves.
+        std::uint32_t childCount = 0;
+        // Range of ids_ covered by the subtree.
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+
+    struct BoxStreams
+    {
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> minZ;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+        std::vector<float> maxZ;
+
+        void resize(std::size_t count);
+        BoundingBoxStreams view(std::size_t offset) const noexcept;
+        BoundingBox box(std::size_t index) const noexcept;
+    };
+
+    void sortByMortonCode(const BoundingBox* boxes, std::size_t count, JobSystem* jobs);
+    void buildNodes(std::size_t maxDepth, std::size_t leafCapacity);
+    void computeNodeBounds(JobSystem* jobs);
+    std::size_t emitRange(std::uint32_t begin,
+                          std::uint32_t end,
+                          std::uint32_t* out,
+                          std::size_t found,
+                          std::size_t capacity) const noexcept;
+
+    std::vector<Node> nodes_;
+    // Padded so eight lanes can be loaded from any node index.
+    BoxStreams nodeBounds_;
+    // Object bounds in Morton order.
+    BoxStreams objectBounds_;
+    std::vector<std::uint32_t> ids_;
+    // (code << 32 | id) pairs and their radix sort scratch, kept to avoid reallocating on rebuild.
+    std::vector<std::uint64_t> keys_;
+    std::vector<std::uint64_t> sortScratch_;
+};
+} // namespace nre
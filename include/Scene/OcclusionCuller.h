@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+#include "Math/Matrix4.h"
+#include "Renderer/MeshFactory.h"
+
+namespace nre
+{
+class JobSystem;
+
+// CPU occlusion culling against a low-resolution masked depth buffer, so hidden objects are dropped
+// before draw submission on every backend and without GPU readback.
+//
+// The buffer is split into 8x4 pixel tiles. Each tile keeps a 32-bit coverage mask and two depths: the
+// farthest occluder depth over the whole tile and the farthest depth of the partially covered working
+// layer, which is merged into the first once its mask fills up. Occluder triangles are set up once and
+// then rasterized per band of tile rows, with every tile's coverage computed in SIMD lanes; bands are
+// independent and run in parallel on a JobSystem.
+//
+// Per frame: beginFrame(), addOccluder() for the large nearby meshes, rasterize(), then test occludees.
+// Depths are window depths in [0, 1] for an OpenGL-style projection.
+class OcclusionCuller
+{
+public:
+    static constexpr std::size_t kTileWidth = 8;
+    static constexpr std::size_t kTileHeight = 4;
+
+    // The resolution is rounded up to whole tiles.
+    explicit OcclusionCuller(std::size_t width = 320, std::size_t height = 192);
+
+    void resize(std::size_t width, std::size_t height);
+    std::size_t width() const noexcept { return width_; }
+    std::size_t height() const noexcept { return height_; }
+
+    // Clears the depth buffer and the queued occluders.
+    void beginFrame(const Matrix4& viewProjection);
+    // Counter-clockwise faces are front faces; back faces are skipped unless twoSided. The mesh is
+    // referenced, not copied, and must stay alive until rasterize() returns.
+    void addOccluder(const MeshData& mesh, const Matrix4& model, bool twoSided = false);
+    void rasterize(JobSystem* jobs = nullptr);
+    // Occluder triangles that reached the screen in the last rasterize().
+    std::size_t triangleCount() const noexcept;
+
+    // False only when the world-space box is hidden behind the rasterized occluders or off screen.
+    bool isVisible(const BoundingBox& box) const noexcept;
+    // Writes the indices of the visible boxes to visibleIndices (capacity >= count) in ascending order and
+    // returns how many were written, like Frustum::cullBoxes.
+    std::size_t cullBoxes(const BoundingBox* boxes, std::size_t count, std::uint32_t* visibleIndices) const;
+    // Keeps the ids whose boxes[id] is visible, in order; out may alias ids, so a frustum query result can
+    // be filtered in place. Returns how many were kept.
+    std::size_t filterVisible(const BoundingBox* boxes,
+                              const std::uint32_t* ids,
+                              std::size_t count,
+                              std::uint32_t* out) const;
+
+private:
+    struct Tile
+    {
+        // Every pixel of the tile has an occluder at or nearer than z0.
+        float z0 = 1.0F;
+        // Pixels in mask have an occluder at or nearer than z1.
+        float z1 = 0.0F;
+        std::uint32_t mask = 0;
+    };
+
+    // Edge functions a * x + b * y + c are non-negative inside; depth is interpolated the same way.
+    struct ScreenTriangle
+    {
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float depthA;
+        float depthB;
+        float depthC;
+        float maxDepth;
+        std::int32_t minX;
+        std::int32_t minY;
+        std::int32_t maxX;
+        std::int32_t maxY;
+    };
+
+    struct ClipVertex
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+    };
+
+    // Pixel coordinates with y pointing down, and window depth.
+    struct ScreenVertex
+    {
+        float x;
+        float y;
+        float z;
+    };
+
+    struct Occluder
+    {
+        const MeshData* mesh;
+        Matrix4 model;
+        bool twoSided;
+    };
+
+    void setupOccluder(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const;
+    void setupTriangle(const ClipVertex* vertices, bool twoSided, std::vector<ScreenTriangle>& triangles) const;
+    void emitTriangle(ScreenVertex a,
+                      ScreenVertex b,
+                      ScreenVertex c,
+                      bool twoSided,
+                      std::vector<ScreenTriangle>& triangles) const;
+    void rasterizeBand(std::size_t firstTileRow, std::size_t endTileRow);
+
+    std::size_t width_ = 0;
+    std::size_t height_ = 0;
+    std::size_t tilesX_ = 0;
+    std::size_t tilesY_ = 0;
+    std::vector<Tile> tiles_;
+    Matrix4 viewProjection_;
+    std::vector<Occluder> occluders_;
+    // Per occluder, kept to avoid reallocating every frame.
+    std::vector<std::vector<ScreenTriangle>> triangles_;
+};
+} // namespace nre
@@ -1,48 +1,109 @@
 #pragma once
 
-#include <array>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include "Math/Bounds.h"
+#include "Math/Ray.h"
 #include "Math/Vector3.h"
+#include "Scene/Frustum.h"
 
 namespace nre
 {
-struct BoundingBox
-{
-    Vector3 min;
-    Vector3 max;
-};
-
-class OctreeNode
+// Loose octree over caller-assigned object ids. Each node's cell is an octant of its parent's, and
+// objects are stored in the deepest node whose cell contains their center while their half extent fits
+// in half the cell, so node bounds are looseness-2 (twice the cell) and objects never straddle siblings.
+// Leaves split once they hold more than nodeCapacity objects and merge back below half that.
+//
+// Ids index an internal table and should be dense (entity or draw indices). Objects whose center lies
+// outside the root cell are kept in the root, which every query visits.
+class Octree
 {
 public:
-    explicit OctreeNode(const BoundingBox& bounds);
+    static constexpr std::size_t kMaxDepth = 16;
 
-    bool isLeaf() const noexcept;
-    void subdivide();
+    // maxDepth is clamped to kMaxDepth.
+    Octree(const BoundingBox& bounds, std::size_t maxDepth, std::size_t nodeCapacity = 8);
 
+    // Inserting an id that is already present moves it.
+    void insert(std::uint32_t id, const BoundingBox& bounds);
+    // Unknown ids are ignored.
+    void remove(std::uint32_t id);
+    // Stays in place in O(1) while the object still belongs to its node; otherwise removes and reinserts.
+    void update(std::uint32_t id, const BoundingBox& bounds);
+    void clear();
+
+    bool contains(std::uint32_t id) const noexcept;
+    std::size_t size() const noexcept { return objectCount_; }
+    std::size_t nodeCount() const noexcept { return nodes_.size() - freeBlocks_.size() * 8; }
     const BoundingBox& bounds() const noexcept { return bounds_; }
-    std::vector<int>& objects() noexcept { return objects_; }
-    const std::vector<int>& objects() const noexcept { return objects_; }
-    std::array<std::unique_ptr<OctreeNode>, 8>& children() noexcept { return children_; }
+    std::size_t maxDepth() const noexcept { return maxDepth_; }
+
+    // Queries write the ids of objects whose bounds overlap the query to out, in no particular order.
+    // They return the total number of matches and never allocate; when that exceeds capacity only the
+    // first capacity ids were written. LinearOctree, DynamicBVH and SpatialHashGrid queries follow the
+    // same contract.
+    std::size_t queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const;
+    std::size_t queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const;
+    std::size_t querySphere(const BoundingSphere& sphere, std::uint32_t* out, std::size_t capacity) const;
+    // Objects whose bounds the ray enters within (0, tMax].
+    std::size_t queryRay(const Ray& ray, float tMax, std::uint32_t* out, std::size_t capacity) const;
 
 private:
-    BoundingBox bounds_;
-    std::vector<int> objects_;
-    std::array<std::unique_ptr<OctreeNode>, 8> children_{};
-};
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFU;
 
-class Octree
-{
-public:
-    Octree(const BoundingBox& bounds, std::size_t maxDepth);
+    struct Node
+    {
+        Vector3 center;
+        float halfSize = 0.0F;
+        std::uint32_t parent = kInvalidIndex;
+        // The eight children are allocated together starting here.
+        std::uint32_t firstChild = kInvalidIndex;
+        std::uint32_t depth = 0;
+        // Objects in this node and all of its descendants; empty subtrees are skipped by queries.
+        std::uint32_t subtreeCount = 0;
+        std::vector<std::uint32_t> objects;
+    };
 
-    OctreeNode& root() noexcept { return *root_; }
-    const OctreeNode& root() const noexcept { return *root_; }
+    struct Object
+    {
+        BoundingBox bounds;
+        std::uint32_t node = kInvalidIndex;
+        // Position in the node's object list.
+        std::uint32_t slot = 0;
+    };
 
-private:
-    std::unique_ptr<OctreeNode> root_;
+    enum class Overlap
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    std::uint32_t findNode(const BoundingBox& bounds);
+    bool belongsTo(std::uint32_t node, const BoundingBox& bounds) const noexcept;
+    bool fitsChild(std::uint32_t node, const BoundingBox& bounds) const noexcept;
+    std::uint32_t childFor(std::uint32_t node, const Vector3& point) const noexcept;
+    void attach(std::uint32_t id, std::uint32_t node);
+    void detach(std::uint32_t id);
+    void subdivide(std::uint32_t node);
+    void collapse(std::uint32_t node);
+    void gather(std::uint32_t node, std::uint32_t target);
+    BoundingBox looseBounds(const Node& node) const noexcept;
+
+    template <typename NodeTest, typename ObjectTest>
+    std::size_t query(const NodeTest& nodeTest,
+                      const ObjectTest& objectTest,
+                      std::uint32_t* out,
+                      std::size_t capacity) const;
+
+    BoundingBox bounds_;
     std::size_t maxDepth_;
+    std::size_t nodeCapacity_;
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> freeBlocks_;
+    std::vector<Object> objects_;
+    std::size_t objectCount_ = 0;
 };
 } // namespace nre
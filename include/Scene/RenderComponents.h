@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "Math/Bounds.h"
+#include "Math/Matrix4.h"
+#include "Scene/EntityWorld.h"
+#include "Scene/Frustum.h"
+#include "Scene/Transform.h"
+
+namespace nre
+{
+class JobSystem;
+class Material;
+class Mesh;
+
+// Components shared between gameplay systems and the renderer. Transform itself is the local transform
+// component; the renderer only reads the derived world data below.
+struct WorldTransform
+{
+    Matrix4 matrix;
+};
+
+struct LocalBounds
+{
+    BoundingBox box;
+};
+
+struct WorldBounds
+{
+    BoundingBox box;
+};
+
+// Non-owning: the MeshCache or whoever loaded the mesh keeps it alive.
+struct MeshComponent
+{
+    const Mesh* mesh = nullptr;
+};
+
+struct MaterialComponent
+{
+    const Material* material = nullptr;
+};
+
+struct DrawItem
+{
+    const Mesh* mesh = nullptr;
+    const Material* material = nullptr;
+    Matrix4 world;
+};
+
+// WorldTransform = Transform::localMatrix() for entities with both; entities are unparented, use
+// TransformHierarchy for hierarchies. Chunks are processed in parallel when jobs is given.
+void updateWorldTransforms(EntityWorld& world, JobSystem* jobs = nullptr);
+// WorldBounds = LocalBounds transformed by WorldTransform.
+void updateWorldBounds(EntityWorld& world, JobSystem* jobs = nullptr);
+// Replaces out with the entities that have a mesh, a material and a WorldTransform, skipping those whose
+// WorldBounds lie outside the frustum. Items are sorted by material, then mesh, to minimize state changes.
+void collectDrawItems(EntityWorld& world, const Frustum& frustum, std::vector<DrawItem>& out);
+} // namespace nre
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/MappedFile.h"
+#include "Math/Bounds.h"
+#include "Math/Matrix4.h"
+#include "Scene/Transform.h"
+
+namespace nre
+{
+class TransformHierarchy;
+
+// Binary scene container (.nrescene). A fixed header is followed by a table of sections, each an offset
+// from the start of the file and a byte size, so the file is relocatable and every array can be used
+// straight from a read-only mapping. Nodes are stored in depth-first order like TransformHierarchy's
+// dense views, as parallel arrays: parent and subtree-end indices, the local position, rotation and scale
+// streams, local bounds streams with a per-node flag, and mesh and material indices. Meshes and
+// materials are referenced by name (an asset path or MeshCache key) through a shared string table.
+// Arrays are 16-byte aligned and little-endian.
+//
+// kVersion changes whenever the layout does; older files are rejected rather than converted.
+class SceneFile
+{
+public:
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFU;
+
+    SceneFile() = default;
+    // Maps the file and validates the header, the section table and the index arrays (O(nodes), no
+    // per-node work beyond that). Throws std::runtime_error for missing, truncated or foreign files and
+    // other versions.
+    explicit SceneFile(const std::string& path);
+
+    std::size_t nodeCount() const noexcept { return nodeCount_; }
+    // kInvalidIndex for roots; parents precede their children.
+    const std::uint32_t* parentIndices() const noexcept { return parents_; }
+    // One past the index of each node's last descendant.
+    const std::uint32_t* subtreeEnds() const noexcept { return subtreeEnds_; }
+    const TransformStreams& localTransforms() const noexcept { return transforms_; }
+    const BoundingBoxStreams& localBounds() const noexcept { return bounds_; }
+    bool hasBounds(std::size_t node) const noexcept { return boundsFlags_[node] != 0; }
+    // kInvalidIndex for nodes without a mesh or material.
+    const std::uint32_t* meshIndices() const noexcept { return meshIndices_; }
+    const std::uint32_t* materialIndices() const noexcept { return materialIndices_; }
+
+    std::size_t meshCount() const noexcept { return meshCount_; }
+    std::size_t materialCount() const noexcept { return materialCount_; }
+    std::string_view meshName(std::size_t mesh) const;
+    std::string_view materialName(std::size_t material) const;
+
+    // Composes every node's world matrix into out (nodeCount() entries) in one depth-first pass.
+    void computeWorldMatrices(Matrix4* out) const;
+
+private:
+    struct StringRef
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    MappedFile file_;
+    std::size_t nodeCount_ = 0;
+    std::size_t meshCount_ = 0;
+    std::size_t materialCount_ = 0;
+    const std::uint32_t* parents_ = nullptr;
+    const std::uint32_t* subtreeEnds_ = nullptr;
+    TransformStreams transforms_;
+    BoundingBoxStreams bounds_;
+    const std::uint8_t* boundsFlags_ = nullptr;
+    const std::uint32_t* meshIndices_ = nullptr;
+    const std::uint32_t* materialIndices_ = nullptr;
+    const StringRef* meshNames_ = nullptr;
+    const StringRef* materialNames_ = nullptr;
+    const char* strings_ = nullptr;
+};
+
+// Collects nodes in memory and writes them in the SceneFile layout.
+class SceneFileBuilder
+{
+public:
+    std::uint32_t addMesh(const std::string& name);
+    std::uint32_t addMaterial(const std::string& name);
+
+    // Nodes must arrive in depth-first order: parent is kInvalidIndex, or the last added node or one of
+    // its ancestors. Throws std::runtime_error otherwise, or for unknown mesh and material indices.
+    std::uint32_t addNode(std::uint32_t parent,
+                          const Transform& local,
+                          const BoundingBox* bounds = nullptr,
+                          std::uint32_t mesh = SceneFile::kInvalidIndex,
+                          std::uint32_t material = SceneFile::kInvalidIndex);
+    // Appends the whole hierarchy below parent, in its dense order; call its updateWorldMatrices()
+    // first so the order is current. Returns the index the hierarchy's first node got.
+    std::uint32_t addHierarchy(const TransformHierarchy& hierarchy, std::uint32_t parent = SceneFile::kInvalidIndex);
+
+    std::size_t nodeCount() const noexcept { return parents_.size(); }
+    // Throws std::runtime_error when the file cannot be written.
+    void write(const std::string& path) const;
+    void clear();
+
+private:
+    std::vector<std::string> meshes_;
+    std::vector<std::string> materials_;
+    std::vector<std::uint32_t> parents_;
+    std::vector<Transform> transforms_;
+    std::vector<BoundingBox> bounds_;
+    std::vector<std::uint8_t> boundsFlags_;
+    std::vector<std::uint32_t> meshIndices_;
+    std::vector<std::uint32_t> materialIndices_;
+    // The last added node and its ancestors, root first.
+    std::vector<std::uint32_t> openPath_;
+};
+} // namespace nre
@@ -1,16 +1,22 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "Math/Bounds.h"
+#include "Math/Matrix4.h"
+#include "Scene/DynamicBVH.h"
+#include "Scene/Frustum.h"
+#include "Scene/TransformHierarchy.h"
+
 namespace nre
 {
-class Transform;
-
+// Facade over one TransformHierarchy node; the transform data itself lives in the graph's hierarchy.
 class SceneNode
 {
 public:
-    SceneNode();
+    SceneNode(TransformHierarchy& hierarchy, NodeHandle parent);
     ~SceneNode();
 
     SceneNode(const SceneNode&) = delete;
@@ -20,12 +26,22 @@ public:
 
     SceneNode& addChild();
     const std::vector<std::unique_ptr<SceneNode>>& children() const noexcept;
-    Transform& transform() noexcept;
-    const Transform& transform() const noexcept;
+
+    // Snapshot of the local transform; write changes back with setTransform() or the setters.
+    Transform transform() const;
+    void setTransform(const Transform& transform);
+    void setPosition(const Vector3& position);
+    void setRotation(const Quaternion& rotation);
+    void setScale(const Vector3& scale);
+
+    // As of the last SceneGraph::updateWorldMatrices().
+    const Matrix4& worldMatrix() const;
+    NodeHandle handle() const noexcept { return handle_; }
 
 private:
     std::vector<std::unique_ptr<SceneNode>> children_;
-    std::unique_ptr<Transform> transform_;
+    TransformHierarchy* hierarchy_;
+    NodeHandle handle_;
 };
 
 class SceneGraph
@@ -36,7 +52,53 @@ public:
     SceneNode& root() noexcept { return *root_; }
     const SceneNode& root() const noexcept { return *root_; }
 
+    TransformHierarchy& hierarchy() noexcept { return *hierarchy_; }
+    const TransformHierarchy& hierarchy() const noexcept { return *hierarchy_; }
+
+    // Recomputes world matrices for nodes changed since the last call; returns how many were updated.
+    // Pass a JobSystem to process independent subtrees in parallel; the results are identical. Nodes with
+    // local bounds whose world matrix changed are then moved in the spatial index, which is refit once.
+    std::size_t updateWorldMatrices(JobSystem* jobs = nullptr);
+
+    // Gives the node a local-space box, tracked in spatialIndex() from the next updateWorldMatrices() on.
+    // Clear it before destroying the node through hierarchy(). Throw std::runtime_error for invalid handles.
+    void setLocalBounds(NodeHandle node, const BoundingBox& bounds);
+    void clearLocalBounds(NodeHandle node);
+    // World-space boxes of the nodes with local bounds, keyed by NodeHandle::slot.
+    const DynamicBVH& spatialIndex() const noexcept { return spatialIndex_; }
+
+    // Every node also keeps the union of the world boxes in its subtree, refreshed along the ancestors
+    // of the nodes that moved or changed bounds, so culling can reject a whole subtree with one test.
+    // Inverted (min > max) when no node in the subtree has bounds. Both functions use the state of the
+    // last updateWorldMatrices() and throw std::runtime_error when nodes were created, destroyed or
+    // reparented since.
+    BoundingBox subtreeBounds(NodeHandle node) const;
+    // Writes the slots of the nodes with bounds inside the frustum, in depth-first order; same contract as
+    // the spatial index queries. Planes a subtree lies fully inside are not tested again below it, and
+    // fully inside subtrees are emitted without further tests.
+    std::size_t cullFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const;
+
 private:
+    void checkSubtreeBounds() const;
+    BoundingBox ownBounds(std::uint32_t index) const noexcept;
+    void rebuildSubtreeBounds();
+    void markSubtreeDirty(std::uint32_t index);
+    void refreshDirtySubtrees();
+
+    // Heap-allocated so the nodes' back pointers stay valid when the graph is moved.
+    std::unique_ptr<TransformHierarchy> hierarchy_;
     std::unique_ptr<SceneNode> root_;
+    DynamicBVH spatialIndex_;
+    // Indexed by slot.
+    std::vector<BoundingBox> localBounds_;
+    std::vector<std::uint8_t> hasBounds_;
+    std::vector<BoundingBox> worldBounds_;
+    // Nodes whose bounds were set or cleared since the last update; they may not have moved.
+    std::vector<NodeHandle> pendingBounds_;
+    // Indexed by dense index, valid for the hierarchy structure version subtreeVersion_.
+    std::vector<BoundingBox> subtreeBounds_;
+    std::vector<std::uint8_t> subtreeDirty_;
+    std::vector<std::uint32_t> dirtySubtrees_;
+    std::uint64_t subtreeVersion_ = 0;
 };
 } // namespace nre
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+#include "Math/Vector3.h"
+#include "Scene/Frustum.h"
+
+namespace nre
+{
+class JobSystem;
+
+// Uniform grid over hashed cells for large populations of small objects that move every frame, such as
+// crowds or particles. There is no incremental update: build() places each object in the cell holding
+// its center and counting-sorts the ids by the cell's hash bucket, which costs a few linear passes and
+// no per-object allocation. Queries widen their cell range by the largest object half extent; objects
+// more than two cells wide are instead kept in a separate list that every query tests, so pick a cell size
+// near the typical object size.
+class SpatialHashGrid
+{
+public:
+    // Throws std::runtime_error unless cellSize is positive.
+    explicit SpatialHashGrid(float cellSize);
+
+    // Clears the grid; build() again before querying.
+    void setCellSize(float cellSize);
+    float cellSize() const noexcept { return cellSize_; }
+
+    // Object ids are indices into boxes. With a JobSystem the passes are spread across its workers.
+    void build(const BoundingBox* boxes, std::size_t count, JobSystem* jobs = nullptr);
+    void clear();
+
+    std::size_t size() const noexcept { return ids_.size(); }
+    std::size_t bucketCount() const noexcept { return bucketStart_.empty() ? 0 : bucketStart_.size() - 2; }
+
+    // Visit the buckets of the cells in the widened query range plus the oversized list, or scan every
+    // object when the range spans more cells than there are objects.
+    std::size_t queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const;
+    std::size_t queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const;
+    // Neighbor query: objects whose bounds come within the sphere.
+    std::size_t querySphere(const BoundingSphere& sphere, std::uint32_t* out, std::size_t capacity) const;
+
+private:
+    struct CellRange
+    {
+        std::int32_t min[3];
+        std::int32_t max[3];
+    };
+
+    std::int32_t cellCoordinate(float value) const noexcept;
+    CellRange cellRange(const BoundingBox& box) const noexcept;
+    BoundingBox cellBounds(std::uint64_t cell) const noexcept;
+
+    template <typename ObjectTest>
+    std::size_t queryRange(const BoundingBox& box,
+                           const ObjectTest& objectTest,
+                           std::uint32_t* out,
+                           std::size_t capacity) const;
+
+    float cellSize_;
+    float inverseCellSize_;
+    // Largest half extent per axis over the objects in the grid.
+    Vector3 maxHalfExtent_;
+    // Entries sorted by bucket: object id, packed cell coordinates and bounds.
+    std::vector<std::uint32_t> ids_;
+    std::vector<std::uint64_t> cells_;
+    std::vector<BoundingBox> bounds_;
+    // Entries of bucket b are [bucketStart_[b], bucketStart_[b + 1]); the oversized objects follow the
+    // last bucket.
+    std::vector<std::uint32_t> bucketStart_;
+    // Build scratch, indexed by object id.
+    std::vector<std::uint64_t> objectCells_;
+    std::vector<std::uint32_t> objectBuckets_;
+    std::vector<std::uint32_t> offsets_;
+};
+} // namespace nre
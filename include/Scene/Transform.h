@@ -1,11 +1,28 @@
 #pragma once
 
+#include <cstddef>
+
 #include "Math/Matrix4.h"
 #include "Math/Quaternion.h"
 #include "Math/Vector3.h"
 
 namespace nre
 {
+// Structure-of-arrays view over N transforms; every stream must hold at least N floats.
+struct TransformStreams
+{
+    const float* positionX = nullptr;
+    const float* positionY = nullptr;
+    const float* positionZ = nullptr;
+    const float* rotationX = nullptr;
+    const float* rotationY = nullptr;
+    const float* rotationZ = nullptr;
+    const float* rotationW = nullptr;
+    const float* scaleX = nullptr;
+    const float* scaleY = nullptr;
+    const float* scaleZ = nullptr;
+};
+
 class Transform
 {
 public:
@@ -21,6 +38,13 @@ public:
 
     Matrix4 localMatrix() const;
 
+    // Batched equivalents of localMatrix(): out[i] = T[i] * R[i] * S[i], and parent * out[i] for the fused variant.
+    static void composeLocalMatrices(const TransformStreams& streams, Matrix4* out, std::size_t count);
+    static void composeWorldMatrices(const Matrix4& parent,
+                                     const TransformStreams& streams,
+                                     Matrix4* out,
+                                     std::size_t count);
+
 private:
     Vector3 position_;
     Quaternion rotation_;
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+#include "Scene/Transform.h"
+
+namespace nre
+{
+class JobSystem;
+
+// Stable reference to a node; survives reordering and stays invalid once the node is destroyed.
+struct NodeHandle
+{
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+
+    constexpr bool operator==(const NodeHandle& other) const noexcept
+    {
+        return slot == other.slot && generation == other.generation;
+    }
+
+    constexpr bool operator!=(const NodeHandle& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    constexpr explicit operator bool() const noexcept { return generation != 0; }
+};
+
+// Flattened transform tree. Nodes live in contiguous arrays (parent index, local TRS streams, world
+// matrix) kept in depth-first order, so every parent precedes its children and each subtree occupies
+// the dense range [i, subtreeEnd(i)). Setters only flag the node; updateWorldMatrices() recomputes the
+// dirty nodes and their descendants in one forward pass.
+//
+// For the update the tree is cut into the few nodes with large subtrees, processed first on the calling
+// thread, and runs of complete smaller subtrees that only depend on those and are processed as
+// independent tasks. The cut depends on the tree alone, so serial and parallel updates perform the same
+// arithmetic and produce bit-identical matrices.
+//
+// Functions taking a NodeHandle throw std::runtime_error for handles that are not valid().
+class TransformHierarchy
+{
+public:
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFU;
+
+    // A null parent creates a root.
+    NodeHandle create(NodeHandle parent = {});
+    // Destroys the node and its whole subtree; invalid handles are ignored.
+    void destroy(NodeHandle node);
+    // Throws if parent is node itself or one of its descendants.
+    void setParent(NodeHandle node, NodeHandle parent);
+    void clear();
+
+    bool valid(NodeHandle node) const noexcept;
+    NodeHandle parent(NodeHandle node) const;
+    std::size_t size() const noexcept { return parent_.size(); }
+    // Changes whenever nodes are created, destroyed or reparented, that is whenever the dense views below
+    // may be reordered.
+    std::uint64_t structureVersion() const noexcept { return structureVersion_; }
+
+    void setPosition(NodeHandle node, const Vector3& position);
+    void setRotation(NodeHandle node, const Quaternion& rotation);
+    void setScale(NodeHandle node, const Vector3& scale);
+    void setLocalTransform(NodeHandle node, const Transform& transform);
+
+    Vector3 position(NodeHandle node) const;
+    Quaternion rotation(NodeHandle node) const;
+    Vector3 scale(NodeHandle node) const;
+    Transform localTransform(NodeHandle node) const;
+
+    // Returns the number of world matrices recomputed. With a JobSystem the subtree tasks are spread
+    // across its workers.
+    std::size_t updateWorldMatrices(JobSystem* jobs = nullptr);
+    // As of the last updateWorldMatrices().
+    const Matrix4& worldMatrix(NodeHandle node) const;
+    // Dense indices of the world matrices the last updateWorldMatrices() recomputed; the same for serial
+    // and parallel updates. Valid until the next update, create(), destroy() or setParent().
+    const std::vector<std::uint32_t>& updatedIndices() const noexcept { return updated_; }
+
+    // Dense views in depth-first order, valid after updateWorldMatrices() until the next create(),
+    // destroy() or setParent().
+    std::uint32_t denseIndex(NodeHandle node) const;
+    NodeHandle handleAt(std::uint32_t index) const noexcept;
+    const Matrix4* worldMatrices() const noexcept { return world_.data(); }
+    // Dense index of each node's parent, or kInvalidIndex for roots.
+    const std::uint32_t* parentIndices() const noexcept { return parent_.data(); }
+    // One past the dense index of each node's last descendant.
+    const std::uint32_t* subtreeEnds() const noexcept { return subtreeEnd_.data(); }
+
+private:
+    struct NodeRange
+    {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    std::uint32_t checkedIndex(NodeHandle node) const;
+    TransformStreams streamsAt(std::size_t index) const noexcept;
+    void eraseRange(std::uint32_t begin, std::uint32_t end);
+    void ensureOrder();
+    void rebuildOrder();
+    void refreshSubtreeEnds();
+    void rebuildRightmostPath();
+    void partition();
+    void updateRange(std::size_t begin, std::size_t end, std::vector<std::uint32_t>& updated);
+    void composeWorld(std::size_t begin, std::size_t count, Matrix4* parents, Matrix4* locals);
+
+    // Handle indirection: slot -> dense index (kInvalidIndex when free) and its current generation.
+    std::vector<std::uint32_t> slotIndex_;
+    std::vector<std::uint32_t> slotGeneration_;
+    std::vector<std::uint32_t> freeSlots_;
+
+    std::vector<std::uint32_t> slot_;
+    std::vector<std::uint32_t> parent_;
+    std::vector<std::uint32_t> subtreeEnd_;
+    std::vector<std::uint32_t> depth_;
+    std::vector<float> positionX_;
+    std::vector<float> positionY_;
+    std::vector<float> positionZ_;
+    std::vector<float> rotationX_;
+    std::vector<float> rotationY_;
+    std::vector<float> rotationZ_;
+    std::vector<float> rotationW_;
+    std::vector<float> scaleX_;
+    std::vector<float> scaleY_;
+    std::vector<float> scaleZ_;
+    std::vector<std::uint8_t> dirty_;
+    std::vector<Matrix4> world_;
+    std::uint64_t structureVersion_ = 0;
+    bool orderDirty_ = false;
+    bool subtreeEndsDirty_ = false;
+    // Dense indices of the last node and its ancestors, indexed by depth. Only a child of one of these can
+    // be appended without breaking the depth-first order.
+    std::vector<std::uint32_t> rightmostPath_;
+
+    std::vector<std::uint32_t> upperNodes_;
+    std::vector<NodeRange> subtreeTasks_;
+    std::vector<std::uint32_t> updated_;
+    // Per-task lists for parallel updates, kept to avoid reallocating every frame.
+    std::vector<std::vector<std::uint32_t>> taskUpdated_;
+};
+} // namespace nre
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Math/Vector3.h"
+#include "Renderer/MeshFactory.h"
+#include "Renderer/TextureLoader.h"
+
+namespace nre
+{
+class Mesh;
+class MeshCache;
+class Texture;
+
+// Streams a large world in square cells on the XZ plane, each with its own list of mesh and texture
+// files. A background thread ranks cells by their distance to the camera, or to where the camera will be
+// after the look-ahead time at its current velocity, whichever is closer, and decodes the closest missing
+// cell within the load radius. Cells past the unload radius are evicted; when the memory budget is
+// exhausted, resident cells farther away than the one being loaded make room for it, and a cell that would
+// not fit even then is skipped in favor of the next one.
+//
+// The streaming thread only reads files. GPU uploads through MeshCache and TextureLoader, and the
+// release of evicted cells' meshes and textures, happen in update() on the render thread. A cell's
+// resources are freed once nothing else holds the shared pointers, and assets shared by several cells
+// are counted against the budget once per cell, so the bound is conservative.
+class WorldPartition
+{
+public:
+    struct CellCoord
+    {
+        std::int32_t x = 0;
+        std::int32_t z = 0;
+    };
+
+    // Starts the streaming thread. Throws std::runtime_error unless cellSize is positive.
+    WorldPartition(MeshCache& meshes, TextureLoader& textures, float cellSize);
+    ~WorldPartition();
+
+    WorldPartition(const WorldPartition&) = delete;
+    WorldPartition& operator=(const WorldPartition&) = delete;
+
+    float cellSize() const noexcept { return cellSize_; }
+    CellCoord cellAt(const Vector3& position) const noexcept;
+
+    // Dependencies are fixed once streaming starts: these throw std::runtime_error after the first
+    // update(). Returns the asset's index within the cell.
+    std::uint32_t addMesh(const CellCoord& cell, const std::string& path);
+    std::uint32_t addTexture(const CellCoord& cell, const std::string& path);
+
+    // Distances are measured from the camera to the nearest point of a cell. Throws std::runtime_error
+    // unless 0 < loadRadius <= unloadRadius.
+    void setStreamingRadii(float loadRadius, float unloadRadius);
+    // Throws std::runtime_error for negative times.
+    void setLookAhead(float seconds);
+    // Bytes of vertex, index and texel data kept resident, including cells waiting for upload.
+    void setMemoryBudget(std::size_t bytes);
+
+    // Call once per frame on the render thread: hands the camera to the streaming thread, uploads the
+    // cells it has decoded since the last call and releases the ones it evicted.
+    void update(const Vector3& cameraPosition, const Vector3& cameraVelocity);
+    // Blocks until streaming has settled for the last camera passed to update(), for loading screens.
+    void flush();
+
+    // A cell is resident once its assets are uploaded, until update() releases it. Assets that failed to
+    // load are nullptr.
+    bool isResident(const CellCoord& cell) const;
+    std::shared_ptr<Mesh> residentMesh(const CellCoord& cell, std::uint32_t asset) const;
+    std::shared_ptr<Texture> residentTexture(const CellCoord& cell, std::uint32_t asset) const;
+    std::size_t residentCellCount() const;
+    std::size_t residentBytes() const;
+
+private:
+    enum class CellState : std::uint8_t
+    {
+        Unloaded,
+        // Being decoded by the streaming thread.
+        Loading,
+        // Decoded, holding its payload until the evictions started for it have been released.
+        Parked,
+        // Decoded and queued for upload.
+        Decoded,
+        Resident,
+        // Evicted by the streaming thread, released by the next update().
+        Evicting
+    };
+
+    enum class Reservation : std::uint8_t
+    {
+        Granted,
+        // Fits once the cells already being evicted are released.
+        Pending,
+        // Does not fit even after evicting every farther cell; nothing was evicted.
+        Refused
+    };
+
+    struct Cell
+    {
+        CellCoord coord;
+        std::vector<std::string> meshPaths;
+        std::vector<std::string> texturePaths;
+        CellState state = CellState::Unloaded;
+        // Decoded size, known after the first load.
+        std::size_t bytes = 0;
+        bool sized = false;
+        std::vector<MeshData> meshData;
+        std::vector<TextureImage> images;
+        // Only touched on the render thread.
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        std::vector<std::shared_ptr<Texture>> textures;
+    };
+
+    static std::uint64_t cellKey(const CellCoord& cell) noexcept;
+
+    Cell& registerCell(const CellCoord& cell);
+    const Cell* findCell(const CellCoord& cell) const;
+    float cellDistance(const Cell& cell) const noexcept;
+    void streamingLoop();
+    Cell* planLocked();
+    Reservation reserveLocked(std::size_t bytes, float distance);
+    void evictLocked(Cell& cell);
+    void storeLocked(Cell& cell, std::vector<MeshData> meshData, std::vector<TextureImage> images);
+    bool settleParkedLocked();
+    void applyResults();
+
+    MeshCache* meshCache_;
+    TextureLoader* textureLoader_;
+    float cellSize_;
+    std::unordered_map<std::uint64_t, Cell> cells_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idleChanged_;
+    std::thread thread_;
+    Vector3 camera_;
+    Vector3 velocity_;
+    float loadRadius_ = 256.0F;
+    float unloadRadius_ = 320.0F;
+    float lookAhead_ = 1.0F;
+    std::size_t budget_ = std::size_t{512} * 1024 * 1024;
+    // Bytes of Decoded, Resident and Evicting cells, and the Evicting part of it.
+    std::size_t committedBytes_ = 0;
+    std::size_t evictingBytes_ = 0;
+    std::vector<Cell*> uploads_;
+    std::vector<Cell*> evictions_;
+    // At most one cell is parked: planning waits for it before decoding another.
+    Cell* parked_ = nullptr;
+    // Planning scratch: unloaded cells within the load radius and their distances.
+    std::vector<std::pair<float, Cell*>> candidates_;
+    // Bumped whenever the streaming thread should plan again.
+    std::uint64_t version_ = 0;
+    std::uint64_t plannedVersion_ = 0;
+    bool started_ = false;
+    bool idle_ = false;
+    bool stopping_ = false;
+};
+} // namespace nre
@@ -0,0 +1,152 @@
+#include "Core/JobSystem.h"
+
+#include <algorithm>
+
+namespace nre
+{
+std::size_t JobSystem::defaultWorkerCount() noexcept
+{
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+JobSystem::JobSystem(std::size_t workerCount)
+{
+    workers_.reserve(workerCount);
+    for (std::size_t index = 0; index < workerCount; ++index)
+    {
+        workers_.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::parallelFor(std::size_t count, const std::function<void(std::size_t)>& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (workers_.empty() || count == 1)
+    {
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            body(index);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(callMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        busyWorkers_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    runIndices();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return busyWorkers_ == 0; });
+        body_ = nullptr;
+        error = error_;
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+std::size_t JobSystem::blockCount(const JobSystem* jobs, std::size_t count, std::size_t minBlockSize) noexcept
+{
+    if (jobs == nullptr || minBlockSize == 0)
+    {
+        return 1;
+    }
+    return std::clamp<std::size_t>(count / minBlockSize, 1, jobs->workerCount() + 1);
+}
+
+void JobSystem::forEachBlock(JobSystem* jobs,
+                             std::size_t blockCount,
+                             std::size_t count,
+                             const std::function<void(std::size_t, std::size_t, std::size_t)>& body)
+{
+    const auto run = [count, blockCount, &body](std::size_t block)
+    { body(block, count * block / blockCount, count * (block + 1) / blockCount); };
+    if (blockCount == 1 || jobs == nullptr)
+    {
+        for (std::size_t block = 0; block < blockCount; ++block)
+        {
+            run(block);
+        }
+        return;
+    }
+    jobs->parallelFor(blockCount, run);
+}
+
+void JobSystem::workerLoop()
+{
+    std::uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seenGeneration] { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_)
+            {
+                return;
+            }
+            seenGeneration = generation_;
+        }
+
+        runIndices();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busyWorkers_ == 0)
+        {
+            done_.notify_one();
+        }
+    }
+}
+
+void JobSystem::runIndices()
+{
+    while (true)
+    {
+        const std::size_t index = next_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count_)
+        {
+            return;
+        }
+        try
+        {
+            (*body_)(index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_)
+            {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
+} // namespace nre
@@ -0,0 +1,138 @@
+#include "Core/MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nre
+{
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& path)
+{
+    HANDLE file = CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to query file size: " + path);
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    if (size_ > 0)
+    {
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr)
+        {
+            data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    CloseHandle(file);
+    if (size_ > 0 && data_ == nullptr)
+    {
+        release();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+}
+
+void MappedFile::release() noexcept
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+    }
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+}
+#else
+MappedFile::MappedFile(const std::string& path)
+{
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    struct stat status
+    {
+    };
+    if (::fstat(file, &status) != 0)
+    {
+        ::close(file);
+        throw std::runtime_error("Failed to query file size: " + path);
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0)
+    {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(file);
+            size_ = 0;
+            throw std::runtime_error("Failed to map file: " + path);
+        }
+        data_ = static_cast<const std::byte*>(mapping);
+    }
+    ::close(file);
+}
+
+void MappedFile::release() noexcept
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+#if defined(_WIN32)
+      ,
+      mapping_(std::exchange(other.mapping_, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+        mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+    }
+    return *this;
+}
+} // namespace nre
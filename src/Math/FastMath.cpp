@@ -0,0 +1,932 @@
+#include "Math/FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+constexpr std::size_t kPacketWidth = 8;
+
+// Cody-Waite reduction by pi/4 in three parts; the first two have few enough mantissa bits that
+// octant * part is exact for the supported range (Cephes sinf/cosf).
+constexpr float kFourOverPi = 1.27323954473516F;
+constexpr float kPiOver4Part1 = 0.78515625F;
+constexpr float kPiOver4Part2 = 2.4187564849853515625e-4F;
+constexpr float kPiOver4Part3 = 3.77489497744594108e-8F;
+constexpr float kMaxOctant = 16777216.0F;
+constexpr float kSin0 = -1.9515295891e-4F;
+constexpr float kSin1 = 8.3321608736e-3F;
+constexpr float kSin2 = -1.6666654611e-1F;
+constexpr float kCos0 = 2.443315711809948e-5F;
+constexpr float kCos1 = -1.388731625493765e-3F;
+constexpr float kCos2 = 4.166664568298827e-2F;
+
+constexpr float kLog2E = 1.44269504088896341F;
+constexpr float kLn2Part1 = 0.693359375F;
+constexpr float kLn2Part2 = -2.12194440e-4F;
+constexpr float kExpMax = 88.72283905206835F;
+constexpr float kExpMin = -103.97208F;
+constexpr float kExp0 = 1.9875691500e-4F;
+constexpr float kExp1 = 1.3981999507e-3F;
+constexpr float kExp2 = 8.3334519073e-3F;
+constexpr float kExp3 = 4.1665795894e-2F;
+constexpr float kExp4 = 1.6666665459e-1F;
+constexpr float kExp5 = 5.0000001201e-1F;
+
+constexpr float kSqrtHalf = 0.707106781186547524F;
+constexpr float kDenormalScale = 8388608.0F;
+constexpr std::int32_t kDenormalScaleExponent = 23;
+constexpr float kLog0 = 7.0376836292e-2F;
+constexpr float kLog1 = -1.1514610310e-1F;
+constexpr float kLog2 = 1.1676998740e-1F;
+constexpr float kLog3 = -1.2420140846e-1F;
+constexpr float kLog4 = 1.4249322787e-1F;
+constexpr float kLog5 = -1.6668057665e-1F;
+constexpr float kLog6 = 2.0000714765e-1F;
+constexpr float kLog7 = -2.4999993993e-1F;
+constexpr float kLog8 = 3.3333331174e-1F;
+
+constexpr float kPi = 3.14159265358979323846F;
+constexpr float kPiOver2 = 1.57079632679489661923F;
+constexpr float kPiOver4 = 0.78539816339744830962F;
+constexpr float kTanPiOver8 = 0.4142135623730950F;
+constexpr float kAtan0 = 8.05374449538e-2F;
+constexpr float kAtan1 = -1.38776856032e-1F;
+constexpr float kAtan2 = 1.99777106478e-1F;
+constexpr float kAtan3 = -3.33329491539e-1F;
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+constexpr float kMinNormal = std::numeric_limits<float>::min();
+constexpr std::uint32_t kMantissaMask = 0x007FFFFFU;
+constexpr std::uint32_t kHalfExponent = 0x3F000000U;
+constexpr std::int32_t kExponentBias = 127;
+constexpr int kMantissaBits = 23;
+
+inline std::uint32_t floatBits(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsToFloat(std::uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 2^exponent for exponent in the normal range.
+inline float exponentToFloat(std::int32_t exponent)
+{
+    return bitsToFloat(static_cast<std::uint32_t>(exponent + kExponentBias) << kMantissaBits);
+}
+
+void sinCosScalar(float angle, float& sine, float& cosine)
+{
+    const float x = std::fabs(angle);
+    const float scaled = x * kFourOverPi;
+    std::int32_t octant = scaled < kMaxOctant ? static_cast<std::int32_t>(scaled) : 0;
+    octant = (octant + 1) & ~1;
+    const float y = static_cast<float>(octant);
+    const float r = ((x - y * kPiOver4Part1) - y * kPiOver4Part2) - y * kPiOver4Part3;
+    const float z = r * r;
+
+    const float cosPoly = ((kCos0 * z + kCos1) * z + kCos2) * z * z - 0.5F * z + 1.0F;
+    const float sinPoly = ((kSin0 * z + kSin1) * z + kSin2) * z * r + r;
+    const bool sinPolyForSine = (octant & 2) == 0;
+    sine = sinPolyForSine ? sinPoly : cosPoly;
+    cosine = sinPolyForSine ? cosPoly : sinPoly;
+    if (((octant & 4) != 0) != std::signbit(angle))
+    {
+        sine = -sine;
+    }
+    if (((octant - 2) & 4) == 0)
+    {
+        cosine = -cosine;
+    }
+}
+
+float rsqrtScalar(float value)
+{
+    if (std::fabs(value) < kMinNormal)
+    {
+        return std::copysign(kInfinity, value);
+    }
+    return 1.0F / std::sqrt(value);
+}
+
+// Zero, denormal-length and non-finite vectors take the exact path.
+Vector3 normalizeScalar(const Vector3& vector)
+{
+    const float scale = rsqrtScalar(vector.lengthSquared());
+    return std::isfinite(scale) && scale > 0.0F ? vector * scale : vector.normalized();
+}
+
+float expScalar(float value)
+{
+    if (std::isnan(value))
+    {
+        return value;
+    }
+    if (value > kExpMax)
+    {
+        return kInfinity;
+    }
+    if (value < kExpMin)
+    {
+        return 0.0F;
+    }
+    const float n = std::nearbyint(value * kLog2E);
+    const float r = value - n * kLn2Part1 - n * kLn2Part2;
+    const float p = (((((kExp0 * r + kExp1) * r + kExp2) * r + kExp3) * r + kExp4) * r + kExp5) * r * r + r + 1.0F;
+
+    // Two factors keep both exponents normal across the overflow and denormal edges.
+    const auto exponent = static_cast<std::int32_t>(n);
+    const std::int32_t half = exponent >> 1;
+    return p * exponentToFloat(half) * exponentToFloat(exponent - half);
+}
+
+float logScalar(float value)
+{
+    if (!(value >= 0.0F))
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (value == 0.0F)
+    {
+        return -kInfinity;
+    }
+    if (value == kInfinity)
+    {
+        return kInfinity;
+    }
+
+    std::int32_t exponentAdjust = 0;
+    if (value < kMinNormal)
+    {
+        value *= kDenormalScale;
+        exponentAdjust = kDenormalScaleExponent;
+    }
+    const std::uint32_t bits = floatBits(value);
+    std::int32_t exponent = static_cast<std::int32_t>(bits >> kMantissaBits) - (kExponentBias - 1) - exponentAdjust;
+    float m = bitsToFloat((bits & kMantissaMask) | kHalfExponent);
+    if (m < kSqrtHalf)
+    {
+        exponent -= 1;
+        m = m + m - 1.0F;
+    }
+    else
+    {
+        m = m - 1.0F;
+    }
+
+    const float e = static_cast<float>(exponent);
+    const float z = m * m;
+    float y = ((((((((kLog0 * m + kLog1) * m + kLog2) * m + kLog3) * m + kLog4) * m + kLog5) * m + kLog6) * m + kLog7) * m
+               + kLog8)
+              * m * z;
+    y += e * kLn2Part2;
+    y -= 0.5F * z;
+    return m + y + e * kLn2Part1;
+}
+
+float atan2Scalar(float y, float x)
+{
+    if (std::isnan(x) || std::isnan(y))
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float numerator = std::min(ax, ay);
+    const float denominator = std::max(ax, ay);
+    float t = 0.0F;
+    if (numerator == kInfinity)
+    {
+        t = 1.0F;
+    }
+    else if (denominator > 0.0F)
+    {
+        t = numerator / denominator;
+    }
+
+    float base = 0.0F;
+    if (t > kTanPiOver8)
+    {
+        t = (t - 1.0F) / (t + 1.0F);
+        base = kPiOver4;
+    }
+    const float z = t * t;
+    float result = (((kAtan0 * z + kAtan1) * z + kAtan2) * z + kAtan3) * z * t + t + base;
+    if (ay > ax)
+    {
+        result = kPiOver2 - result;
+    }
+    if (std::signbit(x))
+    {
+        result = kPi - result;
+    }
+    return std::copysign(result, y);
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 inline void sinCos4(__m128 angle, __m128& sine, __m128& cosine)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0F);
+    const __m128 x = _mm_andnot_ps(signMask, angle);
+    const __m128 scaled = _mm_min_ps(_mm_mul_ps(x, _mm_set1_ps(kFourOverPi)), _mm_set1_ps(kMaxOctant));
+    __m128i octant = _mm_cvttps_epi32(scaled);
+    octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    const __m128 y = _mm_cvtepi32_ps(octant);
+
+    const __m128i four = _mm_set1_epi32(4);
+    const __m128 sineSign = _mm_xor_ps(_mm_and_ps(angle, signMask),
+                                       _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, four), 29)));
+    const __m128 cosineSign = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), four), 29));
+    const __m128 sinPolyForSine = _mm_castsi128_ps(
+        _mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kPiOver4Part1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(y, _mm_set1_ps(kPiOver4Part2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(y, _mm_set1_ps(kPiOver4Part3)));
+    const __m128 z = _mm_mul_ps(r, r);
+
+    __m128 cosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCos0), z), _mm_set1_ps(kCos1));
+    cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(kCos2));
+    cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+    cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(_mm_set1_ps(0.5F), z)), _mm_set1_ps(1.0F));
+
+    __m128 sinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSin0), z), _mm_set1_ps(kSin1));
+    sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(kSin2));
+    sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), r), r);
+
+    sine = _mm_xor_ps(_mm_blendv_ps(cosPoly, sinPoly, sinPolyForSine), sineSign);
+    cosine = _mm_xor_ps(_mm_blendv_ps(sinPoly, cosPoly, sinPolyForSine), cosineSign);
+}
+
+// Inputs below FLT_MIN and infinities keep the estimate (+-inf and 0); Newton would turn them into NaN.
+NRE_TARGET_SSE41 inline __m128 rsqrt4(__m128 value)
+{
+    const __m128 estimate = _mm_rsqrt_ps(value);
+    const __m128 halfValue = _mm_mul_ps(_mm_set1_ps(0.5F), value);
+    const __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5F), _mm_mul_ps(_mm_mul_ps(halfValue, estimate), estimate));
+    const __m128 refined = _mm_mul_ps(estimate, correction);
+    const __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0F), value);
+    const __m128 keepEstimate = _mm_or_ps(_mm_cmplt_ps(magnitude, _mm_set1_ps(kMinNormal)),
+                                          _mm_cmpeq_ps(value, _mm_set1_ps(kInfinity)));
+    return _mm_blendv_ps(refined, estimate, keepEstimate);
+}
+
+NRE_TARGET_SSE41 inline __m128 exp4(__m128 value)
+{
+    const __m128 x = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(kExpMin)), _mm_set1_ps(kExpMax));
+    const __m128 n = _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(kLog2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(kLn2Part1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(kLn2Part2)));
+
+    __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kExp0), r), _mm_set1_ps(kExp1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExp2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExp3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExp4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExp5));
+    p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0F));
+
+    const __m128i exponent = _mm_cvtps_epi32(n);
+    const __m128i half = _mm_srai_epi32(exponent, 1);
+    const __m128i bias = _mm_set1_epi32(kExponentBias);
+    const __m128 scaleA = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(half, bias), kMantissaBits));
+    const __m128 scaleB = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_add_epi32(_mm_sub_epi32(exponent, half), bias), kMantissaBits));
+    __m128 result = _mm_mul_ps(_mm_mul_ps(p, scaleA), scaleB);
+
+    result = _mm_blendv_ps(result, _mm_set1_ps(kInfinity), _mm_cmpgt_ps(value, _mm_set1_ps(kExpMax)));
+    result = _mm_andnot_ps(_mm_cmplt_ps(value, _mm_set1_ps(kExpMin)), result);
+    return _mm_blendv_ps(result, value, _mm_cmpunord_ps(value, value));
+}
+
+NRE_TARGET_SSE41 inline __m128 log4(__m128 value)
+{
+    const __m128 denormal = _mm_cmplt_ps(value, _mm_set1_ps(kMinNormal));
+    const __m128 x = _mm_blendv_ps(value, _mm_mul_ps(value, _mm_set1_ps(kDenormalScale)), denormal);
+    const __m128i bits = _mm_castps_si128(x);
+
+    __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(bits, kMantissaBits), _mm_set1_epi32(kExponentBias - 1));
+    exponent = _mm_sub_epi32(
+        exponent, _mm_and_si128(_mm_castps_si128(denormal), _mm_set1_epi32(kDenormalScaleExponent)));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(static_cast<int>(kMantissaMask))),
+                                             _mm_set1_epi32(static_cast<int>(kHalfExponent))));
+    const __m128 belowSqrtHalf = _mm_cmplt_ps(m, _mm_set1_ps(kSqrtHalf));
+    exponent = _mm_add_epi32(exponent, _mm_castps_si128(belowSqrtHalf));
+    m = _mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.0F)), _mm_and_ps(belowSqrtHalf, m));
+
+    const __m128 e = _mm_cvtepi32_ps(exponent);
+    const __m128 z = _mm_mul_ps(m, m);
+    __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kLog0), m), _mm_set1_ps(kLog1));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog2));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog3));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog4));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog5));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog6));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog7));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(kLog8));
+    y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(kLn2Part2)));
+    y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5F), z));
+    __m128 result = _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(e, _mm_set1_ps(kLn2Part1)));
+
+    result = _mm_blendv_ps(result, _mm_set1_ps(kInfinity), _mm_cmpeq_ps(value, _mm_set1_ps(kInfinity)));
+    result = _mm_blendv_ps(result, _mm_set1_ps(-kInfinity), _mm_cmpeq_ps(value, _mm_setzero_ps()));
+    return _mm_or_ps(result, _mm_cmpnge_ps(value, _mm_setzero_ps()));
+}
+
+NRE_TARGET_SSE41 inline __m128 atan24(__m128 y, __m128 x)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0F);
+    const __m128 ax = _mm_andnot_ps(signMask, x);
+    const __m128 ay = _mm_andnot_ps(signMask, y);
+    const __m128 numerator = _mm_min_ps(ax, ay);
+    const __m128 denominator = _mm_max_ps(ax, ay);
+    __m128 t = _mm_div_ps(numerator, denominator);
+    t = _mm_andnot_ps(_mm_cmpeq_ps(denominator, _mm_setzero_ps()), t);
+    t = _mm_blendv_ps(t, _mm_set1_ps(1.0F), _mm_cmpeq_ps(numerator, _mm_set1_ps(kInfinity)));
+
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 reduce = _mm_cmpgt_ps(t, _mm_set1_ps(kTanPiOver8));
+    t = _mm_blendv_ps(t, _mm_div_ps(_mm_sub_ps(t, one), _mm_add_ps(t, one)), reduce);
+    const __m128 base = _mm_and_ps(reduce, _mm_set1_ps(kPiOver4));
+
+    const __m128 z = _mm_mul_ps(t, t);
+    __m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kAtan0), z), _mm_set1_ps(kAtan1));
+    result = _mm_add_ps(_mm_mul_ps(result, z), _mm_set1_ps(kAtan2));
+    result = _mm_add_ps(_mm_mul_ps(result, z), _mm_set1_ps(kAtan3));
+    result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(result, z), t), t), base);
+
+    result = _mm_blendv_ps(result, _mm_sub_ps(_mm_set1_ps(kPiOver2), result), _mm_cmpgt_ps(ay, ax));
+    // blendv selects on the sign bit, so x itself picks the left half-plane, including -0.
+    result = _mm_blendv_ps(result, _mm_sub_ps(_mm_set1_ps(kPi), result), x);
+    result = _mm_or_ps(result, _mm_and_ps(y, signMask));
+    return _mm_or_ps(result, _mm_cmpunord_ps(x, y));
+}
+
+NRE_TARGET_AVX2 inline void sinCos8(__m256 angle, __m256& sine, __m256& cosine)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0F);
+    const __m256 x = _mm256_andnot_ps(signMask, angle);
+    const __m256 scaled = _mm256_min_ps(_mm256_mul_ps(x, _mm256_set1_ps(kFourOverPi)), _mm256_set1_ps(kMaxOctant));
+    __m256i octant = _mm256_cvttps_epi32(scaled);
+    octant = _mm256_and_si256(_mm256_add_epi32(octant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    const __m256 y = _mm256_cvtepi32_ps(octant);
+
+    const __m256i four = _mm256_set1_epi32(4);
+    const __m256 sineSign = _mm256_xor_ps(_mm256_and_ps(angle, signMask),
+                                          _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, four), 29)));
+    const __m256 cosineSign = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(octant, _mm256_set1_epi32(2)), four), 29));
+    const __m256 sinPolyForSine = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+    __m256 r = _mm256_fnmadd_ps(y, _mm256_set1_ps(kPiOver4Part1), x);
+    r = _mm256_fnmadd_ps(y, _mm256_set1_ps(kPiOver4Part2), r);
+    r = _mm256_fnmadd_ps(y, _mm256_set1_ps(kPiOver4Part3), r);
+    const __m256 z = _mm256_mul_ps(r, r);
+
+    __m256 cosPoly = _mm256_fmadd_ps(_mm256_set1_ps(kCos0), z, _mm256_set1_ps(kCos1));
+    cosPoly = _mm256_fmadd_ps(cosPoly, z, _mm256_set1_ps(kCos2));
+    cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+    cosPoly = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5F), z, cosPoly), _mm256_set1_ps(1.0F));
+
+    __m256 sinPoly = _mm256_fmadd_ps(_mm256_set1_ps(kSin0), z, _mm256_set1_ps(kSin1));
+    sinPoly = _mm256_fmadd_ps(sinPoly, z, _mm256_set1_ps(kSin2));
+    sinPoly = _mm256_fmadd_ps(_mm256_mul_ps(sinPoly, z), r, r);
+
+    sine = _mm256_xor_ps(_mm256_blendv_ps(cosPoly, sinPoly, sinPolyForSine), sineSign);
+    cosine = _mm256_xor_ps(_mm256_blendv_ps(sinPoly, cosPoly, sinPolyForSine), cosineSign);
+}
+
+NRE_TARGET_AVX2 inline __m256 rsqrt8(__m256 value)
+{
+    const __m256 estimate = _mm256_rsqrt_ps(value);
+    const __m256 halfValue = _mm256_mul_ps(_mm256_set1_ps(0.5F), value);
+    const __m256 correction = _mm256_fnmadd_ps(_mm256_mul_ps(halfValue, estimate), estimate, _mm256_set1_ps(1.5F));
+    const __m256 refined = _mm256_mul_ps(estimate, correction);
+    const __m256 magnitude = _mm256_andnot_ps(_mm256_set1_ps(-0.0F), value);
+    const __m256 keepEstimate = _mm256_or_ps(_mm256_cmp_ps(magnitude, _mm256_set1_ps(kMinNormal), _CMP_LT_OQ),
+                                             _mm256_cmp_ps(value, _mm256_set1_ps(kInfinity), _CMP_EQ_OQ));
+    return _mm256_blendv_ps(refined, estimate, keepEstimate);
+}
+
+NRE_TARGET_AVX2 inline __m256 exp8(__m256 value)
+{
+    const __m256 x = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(kExpMin)), _mm256_set1_ps(kExpMax));
+    const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kLog2E)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2Part1), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2Part2), r);
+
+    __m256 p = _mm256_fmadd_ps(_mm256_set1_ps(kExp0), r, _mm256_set1_ps(kExp1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExp2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExp3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExp4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExp5));
+    p = _mm256_add_ps(_mm256_fmadd_ps(_mm256_mul_ps(p, r), r, r), _mm256_set1_ps(1.0F));
+
+    const __m256i exponent = _mm256_cvtps_epi32(n);
+    const __m256i half = _mm256_srai_epi32(exponent, 1);
+    const __m256i bias = _mm256_set1_epi32(kExponentBias);
+    const __m256 scaleA = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(half, bias), kMantissaBits));
+    const __m256 scaleB = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_add_epi32(_mm256_sub_epi32(exponent, half), bias), kMantissaBits));
+    __m256 result = _mm256_mul_ps(_mm256_mul_ps(p, scaleA), scaleB);
+
+    result = _mm256_blendv_ps(
+        result, _mm256_set1_ps(kInfinity), _mm256_cmp_ps(value, _mm256_set1_ps(kExpMax), _CMP_GT_OQ));
+    result = _mm256_andnot_ps(_mm256_cmp_ps(value, _mm256_set1_ps(kExpMin), _CMP_LT_OQ), result);
+    return _mm256_blendv_ps(result, value, _mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+}
+
+NRE_TARGET_AVX2 inline __m256 log8(__m256 value)
+{
+    const __m256 denormal = _mm256_cmp_ps(value, _mm256_set1_ps(kMinNormal), _CMP_LT_OQ);
+    const __m256 x = _mm256_blendv_ps(value, _mm256_mul_ps(value, _mm256_set1_ps(kDenormalScale)), denormal);
+    const __m256i bits = _mm256_castps_si256(x);
+
+    __m256i exponent = _mm256_sub_epi32(_mm256_srli_epi32(bits, kMantissaBits), _mm256_set1_epi32(kExponentBias - 1));
+    exponent = _mm256_sub_epi32(
+        exponent, _mm256_and_si256(_mm256_castps_si256(denormal), _mm256_set1_epi32(kDenormalScaleExponent)));
+    __m256 m = _mm256_castsi256_ps(
+        _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(static_cast<int>(kMantissaMask))),
+                        _mm256_set1_epi32(static_cast<int>(kHalfExponent))));
+    const __m256 belowSqrtHalf = _mm256_cmp_ps(m, _mm256_set1_ps(kSqrtHalf), _CMP_LT_OQ);
+    exponent = _mm256_add_epi32(exponent, _mm256_castps_si256(belowSqrtHalf));
+    m = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0F)), _mm256_and_ps(belowSqrtHalf, m));
+
+    const __m256 e = _mm256_cvtepi32_ps(exponent);
+    const __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_fmadd_ps(_mm256_set1_ps(kLog0), m, _mm256_set1_ps(kLog1));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog2));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog3));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog4));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog5));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog6));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog7));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLog8));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(kLn2Part2), y);
+    y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5F), z, y);
+    __m256 result = _mm256_fmadd_ps(e, _mm256_set1_ps(kLn2Part1), _mm256_add_ps(m, y));
+
+    result = _mm256_blendv_ps(
+        result, _mm256_set1_ps(kInfinity), _mm256_cmp_ps(value, _mm256_set1_ps(kInfinity), _CMP_EQ_OQ));
+    result = _mm256_blendv_ps(
+        result, _mm256_set1_ps(-kInfinity), _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_EQ_OQ));
+    return _mm256_or_ps(result, _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_NGE_UQ));
+}
+
+NRE_TARGET_AVX2 inline __m256 atan28(__m256 y, __m256 x)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0F);
+    const __m256 ax = _mm256_andnot_ps(signMask, x);
+    const __m256 ay = _mm256_andnot_ps(signMask, y);
+    const __m256 numerator = _mm256_min_ps(ax, ay);
+    const __m256 denominator = _mm256_max_ps(ax, ay);
+    __m256 t = _mm256_div_ps(numerator, denominator);
+    t = _mm256_andnot_ps(_mm256_cmp_ps(denominator, _mm256_setzero_ps(), _CMP_EQ_OQ), t);
+    t = _mm256_blendv_ps(
+        t, _mm256_set1_ps(1.0F), _mm256_cmp_ps(numerator, _mm256_set1_ps(kInfinity), _CMP_EQ_OQ));
+
+    const __m256 one = _mm256_set1_ps(1.0F);
+    const __m256 reduce = _mm256_cmp_ps(t, _mm256_set1_ps(kTanPiOver8), _CMP_GT_OQ);
+    t = _mm256_blendv_ps(t, _mm256_div_ps(_mm256_sub_ps(t, one), _mm256_add_ps(t, one)), reduce);
+    const __m256 base = _mm256_and_ps(reduce, _mm256_set1_ps(kPiOver4));
+
+    const __m256 z = _mm256_mul_ps(t, t);
+    __m256 result = _mm256_fmadd_ps(_mm256_set1_ps(kAtan0), z, _mm256_set1_ps(kAtan1));
+    result = _mm256_fmadd_ps(result, z, _mm256_set1_ps(kAtan2));
+    result = _mm256_fmadd_ps(result, z, _mm256_set1_ps(kAtan3));
+    result = _mm256_add_ps(_mm256_fmadd_ps(_mm256_mul_ps(result, z), t, t), base);
+
+    result = _mm256_blendv_ps(
+        result, _mm256_sub_ps(_mm256_set1_ps(kPiOver2), result), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    result = _mm256_blendv_ps(result, _mm256_sub_ps(_mm256_set1_ps(kPi), result), x);
+    result = _mm256_or_ps(result, _mm256_and_ps(y, signMask));
+    return _mm256_or_ps(result, _mm256_cmp_ps(x, y, _CMP_UNORD_Q));
+}
+
+// Batch drivers run a partial final packet through a zero-padded copy, so every element goes through
+// the same kernel regardless of its position in the array.
+NRE_TARGET_SSE41 void sinCosSSE(const float* angles, float* sines, float* cosines, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128 sine;
+        __m128 cosine;
+        sinCos4(_mm_loadu_ps(angles + index), sine, cosine);
+        _mm_storeu_ps(sines + index, sine);
+        _mm_storeu_ps(cosines + index, cosine);
+    }
+    if (index < count)
+    {
+        alignas(16) float lanes[3][4]{};
+        std::copy(angles + index, angles + count, lanes[0]);
+        __m128 sine;
+        __m128 cosine;
+        sinCos4(_mm_load_ps(lanes[0]), sine, cosine);
+        _mm_store_ps(lanes[1], sine);
+        _mm_store_ps(lanes[2], cosine);
+        std::copy(lanes[1], lanes[1] + (count - index), sines + index);
+        std::copy(lanes[2], lanes[2] + (count - index), cosines + index);
+    }
+}
+
+// Four packed Vector3s (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) per step: the squared lengths are
+// gathered with shuffles, and the reciprocal lengths are broadcast back into the same layout, so the
+// vectors are never transposed. Groups with a length rsqrt4() cannot handle take the scalar path.
+NRE_TARGET_SSE41 void normalizeSSE(const Vector3* in, Vector3* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const float* source = &in[index].x;
+        const __m128 a = _mm_loadu_ps(source);
+        const __m128 b = _mm_loadu_ps(source + 4);
+        const __m128 c = _mm_loadu_ps(source + 8);
+        const __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                                        _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                                        _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                                        _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                                        _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        const __m128 valid = _mm_and_ps(_mm_cmpge_ps(lengthSquared, _mm_set1_ps(kMinNormal)),
+                                        _mm_cmplt_ps(lengthSquared, _mm_set1_ps(kInfinity)));
+        if (_mm_movemask_ps(valid) != 0xF)
+        {
+            for (std::size_t lane = index; lane < index + 4; ++lane)
+            {
+                out[lane] = normalizeScalar(in[lane]);
+            }
+            continue;
+        }
+        const __m128 scale = rsqrt4(lengthSquared);
+        float* destination = &out[index].x;
+        _mm_storeu_ps(destination, _mm_mul_ps(a, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(1, 0, 0, 0))));
+        _mm_storeu_ps(destination + 4, _mm_mul_ps(b, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(2, 2, 1, 1))));
+        _mm_storeu_ps(destination + 8, _mm_mul_ps(c, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(3, 3, 3, 2))));
+    }
+    for (; index < count; ++index)
+    {
+        out[index] = normalizeScalar(in[index]);
+    }
+}
+
+NRE_TARGET_SSE41 void rsqrtSSE(const float* in, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        _mm_storeu_ps(out + index, rsqrt4(_mm_loadu_ps(in + index)));
+    }
+    if (index < count)
+    {
+        alignas(16) float lanes[4]{};
+        std::copy(in + index, in + count, lanes);
+        _mm_store_ps(lanes, rsqrt4(_mm_load_ps(lanes)));
+        std::copy(lanes, lanes + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_SSE41 void expSSE(const float* in, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        _mm_storeu_ps(out + index, exp4(_mm_loadu_ps(in + index)));
+    }
+    if (index < count)
+    {
+        alignas(16) float lanes[4]{};
+        std::copy(in + index, in + count, lanes);
+        _mm_store_ps(lanes, exp4(_mm_load_ps(lanes)));
+        std::copy(lanes, lanes + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_SSE41 void logSSE(const float* in, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        _mm_storeu_ps(out + index, log4(_mm_loadu_ps(in + index)));
+    }
+    if (index < count)
+    {
+        alignas(16) float lanes[4]{};
+        std::copy(in + index, in + count, lanes);
+        _mm_store_ps(lanes, log4(_mm_load_ps(lanes)));
+        std::copy(lanes, lanes + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_SSE41 void atan2SSE(const float* y, const float* x, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        _mm_storeu_ps(out + index, atan24(_mm_loadu_ps(y + index), _mm_loadu_ps(x + index)));
+    }
+    if (index < count)
+    {
+        alignas(16) float lanes[2][4]{};
+        std::copy(y + index, y + count, lanes[0]);
+        std::copy(x + index, x + count, lanes[1]);
+        _mm_store_ps(lanes[0], atan24(_mm_load_ps(lanes[0]), _mm_load_ps(lanes[1])));
+        std::copy(lanes[0], lanes[0] + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_AVX2 void sinCosAVX2(const float* angles, float* sines, float* cosines, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + kPacketWidth <= count; index += kPacketWidth)
+    {
+        __m256 sine;
+        __m256 cosine;
+        sinCos8(_mm256_loadu_ps(angles + index), sine, cosine);
+        _mm256_storeu_ps(sines + index, sine);
+        _mm256_storeu_ps(cosines + index, cosine);
+    }
+    if (index < count)
+    {
+        alignas(32) float lanes[3][kPacketWidth]{};
+        std::copy(angles + index, angles + count, lanes[0]);
+        __m256 sine;
+        __m256 cosine;
+        sinCos8(_mm256_load_ps(lanes[0]), sine, cosine);
+        _mm256_store_ps(lanes[1], sine);
+        _mm256_store_ps(lanes[2], cosine);
+        std::copy(lanes[1], lanes[1] + (count - index), sines + index);
+        std::copy(lanes[2], lanes[2] + (count - index), cosines + index);
+    }
+}
+
+NRE_TARGET_AVX2 inline __m256 loadHalves(const float* low, const float* high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+NRE_TARGET_AVX2 inline void storeHalves(float* low, float* high, __m256 value)
+{
+    _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+}
+
+// normalizeSSE() with vectors 0-3 in the low and 4-7 in the high lanes; the in-lane shuffles carry over.
+NRE_TARGET_AVX2 void normalizeAVX2(const Vector3* in, Vector3* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + kPacketWidth <= count; index += kPacketWidth)
+    {
+        const float* source = &in[index].x;
+        const __m256 a = loadHalves(source, source + 12);
+        const __m256 b = loadHalves(source + 4, source + 16);
+        const __m256 c = loadHalves(source + 8, source + 20);
+        const __m256 x =
+            _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        const __m256 y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                                           _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                                           _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                                           _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                                           _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 lengthSquared = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+        const __m256 valid = _mm256_and_ps(_mm256_cmp_ps(lengthSquared, _mm256_set1_ps(kMinNormal), _CMP_GE_OQ),
+                                           _mm256_cmp_ps(lengthSquared, _mm256_set1_ps(kInfinity), _CMP_LT_OQ));
+        if (_mm256_movemask_ps(valid) != 0xFF)
+        {
+            for (std::size_t lane = index; lane < index + kPacketWidth; ++lane)
+            {
+                out[lane] = normalizeScalar(in[lane]);
+            }
+            continue;
+        }
+        const __m256 scale = rsqrt8(lengthSquared);
+        float* destination = &out[index].x;
+        storeHalves(destination,
+                    destination + 12,
+                    _mm256_mul_ps(a, _mm256_shuffle_ps(scale, scale, _MM_SHUFFLE(1, 0, 0, 0))));
+        storeHalves(destination + 4,
+                    destination + 16,
+                    _mm256_mul_ps(b, _mm256_shuffle_ps(scale, scale, _MM_SHUFFLE(2, 2, 1, 1))));
+        storeHalves(destination + 8,
+                    destination + 20,
+                    _mm256_mul_ps(c, _mm256_shuffle_ps(scale, scale, _MM_SHUFFLE(3, 3, 3, 2))));
+    }
+    normalizeSSE(in + index, out + index, count - index);
+}
+
+NRE_TARGET_AVX2 void rsqrtAVX2(const float* in, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + kPacketWidth <= count; index += kPacketWidth)
+    {
+        _mm256_storeu_ps(out + index, rsqrt8(_mm256_loadu_ps(in + index)));
+    }
+    if (index < count)
+    {
+        alignas(32) float lanes[kPacketWidth]{};
+        std::copy(in + index, in + count, lanes);
+        _mm256_store_ps(lanes, rsqrt8(_mm256_load_ps(lanes)));
+        std::copy(lanes, lanes + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_AVX2 void expAVX2(const float* in, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + kPacketWidth <= count; index += kPacketWidth)
+    {
+        _mm256_storeu_ps(out + index, exp8(_mm256_loadu_ps(in + index)));
+    }
+    if (index < count)
+    {
+        alignas(32) float lanes[kPacketWidth]{};
+        std::copy(in + index, in + count, lanes);
+        _mm256_store_ps(lanes, exp8(_mm256_load_ps(lanes)));
+        std::copy(lanes, lanes + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_AVX2 void logAVX2(const float* in, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + kPacketWidth <= count; index += kPacketWidth)
+    {
+        _mm256_storeu_ps(out + index, log8(_mm256_loadu_ps(in + index)));
+    }
+    if (index < count)
+    {
+        alignas(32) float lanes[kPacketWidth]{};
+        std::copy(in + index, in + count, lanes);
+        _mm256_store_ps(lanes, log8(_mm256_load_ps(lanes)));
+        std::copy(lanes, lanes + (count - index), out + index);
+    }
+}
+
+NRE_TARGET_AVX2 void atan2AVX2(const float* y, const float* x, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + kPacketWidth <= count; index += kPacketWidth)
+    {
+        _mm256_storeu_ps(out + index, atan28(_mm256_loadu_ps(y + index), _mm256_loadu_ps(x + index)));
+    }
+    if (index < count)
+    {
+        alignas(32) float lanes[2][kPacketWidth]{};
+        std::copy(y + index, y + count, lanes[0]);
+        std::copy(x + index, x + count, lanes[1]);
+        _mm256_store_ps(lanes[0], atan28(_mm256_load_ps(lanes[0]), _mm256_load_ps(lanes[1])));
+        std::copy(lanes[0], lanes[0] + (count - index), out + index);
+    }
+}
+#endif
+} // namespace
+
+void FastMath::sinCos(const float* angles, float* sines, float* cosines, std::size_t count) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        sinCosAVX2(angles, sines, cosines, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        sinCosSSE(angles, sines, cosines, count);
+        return;
+    }
+#endif
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        sinCosScalar(angles[index], sines[index], cosines[index]);
+    }
+}
+
+void FastMath::rsqrt(const float* in, float* out, std::size_t count) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        rsqrtAVX2(in, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        rsqrtSSE(in, out, count);
+        return;
+    }
+#endif
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        out[index] = rsqrtScalar(in[index]);
+    }
+}
+
+void FastMath::exp(const float* in, float* out, std::size_t count) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        expAVX2(in, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        expSSE(in, out, count);
+        return;
+    }
+#endif
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        out[index] = expScalar(in[index]);
+    }
+}
+
+void FastMath::log(const float* in, float* out, std::size_t count) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        logAVX2(in, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        logSSE(in, out, count);
+        return;
+    }
+#endif
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        out[index] = logScalar(in[index]);
+    }
+}
+
+void FastMath::atan2(const float* y, const float* x, float* out, std::size_t count) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        atan2AVX2(y, x, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        atan2SSE(y, x, out, count);
+        return;
+    }
+#endif
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        out[index] = atan2Scalar(y[index], x[index]);
+    }
+}
+
+void FastMath::normalize(const Vector3* in, Vector3* out, std::size_t count) noexcept
+{
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be three packed floats");
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        normalizeAVX2(in, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        normalizeSSE(in, out, count);
+        return;
+    }
+#endif
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        out[index] = normalizeScalar(in[index]);
+    }
+}
+} // namespace nre
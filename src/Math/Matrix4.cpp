@@ -2,13 +2,240 @@
 
 #include <cmath>
 
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
 namespace nre
 {
-Matrix4 Matrix4::identity()
+namespace
+{
+Vector3 column3(const Matrix4& m, std::size_t column)
+{
+    return {m.data[column * 4 + 0], m.data[column * 4 + 1], m.data[column * 4 + 2]};
+}
+
+void normalMatrixScalar(const float* m, float* out)
+{
+    const float a0 = m[0];
+    const float a1 = m[1];
+    const float a2 = m[2];
+    const float b0 = m[4];
+    const float b1 = m[5];
+    const float b2 = m[6];
+    const float c0 = m[8];
+    const float c1 = m[9];
+    const float c2 = m[10];
+
+    // Columns of the inverse-transpose are the cofactor columns b x c, c x a, a x b over det.
+    const float bc0 = b1 * c2 - b2 * c1;
+    const float bc1 = b2 * c0 - b0 * c2;
+    const float bc2 = b0 * c1 - b1 * c0;
+    const float ca0 = c1 * a2 - c2 * a1;
+    const float ca1 = c2 * a0 - c0 * a2;
+    const float ca2 = c0 * a1 - c1 * a0;
+    const float ab0 = a1 * b2 - a2 * b1;
+    const float ab1 = a2 * b0 - a0 * b2;
+    const float ab2 = a0 * b1 - a1 * b0;
+
+    const float det = a0 * bc0 + a1 * bc1 + a2 * bc2;
+    const float invDet = det != 0.0F ? 1.0F / det : 1.0F;
+
+    out[0] = bc0 * invDet;
+    out[1] = bc1 * invDet;
+    out[2] = bc2 * invDet;
+    out[3] = 0.0F;
+    out[4] = ca0 * invDet;
+    out[5] = ca1 * invDet;
+    out[6] = ca2 * invDet;
+    out[7] = 0.0F;
+    out[8] = ab0 * invDet;
+    out[9] = ab1 * invDet;
+    out[10] = ab2 * invDet;
+    out[11] = 0.0F;
+}
+
+void normalMatricesScalar(const Matrix4* models, float* out, std::size_t count)
 {
-    return {};
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        normalMatrixScalar(models[index].dataPtr(), out + index * 12);
+    }
 }
 
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 void normalMatricesSSE(const Matrix4* models, float* out, std::size_t count)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0F);
+
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        // m[k] holds element k of the four matrices; only the upper 3x3 is needed.
+        __m128 m[12];
+        for (std::size_t group = 0; group < 12; group += 4)
+        {
+            __m128 r0 = _mm_load_ps(models[index + 0].dataPtr() + group);
+            __m128 r1 = _mm_load_ps(models[index + 1].dataPtr() + group);
+            __m128 r2 = _mm_load_ps(models[index + 2].dataPtr() + group);
+            __m128 r3 = _mm_load_ps(models[index + 3].dataPtr() + group);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            m[group + 0] = r0;
+            m[group + 1] = r1;
+            m[group + 2] = r2;
+            m[group + 3] = r3;
+        }
+
+        const __m128 bc0 = _mm_sub_ps(_mm_mul_ps(m[5], m[10]), _mm_mul_ps(m[6], m[9]));
+        const __m128 bc1 = _mm_sub_ps(_mm_mul_ps(m[6], m[8]), _mm_mul_ps(m[4], m[10]));
+        const __m128 bc2 = _mm_sub_ps(_mm_mul_ps(m[4], m[9]), _mm_mul_ps(m[5], m[8]));
+        const __m128 ca0 = _mm_sub_ps(_mm_mul_ps(m[9], m[2]), _mm_mul_ps(m[10], m[1]));
+        const __m128 ca1 = _mm_sub_ps(_mm_mul_ps(m[10], m[0]), _mm_mul_ps(m[8], m[2]));
+        const __m128 ca2 = _mm_sub_ps(_mm_mul_ps(m[8], m[1]), _mm_mul_ps(m[9], m[0]));
+        const __m128 ab0 = _mm_sub_ps(_mm_mul_ps(m[1], m[6]), _mm_mul_ps(m[2], m[5]));
+        const __m128 ab1 = _mm_sub_ps(_mm_mul_ps(m[2], m[4]), _mm_mul_ps(m[0], m[6]));
+        const __m128 ab2 = _mm_sub_ps(_mm_mul_ps(m[0], m[5]), _mm_mul_ps(m[1], m[4]));
+
+        const __m128 det =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], bc0), _mm_mul_ps(m[1], bc1)), _mm_mul_ps(m[2], bc2));
+        const __m128 singular = _mm_cmpeq_ps(det, zero);
+        const __m128 invDet = _mm_blendv_ps(_mm_div_ps(one, det), one, singular);
+
+        __m128 n[12] = {_mm_mul_ps(bc0, invDet), _mm_mul_ps(bc1, invDet), _mm_mul_ps(bc2, invDet), zero,
+                        _mm_mul_ps(ca0, invDet), _mm_mul_ps(ca1, invDet), _mm_mul_ps(ca2, invDet), zero,
+                        _mm_mul_ps(ab0, invDet), _mm_mul_ps(ab1, invDet), _mm_mul_ps(ab2, invDet), zero};
+
+        for (std::size_t group = 0; group < 12; group += 4)
+        {
+            __m128 r0 = n[group + 0];
+            __m128 r1 = n[group + 1];
+            __m128 r2 = n[group + 2];
+            __m128 r3 = n[group + 3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(out + (index + 0) * 12 + group, r0);
+            _mm_storeu_ps(out + (index + 1) * 12 + group, r1);
+            _mm_storeu_ps(out + (index + 2) * 12 + group, r2);
+            _mm_storeu_ps(out + (index + 3) * 12 + group, r3);
+        }
+    }
+
+    if (index < count)
+    {
+        normalMatricesScalar(models + index, out + index * 12, count - index);
+    }
+}
+
+NRE_TARGET_AVX2 void normalMatricesAVX2(const Matrix4* models, float* out, std::size_t count)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0F);
+
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m256 rows[8];
+        __m256 low[8];
+        __m256 high[8];
+        // Matrix4 only guarantees 16-byte alignment, so the 32-byte loads must be unaligned.
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            rows[lane] = _mm256_loadu_ps(models[index + lane].dataPtr());
+        }
+        simd::transpose8x8(rows, low);
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            rows[lane] = _mm256_loadu_ps(models[index + lane].dataPtr() + 8);
+        }
+        simd::transpose8x8(rows, high);
+
+        const __m256 a0 = low[0];
+        const __m256 a1 = low[1];
+        const __m256 a2 = low[2];
+        const __m256 b0 = low[4];
+        const __m256 b1 = low[5];
+        const __m256 b2 = low[6];
+        const __m256 c0 = high[0];
+        const __m256 c1 = high[1];
+        const __m256 c2 = high[2];
+
+        const __m256 bc0 = _mm256_fmsub_ps(b1, c2, _mm256_mul_ps(b2, c1));
+        const __m256 bc1 = _mm256_fmsub_ps(b2, c0, _mm256_mul_ps(b0, c2));
+        const __m256 bc2 = _mm256_fmsub_ps(b0, c1, _mm256_mul_ps(b1, c0));
+        const __m256 ca0 = _mm256_fmsub_ps(c1, a2, _mm256_mul_ps(c2, a1));
+        const __m256 ca1 = _mm256_fmsub_ps(c2, a0, _mm256_mul_ps(c0, a2));
+        const __m256 ca2 = _mm256_fmsub_ps(c0, a1, _mm256_mul_ps(c1, a0));
+        const __m256 ab0 = _mm256_fmsub_ps(a1, b2, _mm256_mul_ps(a2, b1));
+        const __m256 ab1 = _mm256_fmsub_ps(a2, b0, _mm256_mul_ps(a0, b2));
+        const __m256 ab2 = _mm256_fmsub_ps(a0, b1, _mm256_mul_ps(a1, b0));
+
+        const __m256 det = _mm256_fmadd_ps(a2, bc2, _mm256_fmadd_ps(a1, bc1, _mm256_mul_ps(a0, bc0)));
+        const __m256 singular = _mm256_cmp_ps(det, zero, _CMP_EQ_OQ);
+        const __m256 invDet = _mm256_blendv_ps(_mm256_div_ps(one, det), one, singular);
+
+        const __m256 n[16] = {_mm256_mul_ps(bc0, invDet), _mm256_mul_ps(bc1, invDet), _mm256_mul_ps(bc2, invDet),
+                              zero,
+                              _mm256_mul_ps(ca0, invDet), _mm256_mul_ps(ca1, invDet), _mm256_mul_ps(ca2, invDet),
+                              zero,
+                              _mm256_mul_ps(ab0, invDet), _mm256_mul_ps(ab1, invDet), _mm256_mul_ps(ab2, invDet),
+                              zero, zero, zero, zero, zero};
+
+        simd::transpose8x8(n, low);
+        simd::transpose8x8(n + 8, high);
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            float* destination = out + (index + lane) * 12;
+            _mm256_storeu_ps(destination, low[lane]);
+            _mm_storeu_ps(destination + 8, _mm256_castps256_ps128(high[lane]));
+        }
+    }
+
+    if (index < count)
+    {
+        normalMatricesSSE(models + index, out + index * 12, count - index);
+    }
+}
+#endif
+
+// Single products skip the SIMDMath dispatch: SSE2 is part of the x86-64 baseline, and at one matrix the
+// atomic level load and indirect call cost as much as the wider kernels save. out may alias lhs or rhs.
+inline void multiplySingle(const float* lhs, const float* rhs, float* out) noexcept
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const __m128 a0 = _mm_load_ps(lhs);
+    const __m128 a1 = _mm_load_ps(lhs + 4);
+    const __m128 a2 = _mm_load_ps(lhs + 8);
+    const __m128 a3 = _mm_load_ps(lhs + 12);
+    __m128 columns[4];
+    for (int column = 0; column < 4; ++column)
+    {
+        const float* b = rhs + column * 4;
+        __m128 sum = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+        columns[column] = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+    }
+    for (int column = 0; column < 4; ++column)
+    {
+        _mm_store_ps(out + column * 4, columns[column]);
+    }
+#else
+    float temp[16];
+    for (int column = 0; column < 4; ++column)
+    {
+        for (int row = 0; row < 4; ++row)
+        {
+            temp[column * 4 + row] = lhs[row] * rhs[column * 4] + lhs[4 + row] * rhs[column * 4 + 1]
+                                     + lhs[8 + row] * rhs[column * 4 + 2] + lhs[12 + row] * rhs[column * 4 + 3];
+        }
+    }
+    for (int element = 0; element < 16; ++element)
+    {
+        out[element] = temp[element];
+    }
+#endif
+}
+} // namespace
+
 Matrix4 Matrix4::perspective(float fovRadians, float aspectRatio, float nearPlane, float farPlane)
 {
     Matrix4 result{};
@@ -70,35 +297,151 @@ Matrix4 Matrix4::lookAt(const Vector3& eye, const Vector3& target, const Vector3
 
 Matrix4 Matrix4::operator*(const Matrix4& rhs) const noexcept
 {
-    Matrix4 result{};
-    for (int column = 0; column < 4; ++column)
-    {
-        for (int row = 0; row < 4; ++row)
-        {
-            float value = 0.0F;
-            for (int inner = 0; inner < 4; ++inner)
-            {
-                value += at(row, inner) * rhs.at(inner, column);
-            }
-            result.at(row, column) = value;
-        }
-    }
+    Matrix4 result;
+    multiplySingle(dataPtr(), rhs.dataPtr(), result.dataPtr());
     return result;
 }
 
 Matrix4& Matrix4::operator*=(const Matrix4& rhs) noexcept
 {
-    *this = *this * rhs;
+    multiplySingle(dataPtr(), rhs.dataPtr(), dataPtr());
     return *this;
 }
 
-float& Matrix4::at(int row, int column) noexcept
+float Matrix4::determinant() const noexcept
+{
+    const float a0 = at(0, 0) * at(1, 1) - at(0, 1) * at(1, 0);
+    const float a1 = at(0, 0) * at(1, 2) - at(0, 2) * at(1, 0);
+    const float a2 = at(0, 0) * at(1, 3) - at(0, 3) * at(1, 0);
+    const float a3 = at(0, 1) * at(1, 2) - at(0, 2) * at(1, 1);
+    const float a4 = at(0, 1) * at(1, 3) - at(0, 3) * at(1, 1);
+    const float a5 = at(0, 2) * at(1, 3) - at(0, 3) * at(1, 2);
+    const float b0 = at(2, 0) * at(3, 1) - at(2, 1) * at(3, 0);
+    const float b1 = at(2, 0) * at(3, 2) - at(2, 2) * at(3, 0);
+    const float b2 = at(2, 0) * at(3, 3) - at(2, 3) * at(3, 0);
+    const float b3 = at(2, 1) * at(3, 2) - at(2, 2) * at(3, 1);
+    const float b4 = at(2, 1) * at(3, 3) - at(2, 3) * at(3, 1);
+    const float b5 = at(2, 2) * at(3, 3) - at(2, 3) * at(3, 2);
+    return a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
+}
+
+Matrix4 Matrix4::inverse() const noexcept
+{
+    // Laplace expansion over 2x2 minors of the top and bottom row pairs.
+    const float a0 = at(0, 0) * at(1, 1) - at(0, 1) * at(1, 0);
+    const float a1 = at(0, 0) * at(1, 2) - at(0, 2) * at(1, 0);
+    const float a2 = at(0, 0) * at(1, 3) - at(0, 3) * at(1, 0);
+    const float a3 = at(0, 1) * at(1, 2) - at(0, 2) * at(1, 1);
+    const float a4 = at(0, 1) * at(1, 3) - at(0, 3) * at(1, 1);
+    const float a5 = at(0, 2) * at(1, 3) - at(0, 3) * at(1, 2);
+    const float b0 = at(2, 0) * at(3, 1) - at(2, 1) * at(3, 0);
+    const float b1 = at(2, 0) * at(3, 2) - at(2, 2) * at(3, 0);
+    const float b2 = at(2, 0) * at(3, 3) - at(2, 3) * at(3, 0);
+    const float b3 = at(2, 1) * at(3, 2) - at(2, 2) * at(3, 1);
+    const float b4 = at(2, 1) * at(3, 3) - at(2, 3) * at(3, 1);
+    const float b5 = at(2, 2) * at(3, 3) - at(2, 3) * at(3, 2);
+
+    const float det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
+    if (det == 0.0F)
+    {
+        return identity();
+    }
+    const float invDet = 1.0F / det;
+
+    Matrix4 result;
+    result.at(0, 0) = (at(1, 1) * b5 - at(1, 2) * b4 + at(1, 3) * b3) * invDet;
+    result.at(1, 0) = (-at(1, 0) * b5 + at(1, 2) * b2 - at(1, 3) * b1) * invDet;
+    result.at(2, 0) = (at(1, 0) * b4 - at(1, 1) * b2 + at(1, 3) * b0) * invDet;
+    result.at(3, 0) = (-at(1, 0) * b3 + at(1, 1) * b1 - at(1, 2) * b0) * invDet;
+    result.at(0, 1) = (-at(0, 1) * b5 + at(0, 2) * b4 - at(0, 3) * b3) * invDet;
+    result.at(1, 1) = (at(0, 0) * b5 - at(0, 2) * b2 + at(0, 3) * b1) * invDet;
+    result.at(2, 1) = (-at(0, 0) * b4 + at(0, 1) * b2 - at(0, 3) * b0) * invDet;
+    result.at(3, 1) = (at(0, 0) * b3 - at(0, 1) * b1 + at(0, 2) * b0) * invDet;
+    result.at(0, 2) = (at(3, 1) * a5 - at(3, 2) * a4 + at(3, 3) * a3) * invDet;
+    result.at(1, 2) = (-at(3, 0) * a5 + at(3, 2) * a2 - at(3, 3) * a1) * invDet;
+    result.at(2, 2) = (at(3, 0) * a4 - at(3, 1) * a2 + at(3, 3) * a0) * invDet;
+    result.at(3, 2) = (-at(3, 0) * a3 + at(3, 1) * a1 - at(3, 2) * a0) * invDet;
+    result.at(0, 3) = (-at(2, 1) * a5 + at(2, 2) * a4 - at(2, 3) * a3) * invDet;
+    result.at(1, 3) = (at(2, 0) * a5 - at(2, 2) * a2 + at(2, 3) * a1) * invDet;
+    result.at(2, 3) = (-at(2, 0) * a4 + at(2, 1) * a2 - at(2, 3) * a0) * invDet;
+    result.at(3, 3) = (at(2, 0) * a3 - at(2, 1) * a1 + at(2, 2) * a0) * invDet;
+    return result;
+}
+
+Matrix4 Matrix4::inverseAffine() const noexcept
+{
+    const Vector3 a = column3(*this, 0);
+    const Vector3 b = column3(*this, 1);
+    const Vector3 c = column3(*this, 2);
+    const Vector3 t = column3(*this, 3);
+
+    const Vector3 bc = Vector3::cross(b, c);
+    const float det = Vector3::dot(a, bc);
+    if (det == 0.0F)
+    {
+        return identity();
+    }
+    const float invDet = 1.0F / det;
+
+    // Rows of the 3x3 inverse are the cofactor columns over det.
+    const Vector3 r0 = bc * invDet;
+    const Vector3 r1 = Vector3::cross(c, a) * invDet;
+    const Vector3 r2 = Vector3::cross(a, b) * invDet;
+
+    Matrix4 result;
+    result.data = {r0.x, r1.x, r2.x, 0.0F,
+                   r0.y, r1.y, r2.y, 0.0F,
+                   r0.z, r1.z, r2.z, 0.0F,
+                   -Vector3::dot(r0, t), -Vector3::dot(r1, t), -Vector3::dot(r2, t), 1.0F};
+    return result;
+}
+
+Matrix4 Matrix4::inverseRigid() const noexcept
 {
-    return data[static_cast<std::size_t>(column * 4 + row)];
+    const Vector3 a = column3(*this, 0);
+    const Vector3 b = column3(*this, 1);
+    const Vector3 c = column3(*this, 2);
+    const Vector3 t = column3(*this, 3);
+
+    Matrix4 result;
+    result.data = {a.x, b.x, c.x, 0.0F,
+                   a.y, b.y, c.y, 0.0F,
+                   a.z, b.z, c.z, 0.0F,
+                   -Vector3::dot(a, t), -Vector3::dot(b, t), -Vector3::dot(c, t), 1.0F};
+    return result;
 }
 
-float Matrix4::at(int row, int column) const noexcept
+Matrix4 Matrix4::normalMatrix() const noexcept
 {
-    return data[static_cast<std::size_t>(column * 4 + row)];
+    float packed[12];
+    normalMatrixScalar(dataPtr(), packed);
+
+    Matrix4 result;
+    for (std::size_t column = 0; column < 3; ++column)
+    {
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            result.data[column * 4 + row] = packed[column * 4 + row];
+        }
+    }
+    return result;
+}
+
+void Matrix4::normalMatrices(const Matrix4* models, float* out, std::size_t count)
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        normalMatricesAVX2(models, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        normalMatricesSSE(models, out, count);
+        return;
+    }
+#endif
+    normalMatricesScalar(models, out, count);
 }
 } // namespace nre
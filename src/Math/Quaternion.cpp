@@ -0,0 +1,475 @@
+#include "Math/Quaternion.h"
+
+#include <cmath>
+
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+// Eberly's series for the slerp weights ("A Fast and Accurate Algorithm for Computing SLERP"):
+// u[i] = 1 / ((i + 1) * (2i + 3)), v[i] = (i + 1) / (2i + 3). Twelve terms with the last one scaled by a
+// fitted correction factor keep the weight error below 7.2e-7 for every cos(theta) in [0, 1] and t in [0, 1].
+constexpr float kLastTermScale = 1.89375F;
+constexpr float kSlerpU[] = {1.0F / (1.0F * 3.0F),
+                             1.0F / (2.0F * 5.0F),
+                             1.0F / (3.0F * 7.0F),
+                             1.0F / (4.0F * 9.0F),
+                             1.0F / (5.0F * 11.0F),
+                             1.0F / (6.0F * 13.0F),
+                             1.0F / (7.0F * 15.0F),
+                             1.0F / (8.0F * 17.0F),
+                             1.0F / (9.0F * 19.0F),
+                             1.0F / (10.0F * 21.0F),
+                             1.0F / (11.0F * 23.0F),
+                             kLastTermScale / (12.0F * 25.0F)};
+constexpr float kSlerpV[] = {1.0F / 3.0F,
+                             2.0F / 5.0F,
+                             3.0F / 7.0F,
+                             4.0F / 9.0F,
+                             5.0F / 11.0F,
+                             6.0F / 13.0F,
+                             7.0F / 15.0F,
+                             8.0F / 17.0F,
+                             9.0F / 19.0F,
+                             10.0F / 21.0F,
+                             11.0F / 23.0F,
+                             kLastTermScale * 12.0F / 25.0F};
+constexpr std::size_t kSlerpTerms = sizeof(kSlerpU) / sizeof(kSlerpU[0]);
+
+float slerpWeight(float t, float cosMinusOne)
+{
+    const float t2 = t * t;
+    float value = 1.0F;
+    for (std::size_t term = kSlerpTerms; term-- > 0;)
+    {
+        value = 1.0F + (kSlerpU[term] * t2 - kSlerpV[term]) * cosMinusOne * value;
+    }
+    return t * value;
+}
+
+void blendScalar(const QuaternionStreams& from,
+                 const QuaternionStreams& to,
+                 const float* t,
+                 const QuaternionOutputStreams& out,
+                 std::size_t begin,
+                 std::size_t end,
+                 bool spherical)
+{
+    for (std::size_t index = begin; index < end; ++index)
+    {
+        const Quaternion a{from.x[index], from.y[index], from.z[index], from.w[index]};
+        Quaternion b{to.x[index], to.y[index], to.z[index], to.w[index]};
+        float cosTheta = Quaternion::dot(a, b);
+        if (cosTheta < 0.0F)
+        {
+            b = Quaternion{-b.x, -b.y, -b.z, -b.w};
+            cosTheta = -cosTheta;
+        }
+
+        const float blend = t[index];
+        float wa = 1.0F - blend;
+        float wb = blend;
+        if (spherical)
+        {
+            wa = slerpWeight(1.0F - blend, cosTheta - 1.0F);
+            wb = slerpWeight(blend, cosTheta - 1.0F);
+        }
+
+        Quaternion result{a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb};
+        if (!spherical)
+        {
+            result = result.normalized();
+        }
+        out.x[index] = result.x;
+        out.y[index] = result.y;
+        out.z[index] = result.z;
+        out.w[index] = result.w;
+    }
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 void blendSSE(const QuaternionStreams& from,
+                               const QuaternionStreams& to,
+                               const float* t,
+                               const QuaternionOutputStreams& out,
+                               std::size_t count,
+                               bool spherical)
+{
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 signBit = _mm_set1_ps(-0.0F);
+
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 ax = _mm_loadu_ps(from.x + index);
+        const __m128 ay = _mm_loadu_ps(from.y + index);
+        const __m128 az = _mm_loadu_ps(from.z + index);
+        const __m128 aw = _mm_loadu_ps(from.w + index);
+        __m128 bx = _mm_loadu_ps(to.x + index);
+        __m128 by = _mm_loadu_ps(to.y + index);
+        __m128 bz = _mm_loadu_ps(to.z + index);
+        __m128 bw = _mm_loadu_ps(to.w + index);
+        const __m128 blend = _mm_loadu_ps(t + index);
+
+        __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                                     _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+        const __m128 flip = _mm_and_ps(cosTheta, signBit);
+        cosTheta = _mm_xor_ps(cosTheta, flip);
+        bx = _mm_xor_ps(bx, flip);
+        by = _mm_xor_ps(by, flip);
+        bz = _mm_xor_ps(bz, flip);
+        bw = _mm_xor_ps(bw, flip);
+
+        __m128 wa = _mm_sub_ps(one, blend);
+        __m128 wb = blend;
+        if (spherical)
+        {
+            const __m128 cosMinusOne = _mm_sub_ps(cosTheta, one);
+            const __m128 a2 = _mm_mul_ps(wa, wa);
+            const __m128 b2 = _mm_mul_ps(wb, wb);
+            __m128 pa = one;
+            __m128 pb = one;
+            for (std::size_t term = kSlerpTerms; term-- > 0;)
+            {
+                const __m128 u = _mm_set1_ps(kSlerpU[term]);
+                const __m128 v = _mm_set1_ps(kSlerpV[term]);
+                pa = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, a2), v), cosMinusOne), pa));
+                pb = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, b2), v), cosMinusOne), pb));
+            }
+            wa = _mm_mul_ps(wa, pa);
+            wb = _mm_mul_ps(wb, pb);
+        }
+
+        __m128 rx = _mm_add_ps(_mm_mul_ps(ax, wa), _mm_mul_ps(bx, wb));
+        __m128 ry = _mm_add_ps(_mm_mul_ps(ay, wa), _mm_mul_ps(by, wb));
+        __m128 rz = _mm_add_ps(_mm_mul_ps(az, wa), _mm_mul_ps(bz, wb));
+        __m128 rw = _mm_add_ps(_mm_mul_ps(aw, wa), _mm_mul_ps(bw, wb));
+        if (!spherical)
+        {
+            const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)),
+                                                    _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw)));
+            const __m128 nonZero = _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps());
+            const __m128 invLength = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(lengthSquared)), nonZero);
+            rx = _mm_mul_ps(rx, invLength);
+            ry = _mm_mul_ps(ry, invLength);
+            rz = _mm_mul_ps(rz, invLength);
+            rw = _mm_or_ps(_mm_mul_ps(rw, invLength), _mm_andnot_ps(nonZero, one));
+        }
+
+        _mm_storeu_ps(out.x + index, rx);
+        _mm_storeu_ps(out.y + index, ry);
+        _mm_storeu_ps(out.z + index, rz);
+        _mm_storeu_ps(out.w + index, rw);
+    }
+
+    blendScalar(from, to, t, out, index, count, spherical);
+}
+
+NRE_TARGET_AVX2 void blendAVX2(const QuaternionStreams& from,
+                               const QuaternionStreams& to,
+                               const float* t,
+                               const QuaternionOutputStreams& out,
+                               std::size_t count,
+                               bool spherical)
+{
+    const __m256 one = _mm256_set1_ps(1.0F);
+    const __m256 signBit = _mm256_set1_ps(-0.0F);
+
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        const __m256 ax = _mm256_loadu_ps(from.x + index);
+        const __m256 ay = _mm256_loadu_ps(from.y + index);
+        const __m256 az = _mm256_loadu_ps(from.z + index);
+        const __m256 aw = _mm256_loadu_ps(from.w + index);
+        __m256 bx = _mm256_loadu_ps(to.x + index);
+        __m256 by = _mm256_loadu_ps(to.y + index);
+        __m256 bz = _mm256_loadu_ps(to.z + index);
+        __m256 bw = _mm256_loadu_ps(to.w + index);
+        const __m256 blend = _mm256_loadu_ps(t + index);
+
+        __m256 cosTheta = _mm256_mul_ps(ax, bx);
+        cosTheta = _mm256_fmadd_ps(ay, by, cosTheta);
+        cosTheta = _mm256_fmadd_ps(az, bz, cosTheta);
+        cosTheta = _mm256_fmadd_ps(aw, bw, cosTheta);
+        const __m256 flip = _mm256_and_ps(cosTheta, signBit);
+        cosTheta = _mm256_xor_ps(cosTheta, flip);
+        bx = _mm256_xor_ps(bx, flip);
+        by = _mm256_xor_ps(by, flip);
+        bz = _mm256_xor_ps(bz, flip);
+        bw = _mm256_xor_ps(bw, flip);
+
+        __m256 wa = _mm256_sub_ps(one, blend);
+        __m256 wb = blend;
+        if (spherical)
+        {
+            const __m256 cosMinusOne = _mm256_sub_ps(cosTheta, one);
+            const __m256 a2 = _mm256_mul_ps(wa, wa);
+            const __m256 b2 = _mm256_mul_ps(wb, wb);
+            __m256 pa = one;
+            __m256 pb = one;
+            for (std::size_t term = kSlerpTerms; term-- > 0;)
+            {
+                const __m256 u = _mm256_set1_ps(kSlerpU[term]);
+                const __m256 v = _mm256_set1_ps(kSlerpV[term]);
+                pa = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_fmsub_ps(u, a2, v), cosMinusOne), pa, one);
+                pb = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_fmsub_ps(u, b2, v), cosMinusOne), pb, one);
+            }
+            wa = _mm256_mul_ps(wa, pa);
+            wb = _mm256_mul_ps(wb, pb);
+        }
+
+        __m256 rx = _mm256_fmadd_ps(bx, wb, _mm256_mul_ps(ax, wa));
+        __m256 ry = _mm256_fmadd_ps(by, wb, _mm256_mul_ps(ay, wa));
+        __m256 rz = _mm256_fmadd_ps(bz, wb, _mm256_mul_ps(az, wa));
+        __m256 rw = _mm256_fmadd_ps(bw, wb, _mm256_mul_ps(aw, wa));
+        if (!spherical)
+        {
+            __m256 lengthSquared = _mm256_mul_ps(rx, rx);
+            lengthSquared = _mm256_fmadd_ps(ry, ry, lengthSquared);
+            lengthSquared = _mm256_fmadd_ps(rz, rz, lengthSquared);
+            lengthSquared = _mm256_fmadd_ps(rw, rw, lengthSquared);
+            const __m256 nonZero = _mm256_cmp_ps(lengthSquared, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const __m256 invLength = _mm256_and_ps(_mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared)), nonZero);
+            rx = _mm256_mul_ps(rx, invLength);
+            ry = _mm256_mul_ps(ry, invLength);
+            rz = _mm256_mul_ps(rz, invLength);
+            rw = _mm256_or_ps(_mm256_mul_ps(rw, invLength), _mm256_andnot_ps(nonZero, one));
+        }
+
+        _mm256_storeu_ps(out.x + index, rx);
+        _mm256_storeu_ps(out.y + index, ry);
+        _mm256_storeu_ps(out.z + index, rz);
+        _mm256_storeu_ps(out.w + index, rw);
+    }
+
+    blendScalar(from, to, t, out, index, count, spherical);
+}
+#endif
+
+void blendBatch(const QuaternionStreams& from,
+                const QuaternionStreams& to,
+                const float* t,
+                const QuaternionOutputStreams& out,
+                std::size_t count,
+                bool spherical)
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        blendAVX2(from, to, t, out, count, spherical);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        blendSSE(from, to, t, out, count, spherical);
+        return;
+    }
+#endif
+    blendScalar(from, to, t, out, 0, count, spherical);
+}
+} // namespace
+
+Quaternion Quaternion::identity() noexcept
+{
+    return {};
+}
+
+Quaternion Quaternion::fromAxisAngle(const Vector3& axis, float radians) noexcept
+{
+    const Vector3 unitAxis = axis.normalized();
+    const float halfAngle = radians * 0.5F;
+    const float s = std::sin(halfAngle);
+    return Quaternion{unitAxis.x * s, unitAxis.y * s, unitAxis.z * s, std::cos(halfAngle)};
+}
+
+Quaternion Quaternion::fromMatrix(const Matrix4& matrix) noexcept
+{
+    Vector3 axisX{matrix.at(0, 0), matrix.at(1, 0), matrix.at(2, 0)};
+    Vector3 axisY{matrix.at(0, 1), matrix.at(1, 1), matrix.at(2, 1)};
+    Vector3 axisZ{matrix.at(0, 2), matrix.at(1, 2), matrix.at(2, 2)};
+    axisX = axisX.normalized();
+    axisY = axisY.normalized();
+    axisZ = axisZ.normalized();
+
+    const float m00 = axisX.x;
+    const float m10 = axisX.y;
+    const float m20 = axisX.z;
+    const float m01 = axisY.x;
+    const float m11 = axisY.y;
+    const float m21 = axisY.z;
+    const float m02 = axisZ.x;
+    const float m12 = axisZ.y;
+    const float m22 = axisZ.z;
+
+    Quaternion result;
+    const float trace = m00 + m11 + m22;
+    if (trace > 0.0F)
+    {
+        const float s = std::sqrt(trace + 1.0F) * 2.0F;
+        result = Quaternion{(m21 - m12) / s, (m02 - m20) / s, (m10 - m01) / s, 0.25F * s};
+    }
+    else if (m00 > m11 && m00 > m22)
+    {
+        const float s = std::sqrt(1.0F + m00 - m11 - m22) * 2.0F;
+        result = Quaternion{0.25F * s, (m01 + m10) / s, (m02 + m20) / s, (m21 - m12) / s};
+    }
+    else if (m11 > m22)
+    {
+        const float s = std::sqrt(1.0F + m11 - m00 - m22) * 2.0F;
+        result = Quaternion{(m01 + m10) / s, 0.25F * s, (m12 + m21) / s, (m02 - m20) / s};
+    }
+    else
+    {
+        const float s = std::sqrt(1.0F + m22 - m00 - m11) * 2.0F;
+        result = Quaternion{(m02 + m20) / s, (m12 + m21) / s, 0.25F * s, (m10 - m01) / s};
+    }
+    return result.normalized();
+}
+
+Quaternion Quaternion::operator*(const Quaternion& rhs) const noexcept
+{
+    return Quaternion{w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+                      w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+                      w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w,
+                      w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z};
+}
+
+Quaternion& Quaternion::operator*=(const Quaternion& rhs) noexcept
+{
+    *this = *this * rhs;
+    return *this;
+}
+
+float Quaternion::length() const noexcept
+{
+    return std::sqrt(lengthSquared());
+}
+
+float Quaternion::lengthSquared() const noexcept
+{
+    return x * x + y * y + z * z + w * w;
+}
+
+Quaternion Quaternion::normalized() const noexcept
+{
+    const float len = length();
+    if (len > 0.0F)
+    {
+        const float inv = 1.0F / len;
+        return Quaternion{x * inv, y * inv, z * inv, w * inv};
+    }
+    return Quaternion{};
+}
+
+Quaternion Quaternion::conjugate() const noexcept
+{
+    return Quaternion{-x, -y, -z, w};
+}
+
+Quaternion Quaternion::inverse() const noexcept
+{
+    const float lenSq = lengthSquared();
+    if (lenSq > 0.0F)
+    {
+        const float inv = 1.0F / lenSq;
+        return Quaternion{-x * inv, -y * inv, -z * inv, w * inv};
+    }
+    return Quaternion{};
+}
+
+Vector3 Quaternion::rotate(const Vector3& vector) const noexcept
+{
+    const Vector3 axis{x, y, z};
+    const Vector3 t = Vector3::cross(axis, vector) * 2.0F;
+    return vector + t * w + Vector3::cross(axis, t);
+}
+
+Matrix4 Quaternion::toMatrix() const noexcept
+{
+    const float xx = x * x;
+    const float yy = y * y;
+    const float zz = z * z;
+    const float xy = x * y;
+    const float xz = x * z;
+    const float yz = y * z;
+    const float wx = w * x;
+    const float wy = w * y;
+    const float wz = w * z;
+
+    Matrix4 result = Matrix4::identity();
+    result.data[0] = 1.0F - 2.0F * (yy + zz);
+    result.data[1] = 2.0F * (xy + wz);
+    result.data[2] = 2.0F * (xz - wy);
+
+    result.data[4] = 2.0F * (xy - wz);
+    result.data[5] = 1.0F - 2.0F * (xx + zz);
+    result.data[6] = 2.0F * (yz + wx);
+
+    result.data[8] = 2.0F * (xz + wy);
+    result.data[9] = 2.0F * (yz - wx);
+    result.data[10] = 1.0F - 2.0F * (xx + yy);
+    return result;
+}
+
+float Quaternion::dot(const Quaternion& lhs, const Quaternion& rhs) noexcept
+{
+    return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+}
+
+Quaternion Quaternion::nlerp(const Quaternion& from, const Quaternion& to, float t) noexcept
+{
+    const float sign = dot(from, to) < 0.0F ? -1.0F : 1.0F;
+    const float wa = 1.0F - t;
+    const float wb = t * sign;
+    return Quaternion{from.x * wa + to.x * wb, from.y * wa + to.y * wb, from.z * wa + to.z * wb,
+                      from.w * wa + to.w * wb}
+        .normalized();
+}
+
+Quaternion Quaternion::slerp(const Quaternion& from, const Quaternion& to, float t) noexcept
+{
+    float cosTheta = dot(from, to);
+    float sign = 1.0F;
+    if (cosTheta < 0.0F)
+    {
+        cosTheta = -cosTheta;
+        sign = -1.0F;
+    }
+
+    constexpr float kLinearThreshold = 0.9995F;
+    if (cosTheta > kLinearThreshold)
+    {
+        return nlerp(from, to, t);
+    }
+
+    const float theta = std::acos(cosTheta);
+    const float invSinTheta = 1.0F / std::sin(theta);
+    const float wa = std::sin((1.0F - t) * theta) * invSinTheta;
+    const float wb = std::sin(t * theta) * invSinTheta * sign;
+    return Quaternion{from.x * wa + to.x * wb, from.y * wa + to.y * wb, from.z * wa + to.z * wb,
+                      from.w * wa + to.w * wb};
+}
+
+void Quaternion::nlerpBatch(const QuaternionStreams& from,
+                            const QuaternionStreams& to,
+                            const float* t,
+                            const QuaternionOutputStreams& out,
+                            std::size_t count)
+{
+    blendBatch(from, to, t, out, count, false);
+}
+
+void Quaternion::slerpBatch(const QuaternionStreams& from,
+                            const QuaternionStreams& to,
+                            const float* t,
+                            const QuaternionOutputStreams& out,
+                            std::size_t count)
+{
+    blendBatch(from, to, t, out, count, true);
+}
+} // namespace nre
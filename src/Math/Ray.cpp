@@ -0,0 +1,705 @@
+#include "Math/Ray.h"
+
+#include <cmath>
+#include <limits>
+
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+constexpr float kDeterminantEpsilon = 1.0e-12F;
+constexpr std::size_t kPacketWidth = 8;
+
+// Same operand order as minps/maxps so the scalar path agrees with SIMD when a slab produces NaN.
+inline float minf(float a, float b)
+{
+    return a < b ? a : b;
+}
+
+inline float maxf(float a, float b)
+{
+    return a > b ? a : b;
+}
+
+float safeInverse(float value)
+{
+    return value != 0.0F ? 1.0F / value : std::copysign(std::numeric_limits<float>::infinity(), value);
+}
+
+bool mollerTrumbore(const Vector3& origin,
+                    const Vector3& direction,
+                    const Vector3& v0,
+                    const Vector3& edge1,
+                    const Vector3& edge2,
+                    float tMax,
+                    RayHit& hit)
+{
+    const Vector3 p = Vector3::cross(direction, edge2);
+    const float det = Vector3::dot(edge1, p);
+    if (std::fabs(det) <= kDeterminantEpsilon)
+    {
+        return false;
+    }
+    const float invDet = 1.0F / det;
+
+    const Vector3 s = origin - v0;
+    const float u = Vector3::dot(s, p) * invDet;
+    const Vector3 q = Vector3::cross(s, edge1);
+    const float v = Vector3::dot(direction, q) * invDet;
+    const float t = Vector3::dot(edge2, q) * invDet;
+    if (!(u >= 0.0F && v >= 0.0F && u + v <= 1.0F && t > 0.0F && t <= tMax))
+    {
+        return false;
+    }
+
+    hit.t = t;
+    hit.u = u;
+    hit.v = v;
+    return true;
+}
+
+bool slab(const Vector3& origin,
+          const Vector3& inverseDirection,
+          const Vector3& min,
+          const Vector3& max,
+          float tMax,
+          float& tEntry)
+{
+    // Near/far planes are picked by direction sign rather than by min/max of the two hits, so
+    // inverted (empty) boxes never report a hit.
+    float tNear = 0.0F;
+    float tFar = tMax;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        const bool positive = inverseDirection[axis] >= 0.0F;
+        const float nearPlane = positive ? min[axis] : max[axis];
+        const float farPlane = positive ? max[axis] : min[axis];
+        tNear = maxf((nearPlane - origin[axis]) * inverseDirection[axis], tNear);
+        tFar = minf((farPlane - origin[axis]) * inverseDirection[axis], tFar);
+    }
+    tEntry = tNear;
+    return tNear <= tFar;
+}
+
+Vector3 lane3(const float* x, const float* y, const float* z, std::size_t lane)
+{
+    return {x[lane], y[lane], z[lane]};
+}
+
+// Box streams reordered so that "near" is the plane a ray with this direction enters first.
+struct OrderedBoxStreams
+{
+    const float* nearX;
+    const float* nearY;
+    const float* nearZ;
+    const float* farX;
+    const float* farY;
+    const float* farZ;
+};
+
+OrderedBoxStreams orderBoxStreams(const Ray& ray, const BoxPacket8& boxes)
+{
+    const Vector3& inv = ray.inverseDirection();
+    return {inv.x >= 0.0F ? boxes.minX : boxes.maxX,
+            inv.y >= 0.0F ? boxes.minY : boxes.maxY,
+            inv.z >= 0.0F ? boxes.minZ : boxes.maxZ,
+            inv.x >= 0.0F ? boxes.maxX : boxes.minX,
+            inv.y >= 0.0F ? boxes.maxY : boxes.minY,
+            inv.z >= 0.0F ? boxes.maxZ : boxes.minZ};
+}
+
+std::uint32_t trianglesScalar(const Ray& ray, const TrianglePacket8& tri, float tMax, HitPacket8& hits)
+{
+    std::uint32_t mask = 0;
+    for (std::size_t lane = 0; lane < kPacketWidth; ++lane)
+    {
+        RayHit hit;
+        if (mollerTrumbore(ray.origin(),
+                           ray.direction(),
+                           lane3(tri.v0X, tri.v0Y, tri.v0Z, lane),
+                           lane3(tri.edge1X, tri.edge1Y, tri.edge1Z, lane),
+                           lane3(tri.edge2X, tri.edge2Y, tri.edge2Z, lane),
+                           tMax,
+                           hit))
+        {
+            hits.t[lane] = hit.t;
+            hits.u[lane] = hit.u;
+            hits.v[lane] = hit.v;
+            mask |= 1U << lane;
+        }
+    }
+    return mask;
+}
+
+std::uint32_t boxesScalar(const Ray& ray, const BoxPacket8& boxes, float tMax, float* tEntry)
+{
+    std::uint32_t mask = 0;
+    for (std::size_t lane = 0; lane < kPacketWidth; ++lane)
+    {
+        if (slab(ray.origin(),
+                 ray.inverseDirection(),
+                 lane3(boxes.minX, boxes.minY, boxes.minZ, lane),
+                 lane3(boxes.maxX, boxes.maxY, boxes.maxZ, lane),
+                 tMax,
+                 tEntry[lane]))
+        {
+            mask |= 1U << lane;
+        }
+    }
+    return mask;
+}
+
+std::uint32_t rayTriangleScalar(const RayPacket8& rays,
+                                const Vector3& v0,
+                                const Vector3& edge1,
+                                const Vector3& edge2,
+                                const float* tMax,
+                                HitPacket8& hits)
+{
+    std::uint32_t mask = 0;
+    for (std::size_t lane = 0; lane < kPacketWidth; ++lane)
+    {
+        RayHit hit;
+        if (mollerTrumbore(lane3(rays.originX, rays.originY, rays.originZ, lane),
+                           lane3(rays.directionX, rays.directionY, rays.directionZ, lane),
+                           v0,
+                           edge1,
+                           edge2,
+                           tMax[lane],
+                           hit))
+        {
+            hits.t[lane] = hit.t;
+            hits.u[lane] = hit.u;
+            hits.v[lane] = hit.v;
+            mask |= 1U << lane;
+        }
+    }
+    return mask;
+}
+
+std::uint32_t rayBoxScalar(const RayPacket8& rays, const BoundingBox& box, const float* tMax, float* tEntry)
+{
+    std::uint32_t mask = 0;
+    for (std::size_t lane = 0; lane < kPacketWidth; ++lane)
+    {
+        if (slab(lane3(rays.originX, rays.originY, rays.originZ, lane),
+                 lane3(rays.inverseDirectionX, rays.inverseDirectionY, rays.inverseDirectionZ, lane),
+                 box.min,
+                 box.max,
+                 tMax[lane],
+                 tEntry[lane]))
+        {
+            mask |= 1U << lane;
+        }
+    }
+    return mask;
+}
+
+#if defined(NRE_SIMD_X86)
+// Both packet shapes share one kernel: whichever side is uniform is broadcast into the registers.
+struct Vec3x4
+{
+    __m128 x;
+    __m128 y;
+    __m128 z;
+};
+
+struct Vec3x8
+{
+    __m256 x;
+    __m256 y;
+    __m256 z;
+};
+
+NRE_TARGET_SSE41 inline Vec3x4 load3x4(const float* x, const float* y, const float* z)
+{
+    return {_mm_load_ps(x), _mm_load_ps(y), _mm_load_ps(z)};
+}
+
+NRE_TARGET_SSE41 inline Vec3x4 broadcast3x4(const Vector3& value)
+{
+    return {_mm_set1_ps(value.x), _mm_set1_ps(value.y), _mm_set1_ps(value.z)};
+}
+
+NRE_TARGET_SSE41 inline Vec3x4 cross3x4(const Vec3x4& a, const Vec3x4& b)
+{
+    return {_mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+            _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+            _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x))};
+}
+
+NRE_TARGET_SSE41 inline __m128 dot3x4(const Vec3x4& a, const Vec3x4& b)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+}
+
+NRE_TARGET_SSE41 inline unsigned int mollerTrumbore4(const Vec3x4& origin,
+                                              const Vec3x4& direction,
+                                              const Vec3x4& v0,
+                                              const Vec3x4& edge1,
+                                              const Vec3x4& edge2,
+                                              __m128 tMax,
+                                              float* t,
+                                              float* u,
+                                              float* v)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    const Vec3x4 p = cross3x4(direction, edge2);
+    const __m128 det = dot3x4(edge1, p);
+    const __m128 invDet = _mm_div_ps(one, det);
+
+    const Vec3x4 s{_mm_sub_ps(origin.x, v0.x), _mm_sub_ps(origin.y, v0.y), _mm_sub_ps(origin.z, v0.z)};
+    const __m128 uu = _mm_mul_ps(dot3x4(s, p), invDet);
+    const Vec3x4 q = cross3x4(s, edge1);
+    const __m128 vv = _mm_mul_ps(dot3x4(direction, q), invDet);
+    const __m128 tt = _mm_mul_ps(dot3x4(edge2, q), invDet);
+
+    __m128 mask = _mm_cmpgt_ps(_mm_and_ps(det, absMask), _mm_set1_ps(kDeterminantEpsilon));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(uu, zero));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(vv, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(uu, vv), one));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(tt, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(tt, tMax));
+
+    _mm_store_ps(t, tt);
+    _mm_store_ps(u, uu);
+    _mm_store_ps(v, vv);
+    return static_cast<unsigned int>(_mm_movemask_ps(mask));
+}
+
+// nearPlane/farPlane are the per-axis box planes already ordered by the sign of the direction.
+NRE_TARGET_SSE41 inline unsigned int slab4(const Vec3x4& origin,
+                                    const Vec3x4& inverseDirection,
+                                    const Vec3x4& nearPlane,
+                                    const Vec3x4& farPlane,
+                                    __m128 tMax,
+                                    float* tEntry)
+{
+    __m128 tNear = _mm_setzero_ps();
+    __m128 tFar = tMax;
+    tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearPlane.x, origin.x), inverseDirection.x), tNear);
+    tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farPlane.x, origin.x), inverseDirection.x), tFar);
+    tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearPlane.y, origin.y), inverseDirection.y), tNear);
+    tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farPlane.y, origin.y), inverseDirection.y), tFar);
+    tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearPlane.z, origin.z), inverseDirection.z), tNear);
+    tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farPlane.z, origin.z), inverseDirection.z), tFar);
+
+    _mm_storeu_ps(tEntry, tNear);
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)));
+}
+
+NRE_TARGET_SSE41 inline __m128 selectPlane(__m128 positive, __m128 ifPositive, __m128 ifNegative)
+{
+    return _mm_blendv_ps(ifNegative, ifPositive, positive);
+}
+
+NRE_TARGET_SSE41 std::uint32_t trianglesSSE(const Ray& ray, const TrianglePacket8& tri, float tMax, HitPacket8& hits)
+{
+    const Vec3x4 origin = broadcast3x4(ray.origin());
+    const Vec3x4 direction = broadcast3x4(ray.direction());
+    std::uint32_t mask = 0;
+    for (std::size_t half = 0; half < kPacketWidth; half += 4)
+    {
+        mask |= mollerTrumbore4(origin,
+                                direction,
+                                load3x4(tri.v0X + half, tri.v0Y + half, tri.v0Z + half),
+                                load3x4(tri.edge1X + half, tri.edge1Y + half, tri.edge1Z + half),
+                                load3x4(tri.edge2X + half, tri.edge2Y + half, tri.edge2Z + half),
+                                _mm_set1_ps(tMax),
+                                hits.t + half,
+                                hits.u + half,
+                                hits.v + half)
+                << half;
+    }
+    return mask;
+}
+
+NRE_TARGET_SSE41 std::uint32_t boxesSSE(const Ray& ray, const BoxPacket8& boxes, float tMax, float* tEntry)
+{
+    const Vec3x4 origin = broadcast3x4(ray.origin());
+    const Vec3x4 inverseDirection = broadcast3x4(ray.inverseDirection());
+    const OrderedBoxStreams planes = orderBoxStreams(ray, boxes);
+    std::uint32_t mask = 0;
+    for (std::size_t half = 0; half < kPacketWidth; half += 4)
+    {
+        mask |= slab4(origin,
+                      inverseDirection,
+                      load3x4(planes.nearX + half, planes.nearY + half, planes.nearZ + half),
+                      load3x4(planes.farX + half, planes.farY + half, planes.farZ + half),
+                      _mm_set1_ps(tMax),
+                      tEntry + half)
+                << half;
+    }
+    return mask;
+}
+
+NRE_TARGET_SSE41 std::uint32_t rayTriangleSSE(const RayPacket8& rays,
+                                              const Vector3& v0,
+                                              const Vector3& edge1,
+                                              const Vector3& edge2,
+                                              const float* tMax,
+                                              HitPacket8& hits)
+{
+    const Vec3x4 a = broadcast3x4(v0);
+    const Vec3x4 e1 = broadcast3x4(edge1);
+    const Vec3x4 e2 = broadcast3x4(edge2);
+    std::uint32_t mask = 0;
+    for (std::size_t half = 0; half < kPacketWidth; half += 4)
+    {
+        mask |= mollerTrumbore4(load3x4(rays.originX + half, rays.originY + half, rays.originZ + half),
+                                load3x4(rays.directionX + half, rays.directionY + half, rays.directionZ + half),
+                                a,
+                                e1,
+                                e2,
+                                _mm_loadu_ps(tMax + half),
+                                hits.t + half,
+                                hits.u + half,
+                                hits.v + half)
+                << half;
+    }
+    return mask;
+}
+
+NRE_TARGET_SSE41 std::uint32_t rayBoxSSE(const RayPacket8& rays,
+                                         const BoundingBox& box,
+                                         const float* tMax,
+                                         float* tEntry)
+{
+    const Vec3x4 min = broadcast3x4(box.min);
+    const Vec3x4 max = broadcast3x4(box.max);
+    const __m128 zero = _mm_setzero_ps();
+    std::uint32_t mask = 0;
+    for (std::size_t half = 0; half < kPacketWidth; half += 4)
+    {
+        const Vec3x4 inverseDirection =
+            load3x4(rays.inverseDirectionX + half, rays.inverseDirectionY + half, rays.inverseDirectionZ + half);
+        const __m128 positiveX = _mm_cmpge_ps(inverseDirection.x, zero);
+        const __m128 positiveY = _mm_cmpge_ps(inverseDirection.y, zero);
+        const __m128 positiveZ = _mm_cmpge_ps(inverseDirection.z, zero);
+        const Vec3x4 nearPlane{selectPlane(positiveX, min.x, max.x),
+                               selectPlane(positiveY, min.y, max.y),
+                               selectPlane(positiveZ, min.z, max.z)};
+        const Vec3x4 farPlane{selectPlane(positiveX, max.x, min.x),
+                              selectPlane(positiveY, max.y, min.y),
+                              selectPlane(positiveZ, max.z, min.z)};
+        mask |= slab4(load3x4(rays.originX + half, rays.originY + half, rays.originZ + half),
+                      inverseDirection,
+                      nearPlane,
+                      farPlane,
+                      _mm_loadu_ps(tMax + half),
+                      tEntry + half)
+                << half;
+    }
+    return mask;
+}
+
+NRE_TARGET_AVX2 inline Vec3x8 load3x8(const float* x, const float* y, const float* z)
+{
+    return {_mm256_load_ps(x), _mm256_load_ps(y), _mm256_load_ps(z)};
+}
+
+NRE_TARGET_AVX2 inline Vec3x8 broadcast3x8(const Vector3& value)
+{
+    return {_mm256_set1_ps(value.x), _mm256_set1_ps(value.y), _mm256_set1_ps(value.z)};
+}
+
+NRE_TARGET_AVX2 inline Vec3x8 cross3x8(const Vec3x8& a, const Vec3x8& b)
+{
+    return {_mm256_fmsub_ps(a.y, b.z, _mm256_mul_ps(a.z, b.y)),
+            _mm256_fmsub_ps(a.z, b.x, _mm256_mul_ps(a.x, b.z)),
+            _mm256_fmsub_ps(a.x, b.y, _mm256_mul_ps(a.y, b.x))};
+}
+
+NRE_TARGET_AVX2 inline __m256 dot3x8(const Vec3x8& a, const Vec3x8& b)
+{
+    return _mm256_fmadd_ps(a.z, b.z, _mm256_fmadd_ps(a.y, b.y, _mm256_mul_ps(a.x, b.x)));
+}
+
+NRE_TARGET_AVX2 inline std::uint32_t mollerTrumbore8(const Vec3x8& origin,
+                                              const Vec3x8& direction,
+                                              const Vec3x8& v0,
+                                              const Vec3x8& edge1,
+                                              const Vec3x8& edge2,
+                                              __m256 tMax,
+                                              HitPacket8& hits)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0F);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    const Vec3x8 p = cross3x8(direction, edge2);
+    const __m256 det = dot3x8(edge1, p);
+    const __m256 invDet = _mm256_div_ps(one, det);
+
+    const Vec3x8 s{_mm256_sub_ps(origin.x, v0.x), _mm256_sub_ps(origin.y, v0.y), _mm256_sub_ps(origin.z, v0.z)};
+    const __m256 u = _mm256_mul_ps(dot3x8(s, p), invDet);
+    const Vec3x8 q = cross3x8(s, edge1);
+    const __m256 v = _mm256_mul_ps(dot3x8(direction, q), invDet);
+    const __m256 t = _mm256_mul_ps(dot3x8(edge2, q), invDet);
+
+    __m256 mask = _mm256_cmp_ps(_mm256_and_ps(det, absMask), _mm256_set1_ps(kDeterminantEpsilon), _CMP_GT_OQ);
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, tMax, _CMP_LE_OQ));
+
+    _mm256_store_ps(hits.t, t);
+    _mm256_store_ps(hits.u, u);
+    _mm256_store_ps(hits.v, v);
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(mask));
+}
+
+NRE_TARGET_AVX2 inline std::uint32_t slab8(const Vec3x8& origin,
+                                    const Vec3x8& inverseDirection,
+                                    const Vec3x8& nearPlane,
+                                    const Vec3x8& farPlane,
+                                    __m256 tMax,
+                                    float* tEntry)
+{
+    __m256 tNear = _mm256_setzero_ps();
+    __m256 tFar = tMax;
+    tNear = _mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(nearPlane.x, origin.x), inverseDirection.x), tNear);
+    tFar = _mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(farPlane.x, origin.x), inverseDirection.x), tFar);
+    tNear = _mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(nearPlane.y, origin.y), inverseDirection.y), tNear);
+    tFar = _mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(farPlane.y, origin.y), inverseDirection.y), tFar);
+    tNear = _mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(nearPlane.z, origin.z), inverseDirection.z), tNear);
+    tFar = _mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(farPlane.z, origin.z), inverseDirection.z), tFar);
+
+    _mm256_storeu_ps(tEntry, tNear);
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ)));
+}
+
+NRE_TARGET_AVX2 inline __m256 selectPlane8(__m256 positive, __m256 ifPositive, __m256 ifNegative)
+{
+    return _mm256_blendv_ps(ifNegative, ifPositive, positive);
+}
+
+NRE_TARGET_AVX2 std::uint32_t trianglesAVX2(const Ray& ray, const TrianglePacket8& tri, float tMax, HitPacket8& hits)
+{
+    return mollerTrumbore8(broadcast3x8(ray.origin()),
+                           broadcast3x8(ray.direction()),
+                           load3x8(tri.v0X, tri.v0Y, tri.v0Z),
+                           load3x8(tri.edge1X, tri.edge1Y, tri.edge1Z),
+                           load3x8(tri.edge2X, tri.edge2Y, tri.edge2Z),
+                           _mm256_set1_ps(tMax),
+                           hits);
+}
+
+NRE_TARGET_AVX2 std::uint32_t boxesAVX2(const Ray& ray, const BoxPacket8& boxes, float tMax, float* tEntry)
+{
+    const OrderedBoxStreams planes = orderBoxStreams(ray, boxes);
+    return slab8(broadcast3x8(ray.origin()),
+                 broadcast3x8(ray.inverseDirection()),
+                 load3x8(planes.nearX, planes.nearY, planes.nearZ),
+                 load3x8(planes.farX, planes.farY, planes.farZ),
+                 _mm256_set1_ps(tMax),
+                 tEntry);
+}
+
+NRE_TARGET_AVX2 std::uint32_t rayTriangleAVX2(const RayPacket8& rays,
+                                              const Vector3& v0,
+                                              const Vector3& edge1,
+                                              const Vector3& edge2,
+                                              const float* tMax,
+                                              HitPacket8& hits)
+{
+    return mollerTrumbore8(load3x8(rays.originX, rays.originY, rays.originZ),
+                           load3x8(rays.directionX, rays.directionY, rays.directionZ),
+                           broadcast3x8(v0),
+                           broadcast3x8(edge1),
+                           broadcast3x8(edge2),
+                           _mm256_loadu_ps(tMax),
+                           hits);
+}
+
+NRE_TARGET_AVX2 std::uint32_t rayBoxAVX2(const RayPacket8& rays,
+                                         const BoundingBox& box,
+                                         const float* tMax,
+                                         float* tEntry)
+{
+    const Vec3x8 min = broadcast3x8(box.min);
+    const Vec3x8 max = broadcast3x8(box.max);
+    const __m256 zero = _mm256_setzero_ps();
+    const Vec3x8 inverseDirection =
+        load3x8(rays.inverseDirectionX, rays.inverseDirectionY, rays.inverseDirectionZ);
+    const __m256 positiveX = _mm256_cmp_ps(inverseDirection.x, zero, _CMP_GE_OQ);
+    const __m256 positiveY = _mm256_cmp_ps(inverseDirection.y, zero, _CMP_GE_OQ);
+    const __m256 positiveZ = _mm256_cmp_ps(inverseDirection.z, zero, _CMP_GE_OQ);
+    const Vec3x8 nearPlane{selectPlane8(positiveX, min.x, max.x),
+                           selectPlane8(positiveY, min.y, max.y),
+                           selectPlane8(positiveZ, min.z, max.z)};
+    const Vec3x8 farPlane{selectPlane8(positiveX, max.x, min.x),
+                          selectPlane8(positiveY, max.y, min.y),
+                          selectPlane8(positiveZ, max.z, min.z)};
+    return slab8(load3x8(rays.originX, rays.originY, rays.originZ),
+                 inverseDirection,
+                 nearPlane,
+                 farPlane,
+                 _mm256_loadu_ps(tMax),
+                 tEntry);
+}
+#endif
+} // namespace
+
+Ray::Ray(const Vector3& origin, const Vector3& direction) noexcept : origin_(origin)
+{
+    setDirection(direction);
+}
+
+void Ray::setDirection(const Vector3& direction) noexcept
+{
+    direction_ = direction;
+    inverseDirection_ = {safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z)};
+}
+
+void TrianglePacket8::set(std::size_t lane, const Vector3& v0, const Vector3& v1, const Vector3& v2) noexcept
+{
+    const Vector3 edge1 = v1 - v0;
+    const Vector3 edge2 = v2 - v0;
+    v0X[lane] = v0.x;
+    v0Y[lane] = v0.y;
+    v0Z[lane] = v0.z;
+    edge1X[lane] = edge1.x;
+    edge1Y[lane] = edge1.y;
+    edge1Z[lane] = edge1.z;
+    edge2X[lane] = edge2.x;
+    edge2Y[lane] = edge2.y;
+    edge2Z[lane] = edge2.z;
+}
+
+BoxPacket8::BoxPacket8() noexcept
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    for (std::size_t lane = 0; lane < kPacketWidth; ++lane)
+    {
+        minX[lane] = inf;
+        minY[lane] = inf;
+        minZ[lane] = inf;
+        maxX[lane] = -inf;
+        maxY[lane] = -inf;
+        maxZ[lane] = -inf;
+    }
+}
+
+void BoxPacket8::set(std::size_t lane, const BoundingBox& box) noexcept
+{
+    minX[lane] = box.min.x;
+    minY[lane] = box.min.y;
+    minZ[lane] = box.min.z;
+    maxX[lane] = box.max.x;
+    maxY[lane] = box.max.y;
+    maxZ[lane] = box.max.z;
+}
+
+void RayPacket8::set(std::size_t lane, const Ray& ray) noexcept
+{
+    originX[lane] = ray.origin().x;
+    originY[lane] = ray.origin().y;
+    originZ[lane] = ray.origin().z;
+    directionX[lane] = ray.direction().x;
+    directionY[lane] = ray.direction().y;
+    directionZ[lane] = ray.direction().z;
+    inverseDirectionX[lane] = ray.inverseDirection().x;
+    inverseDirectionY[lane] = ray.inverseDirection().y;
+    inverseDirectionZ[lane] = ray.inverseDirection().z;
+}
+
+bool RayMath::intersectTriangle(const Ray& ray,
+                                const Vector3& v0,
+                                const Vector3& v1,
+                                const Vector3& v2,
+                                float tMax,
+                                RayHit& hit) noexcept
+{
+    return mollerTrumbore(ray.origin(), ray.direction(), v0, v1 - v0, v2 - v0, tMax, hit);
+}
+
+bool RayMath::intersectBox(const Ray& ray, const BoundingBox& box, float tMax, float& tEntry) noexcept
+{
+    return slab(ray.origin(), ray.inverseDirection(), box.min, box.max, tMax, tEntry);
+}
+
+std::uint32_t RayMath::intersectTriangles8(const Ray& ray,
+                                           const TrianglePacket8& triangles,
+                                           float tMax,
+                                           HitPacket8& hits) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return trianglesAVX2(ray, triangles, tMax, hits);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return trianglesSSE(ray, triangles, tMax, hits);
+    }
+#endif
+    return trianglesScalar(ray, triangles, tMax, hits);
+}
+
+std::uint32_t RayMath::intersectBoxes8(const Ray& ray, const BoxPacket8& boxes, float tMax, float* tEntry) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return boxesAVX2(ray, boxes, tMax, tEntry);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return boxesSSE(ray, boxes, tMax, tEntry);
+    }
+#endif
+    return boxesScalar(ray, boxes, tMax, tEntry);
+}
+
+std::uint32_t RayMath::intersectTriangle8(const RayPacket8& rays,
+                                          const Vector3& v0,
+                                          const Vector3& v1,
+                                          const Vector3& v2,
+                                          const float* tMax,
+                                          HitPacket8& hits) noexcept
+{
+    const Vector3 edge1 = v1 - v0;
+    const Vector3 edge2 = v2 - v0;
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return rayTriangleAVX2(rays, v0, edge1, edge2, tMax, hits);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return rayTriangleSSE(rays, v0, edge1, edge2, tMax, hits);
+    }
+#endif
+    return rayTriangleScalar(rays, v0, edge1, edge2, tMax, hits);
+}
+
+std::uint32_t RayMath::intersectBox8(const RayPacket8& rays,
+                                     const BoundingBox& box,
+                                     const float* tMax,
+                                     float* tEntry) noexcept
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return rayBoxAVX2(rays, box, tMax, tEntry);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return rayBoxSSE(rays, box, tMax, tEntry);
+    }
+#endif
+    return rayBoxScalar(rays, box, tMax, tEntry);
+}
+} // namespace nre
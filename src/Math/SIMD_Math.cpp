@@ -1,10 +1,25 @@
 #include "Math/SIMD_Math.h"
 
+#include <atomic>
 #include <cstddef>
 
+#include "Math/Matrix3x4.h"
+#include "Math/Matrix4.h"
+#include "Math/SIMD_Intrinsics.h"
+
+#if defined(NRE_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 namespace
 {
 constexpr int kMatrixDimension = 4;
+constexpr std::size_t kMatrixStride = 16;
+constexpr std::size_t kAffineStride = 12;
 
 inline float elementAt(const float* matrix, int row, int column)
 {
@@ -15,18 +30,16 @@ inline void setElement(float* matrix, int row, int column, float value)
 {
     matrix[column * kMatrixDimension + row] = value;
 }
-} // namespace
 
-namespace nre
-{
-void SIMDMath::multiply4x4(const float* lhs, const float* rhs, float* out, std::size_t count)
+void multiplyScalar(const float* lhs, const float* rhs, float* out, std::size_t count)
 {
     for (std::size_t index = 0; index < count; ++index)
     {
-        const float* a = lhs + index * kMatrixDimension * kMatrixDimension;
-        const float* b = rhs + index * kMatrixDimension * kMatrixDimension;
-        float* result = out + index * kMatrixDimension * kMatrixDimension;
+        const float* a = lhs + index * kMatrixStride;
+        const float* b = rhs + index * kMatrixStride;
+        float* result = out + index * kMatrixStride;
 
+        float temp[kMatrixStride];
         for (int row = 0; row < kMatrixDimension; ++row)
         {
             for (int column = 0; column < kMatrixDimension; ++column)
@@ -36,9 +49,495 @@ void SIMDMath::multiply4x4(const float* lhs, const float* rhs, float* out, std::
                 {
                     value += elementAt(a, row, inner) * elementAt(b, inner, column);
                 }
-                setElement(result, row, column, value);
+                setElement(temp, row, column, value);
+            }
+        }
+        for (std::size_t element = 0; element < kMatrixStride; ++element)
+        {
+            result[element] = temp[element];
+        }
+    }
+}
+
+// Row-major 3x4 affine product; row i of the result is a.row(i) applied to the rows of b,
+// plus a's translation.
+void multiplyAffineScalar(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* a = lhs + index * kAffineStride;
+        const float* b = rhs + index * kAffineStride;
+        float* result = out + index * kAffineStride;
+
+        float temp[kAffineStride];
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            const float* r = a + row * 4;
+            for (std::size_t column = 0; column < 4; ++column)
+            {
+                temp[row * 4 + column] = r[0] * b[column] + r[1] * b[4 + column] + r[2] * b[8 + column];
+            }
+            temp[row * 4 + 3] += r[3];
+        }
+        for (std::size_t element = 0; element < kAffineStride; ++element)
+        {
+            result[element] = temp[element];
+        }
+    }
+}
+
+void packAffineScalar(const float* in, float* out, std::size_t count)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* m = in + index * kMatrixStride;
+        float* result = out + index * kAffineStride;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                result[row * 4 + column] = elementAt(m, row, column);
             }
         }
     }
 }
+
+#if defined(NRE_SIMD_X86)
+struct CPUIDRegisters
+{
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+};
+
+CPUIDRegisters cpuid(unsigned int leaf, unsigned int subleaf)
+{
+    CPUIDRegisters registers;
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers.eax = static_cast<unsigned int>(info[0]);
+    registers.ebx = static_cast<unsigned int>(info[1]);
+    registers.ecx = static_cast<unsigned int>(info[2]);
+    registers.edx = static_cast<unsigned int>(info[3]);
+#else
+    __cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+#endif
+    return registers;
+}
+
+unsigned long long readXCR0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32U) | eax;
+#endif
+}
+
+bool hasBit(unsigned int value, unsigned int bit)
+{
+    return (value & (1U << bit)) != 0U;
+}
+#endif
+
+nre::SIMDLevel detectLevel()
+{
+#if defined(NRE_SIMD_X86)
+    const unsigned int maxLeaf = cpuid(0, 0).eax;
+    if (maxLeaf < 1)
+    {
+        return nre::SIMDLevel::Scalar;
+    }
+
+    const CPUIDRegisters leaf1 = cpuid(1, 0);
+    if (!hasBit(leaf1.ecx, 19))
+    {
+        return nre::SIMDLevel::Scalar;
+    }
+
+    const bool osxsave = hasBit(leaf1.ecx, 27);
+    const bool avx = hasBit(leaf1.ecx, 28);
+    const bool fma = hasBit(leaf1.ecx, 12);
+    if (!osxsave || !avx || !fma || maxLeaf < 7)
+    {
+        return nre::SIMDLevel::SSE41;
+    }
+
+    const unsigned long long xcr0 = readXCR0();
+    constexpr unsigned long long kAvxState = 0x6ULL;
+    constexpr unsigned long long kAvx512State = 0xE6ULL;
+    if ((xcr0 & kAvxState) != kAvxState)
+    {
+        return nre::SIMDLevel::SSE41;
+    }
+
+    const CPUIDRegisters leaf7 = cpuid(7, 0);
+    if (!hasBit(leaf7.ebx, 5))
+    {
+        return nre::SIMDLevel::SSE41;
+    }
+
+    const bool avx512f = hasBit(leaf7.ebx, 16);
+    const bool avx512dq = hasBit(leaf7.ebx, 17);
+    if (avx512f && avx512dq && (xcr0 & kAvx512State) == kAvx512State)
+    {
+        return nre::SIMDLevel::AVX512;
+    }
+    return nre::SIMDLevel::AVX2;
+#else
+    return nre::SIMDLevel::Scalar;
+#endif
+}
+
+std::atomic<nre::SIMDLevel>& activeLevelStorage()
+{
+    static std::atomic<nre::SIMDLevel> level{nre::SIMDMath::supportedLevel()};
+    return level;
+}
+
+#if defined(NRE_SIMD_X86)
+template <bool Aligned>
+NRE_TARGET_SSE41 inline __m128 load4(const float* source)
+{
+    if constexpr (Aligned)
+    {
+        return _mm_load_ps(source);
+    }
+    else
+    {
+        return _mm_loadu_ps(source);
+    }
+}
+
+template <bool Aligned>
+NRE_TARGET_SSE41 inline void store4(float* destination, __m128 value)
+{
+    if constexpr (Aligned)
+    {
+        _mm_store_ps(destination, value);
+    }
+    else
+    {
+        _mm_storeu_ps(destination, value);
+    }
+}
+
+template <bool Aligned>
+NRE_TARGET_SSE41 void multiplySSE(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* a = lhs + index * kMatrixStride;
+        const float* b = rhs + index * kMatrixStride;
+        float* result = out + index * kMatrixStride;
+
+        const __m128 a0 = load4<Aligned>(a + 0);
+        const __m128 a1 = load4<Aligned>(a + 4);
+        const __m128 a2 = load4<Aligned>(a + 8);
+        const __m128 a3 = load4<Aligned>(a + 12);
+        const __m128 columns[4] = {load4<Aligned>(b + 0), load4<Aligned>(b + 4), load4<Aligned>(b + 8),
+                                   load4<Aligned>(b + 12)};
+
+        for (std::size_t column = 0; column < 4; ++column)
+        {
+            const __m128 bc = columns[column];
+            __m128 value = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+            value = _mm_add_ps(value, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+            value = _mm_add_ps(value, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+            value = _mm_add_ps(value, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+            store4<Aligned>(result + column * 4, value);
+        }
+    }
+}
+
+NRE_TARGET_SSE41 void multiplyAffineSSE(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    const __m128 translationMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* a = lhs + index * kAffineStride;
+        const float* b = rhs + index * kAffineStride;
+        float* result = out + index * kAffineStride;
+
+        const __m128 b0 = _mm_load_ps(b + 0);
+        const __m128 b1 = _mm_load_ps(b + 4);
+        const __m128 b2 = _mm_load_ps(b + 8);
+        __m128 rows[3];
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            const __m128 r = _mm_load_ps(a + row * 4);
+            __m128 value = _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+            value = _mm_add_ps(value, _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+            value = _mm_add_ps(value, _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+            rows[row] = _mm_add_ps(value, _mm_and_ps(r, translationMask));
+        }
+        _mm_store_ps(result + 0, rows[0]);
+        _mm_store_ps(result + 4, rows[1]);
+        _mm_store_ps(result + 8, rows[2]);
+    }
+}
+
+NRE_TARGET_SSE41 void packAffineSSE(const float* in, float* out, std::size_t count)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* m = in + index * kMatrixStride;
+        float* result = out + index * kAffineStride;
+
+        __m128 c0 = _mm_load_ps(m + 0);
+        __m128 c1 = _mm_load_ps(m + 4);
+        __m128 c2 = _mm_load_ps(m + 8);
+        __m128 c3 = _mm_load_ps(m + 12);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_store_ps(result + 0, c0);
+        _mm_store_ps(result + 4, c1);
+        _mm_store_ps(result + 8, c2);
+    }
+}
+
+template <bool Aligned>
+NRE_TARGET_AVX2 inline __m256 loadPair(const float* low, const float* high)
+{
+    if constexpr (Aligned)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(low)), _mm_load_ps(high), 1);
+    }
+    else
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+    }
+}
+
+template <bool Aligned>
+NRE_TARGET_AVX2 inline void storePair(float* low, float* high, __m256 value)
+{
+    if constexpr (Aligned)
+    {
+        _mm_store_ps(low, _mm256_castps256_ps128(value));
+        _mm_store_ps(high, _mm256_extractf128_ps(value, 1));
+    }
+    else
+    {
+        _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+        _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+    }
+}
+
+// Two matrices per iteration: the low 128-bit lane carries matrix i, the high lane matrix i + 1.
+template <bool Aligned>
+NRE_TARGET_AVX2 void multiplyAVX2(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 2 <= count; index += 2)
+    {
+        const float* a = lhs + index * kMatrixStride;
+        const float* b = rhs + index * kMatrixStride;
+        float* result = out + index * kMatrixStride;
+
+        const __m256 a0 = loadPair<Aligned>(a + 0, a + 16);
+        const __m256 a1 = loadPair<Aligned>(a + 4, a + 20);
+        const __m256 a2 = loadPair<Aligned>(a + 8, a + 24);
+        const __m256 a3 = loadPair<Aligned>(a + 12, a + 28);
+        const __m256 columns[4] = {loadPair<Aligned>(b + 0, b + 16), loadPair<Aligned>(b + 4, b + 20),
+                                   loadPair<Aligned>(b + 8, b + 24), loadPair<Aligned>(b + 12, b + 28)};
+
+        for (std::size_t column = 0; column < 4; ++column)
+        {
+            const __m256 bc = columns[column];
+            __m256 value = _mm256_mul_ps(a0, _mm256_permute_ps(bc, _MM_SHUFFLE(0, 0, 0, 0)));
+            value = _mm256_fmadd_ps(a1, _mm256_permute_ps(bc, _MM_SHUFFLE(1, 1, 1, 1)), value);
+            value = _mm256_fmadd_ps(a2, _mm256_permute_ps(bc, _MM_SHUFFLE(2, 2, 2, 2)), value);
+            value = _mm256_fmadd_ps(a3, _mm256_permute_ps(bc, _MM_SHUFFLE(3, 3, 3, 3)), value);
+            storePair<Aligned>(result + column * 4, result + 16 + column * 4, value);
+        }
+    }
+
+    if (index < count)
+    {
+        multiplySSE<Aligned>(lhs + index * kMatrixStride, rhs + index * kMatrixStride, out + index * kMatrixStride,
+                             count - index);
+    }
+}
+
+NRE_TARGET_AVX2 void multiplyAffineAVX2(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    const __m128 translationMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* a = lhs + index * kAffineStride;
+        const float* b = rhs + index * kAffineStride;
+        float* result = out + index * kAffineStride;
+
+        const __m128 b0 = _mm_load_ps(b + 0);
+        const __m128 b1 = _mm_load_ps(b + 4);
+        const __m128 b2 = _mm_load_ps(b + 8);
+        __m128 rows[3];
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            const __m128 r = _mm_load_ps(a + row * 4);
+            __m128 value = _mm_fmadd_ps(_mm_permute_ps(r, _MM_SHUFFLE(0, 0, 0, 0)), b0, _mm_and_ps(r, translationMask));
+            value = _mm_fmadd_ps(_mm_permute_ps(r, _MM_SHUFFLE(1, 1, 1, 1)), b1, value);
+            rows[row] = _mm_fmadd_ps(_mm_permute_ps(r, _MM_SHUFFLE(2, 2, 2, 2)), b2, value);
+        }
+        _mm_store_ps(result + 0, rows[0]);
+        _mm_store_ps(result + 4, rows[1]);
+        _mm_store_ps(result + 8, rows[2]);
+    }
+}
+
+NRE_AVX512_KERNELS_BEGIN
+
+// One matrix per 512-bit register (lane j holds column j); four independent matrices per iteration.
+template <bool Aligned>
+NRE_TARGET_AVX512 inline void multiplyOneAVX512(const float* a, const float* b, float* result)
+{
+    const __m512 bm = _mm512_loadu_ps(b);
+    const __m512 a0 = _mm512_broadcast_f32x4(load4<Aligned>(a + 0));
+    const __m512 a1 = _mm512_broadcast_f32x4(load4<Aligned>(a + 4));
+    const __m512 a2 = _mm512_broadcast_f32x4(load4<Aligned>(a + 8));
+    const __m512 a3 = _mm512_broadcast_f32x4(load4<Aligned>(a + 12));
+
+    __m512 value = _mm512_mul_ps(a0, _mm512_permute_ps(bm, _MM_SHUFFLE(0, 0, 0, 0)));
+    value = _mm512_fmadd_ps(a1, _mm512_permute_ps(bm, _MM_SHUFFLE(1, 1, 1, 1)), value);
+    value = _mm512_fmadd_ps(a2, _mm512_permute_ps(bm, _MM_SHUFFLE(2, 2, 2, 2)), value);
+    value = _mm512_fmadd_ps(a3, _mm512_permute_ps(bm, _MM_SHUFFLE(3, 3, 3, 3)), value);
+    _mm512_storeu_ps(result, value);
+}
+
+template <bool Aligned>
+NRE_TARGET_AVX512 void multiplyAVX512(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const std::size_t offset = index * kMatrixStride;
+        multiplyOneAVX512<Aligned>(lhs + offset, rhs + offset, out + offset);
+        multiplyOneAVX512<Aligned>(lhs + offset + 16, rhs + offset + 16, out + offset + 16);
+        multiplyOneAVX512<Aligned>(lhs + offset + 32, rhs + offset + 32, out + offset + 32);
+        multiplyOneAVX512<Aligned>(lhs + offset + 48, rhs + offset + 48, out + offset + 48);
+    }
+
+    if (index < count)
+    {
+        multiplyAVX2<Aligned>(lhs + index * kMatrixStride, rhs + index * kMatrixStride, out + index * kMatrixStride,
+                              count - index);
+    }
+}
+
+NRE_AVX512_KERNELS_END
+#endif
+
+using Multiply4x4Kernel = void (*)(const float*, const float*, float*, std::size_t);
+using PackKernel = void (*)(const float*, float*, std::size_t);
+
+struct KernelTable
+{
+    Multiply4x4Kernel multiply4x4;
+    Multiply4x4Kernel multiply4x4Aligned;
+    Multiply4x4Kernel multiplyAffine;
+    PackKernel packAffine;
+};
+
+#if defined(NRE_SIMD_X86)
+constexpr KernelTable kKernels[] = {
+    {multiplyScalar, multiplyScalar, multiplyAffineScalar, packAffineScalar},
+    {multiplySSE<false>, multiplySSE<true>, multiplyAffineSSE, packAffineSSE},
+    {multiplyAVX2<false>, multiplyAVX2<true>, multiplyAffineAVX2, packAffineSSE},
+    {multiplyAVX512<false>, multiplyAVX512<true>, multiplyAffineAVX2, packAffineSSE},
+};
+#else
+constexpr KernelTable kKernels[] = {
+    {multiplyScalar, multiplyScalar, multiplyAffineScalar, packAffineScalar},
+    {multiplyScalar, multiplyScalar, multiplyAffineScalar, packAffineScalar},
+    {multiplyScalar, multiplyScalar, multiplyAffineScalar, packAffineScalar},
+    {multiplyScalar, multiplyScalar, multiplyAffineScalar, packAffineScalar},
+};
+#endif
+
+const KernelTable& kernels()
+{
+    return kKernels[static_cast<std::size_t>(nre::SIMDMath::activeLevel())];
+}
+} // namespace
+
+namespace nre
+{
+SIMDLevel SIMDMath::supportedLevel() noexcept
+{
+    static const SIMDLevel level = detectLevel();
+    return level;
+}
+
+SIMDLevel SIMDMath::activeLevel() noexcept
+{
+    return activeLevelStorage().load(std::memory_order_relaxed);
+}
+
+void SIMDMath::setActiveLevel(SIMDLevel level) noexcept
+{
+    const SIMDLevel supported = supportedLevel();
+    activeLevelStorage().store(level > supported ? supported : level, std::memory_order_relaxed);
+}
+
+const char* SIMDMath::levelName(SIMDLevel level) noexcept
+{
+    switch (level)
+    {
+    case SIMDLevel::Scalar:
+        return "Scalar";
+    case SIMDLevel::SSE41:
+        return "SSE4.1";
+    case SIMDLevel::AVX2:
+        return "AVX2";
+    case SIMDLevel::AVX512:
+        return "AVX-512";
+    default:
+        return "Unknown";
+    }
+}
+
+void SIMDMath::multiply4x4(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    kernels().multiply4x4(lhs, rhs, out, count);
+}
+
+void SIMDMath::multiply4x4Scalar(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+    multiplyScalar(lhs, rhs, out, count);
+}
+
+void SIMDMath::multiply4x4Aligned(const Matrix4* lhs, const Matrix4* rhs, Matrix4* out, std::size_t count)
+{
+    static_assert(sizeof(Matrix4) == kMatrixStride * sizeof(float), "Matrix4 must be tightly packed");
+    static_assert(alignof(Matrix4) >= 16, "Matrix4 must be 16-byte aligned");
+    if (count == 0)
+    {
+        return;
+    }
+    kernels().multiply4x4Aligned(lhs->dataPtr(), rhs->dataPtr(), out->dataPtr(), count);
+}
+
+void SIMDMath::multiply3x4(const Matrix3x4* lhs, const Matrix3x4* rhs, Matrix3x4* out, std::size_t count)
+{
+    static_assert(sizeof(Matrix3x4) == kAffineStride * sizeof(float), "Matrix3x4 must be tightly packed");
+    if (count == 0)
+    {
+        return;
+    }
+    kernels().multiplyAffine(lhs->dataPtr(), rhs->dataPtr(), out->dataPtr(), count);
+}
+
+void SIMDMath::packAffine(const Matrix4* in, Matrix3x4* out, std::size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    kernels().packAffine(in->dataPtr(), out->dataPtr(), count);
+}
 } // namespace nre
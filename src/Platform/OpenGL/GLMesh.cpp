@@ -2,10 +2,13 @@
 
 #if defined(NRE_ENABLE_OPENGL) && defined(NRE_USE_GLFW)
 
+#include <algorithm>
 #include <cstddef>
 #include <stdexcept>
 #include <vector>
 
+#include "Math/Matrix3x4.h"
+
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -19,10 +22,53 @@
 
 namespace nre
 {
+namespace
+{
+// Both instance streams are three vec4 attributes with a 48-byte stride.
+constexpr std::size_t kInstanceStreamStride = 12 * sizeof(float);
+static_assert(sizeof(Matrix3x4) == kInstanceStreamStride, "Instance rows are streamed as tightly packed Matrix3x4s");
+
+void setupInstanceStream(GLuint buffer, GLuint firstLocation)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint row = 0; row < 3; ++row)
+    {
+        const GLuint location = firstLocation + row;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location,
+                              4,
+                              GL_FLOAT,
+                              GL_FALSE,
+                              static_cast<GLsizei>(kInstanceStreamStride),
+                              reinterpret_cast<const void*>(sizeof(float) * 4 * row));
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+// Orphans the storage every call so the driver never waits on the previous frame's draws.
+void streamInstances(GLuint buffer, std::size_t capacity, const void* data, std::size_t count)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(capacity * kInstanceStreamStride),
+                 nullptr,
+                 GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(count * kInstanceStreamStride), data);
+}
+} // namespace
+
 GLMesh::GLMesh() = default;
 
 GLMesh::~GLMesh()
 {
+    if (instanceNormalVbo_ != 0)
+    {
+        glDeleteBuffers(1, &instanceNormalVbo_);
+    }
+    if (instanceVbo_ != 0)
+    {
+        glDeleteBuffers(1, &instanceVbo_);
+    }
     if (ebo_ != 0)
     {
         glDeleteBuffers(1, &ebo_);
@@ -100,6 +146,38 @@ void GLMesh::draw() const
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount_), GL_UNSIGNED_INT, nullptr);
     glBindVertexArray(0);
 }
+
+void GLMesh::drawInstanced(const Matrix3x4* instances, const float* normalMatrices, std::size_t count) const
+{
+    if (vao_ == 0 || indexCount_ == 0 || count == 0)
+    {
+        return;
+    }
+
+    glBindVertexArray(vao_);
+    if (instanceVbo_ == 0)
+    {
+        glGenBuffers(1, &instanceVbo_);
+        glGenBuffers(1, &instanceNormalVbo_);
+        setupInstanceStream(instanceVbo_, Mesh::kInstanceAttributeLocation);
+        setupInstanceStream(instanceNormalVbo_, Mesh::kInstanceNormalAttributeLocation);
+    }
+
+    if (count > instanceCapacity_)
+    {
+        instanceCapacity_ = std::max<std::size_t>(count, instanceCapacity_ * 2);
+    }
+    streamInstances(instanceVbo_, instanceCapacity_, instances, count);
+    streamInstances(instanceNormalVbo_, instanceCapacity_, normalMatrices, count);
+
+    glDrawElementsInstanced(GL_TRIANGLES,
+                            static_cast<GLsizei>(indexCount_),
+                            GL_UNSIGNED_INT,
+                            nullptr,
+                            static_cast<GLsizei>(count));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 } // namespace nre
 
 #endif // NRE_ENABLE_OPENGL && NRE_USE_GLFW
@@ -0,0 +1,159 @@
+#include "Renderer/InstanceBatcher.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include "Math/SIMD_Math.h"
+#include "Renderer/Material.h"
+#include "Renderer/Mesh.h"
+#include "Renderer/Shader.h"
+
+namespace nre
+{
+std::size_t InstanceBatcher::BatchKeyHash::operator()(const BatchKey& key) const noexcept
+{
+    const std::hash<const void*> hash;
+    std::size_t seed = hash(key.mesh);
+    seed ^= hash(key.shader) + 0x9E3779B9U + (seed << 6U) + (seed >> 2U);
+    seed ^= hash(key.material) + 0x9E3779B9U + (seed << 6U) + (seed >> 2U);
+    return seed;
+}
+
+void InstanceBatcher::clear()
+{
+    batchIndex_.clear();
+    batches_.clear();
+    worlds_.clear();
+    itemBatches_.clear();
+    instances_.clear();
+    normalMatrices_.clear();
+}
+
+void InstanceBatcher::add(const Mesh& mesh, const Shader* shader, const Material* material, const Matrix4& world)
+{
+    add(mesh, shader, material, &world, 1);
+}
+
+void InstanceBatcher::add(const Mesh& mesh,
+                          const Shader* shader,
+                          const Material* material,
+                          const Matrix4* worlds,
+                          std::size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    const auto [it, inserted] =
+        batchIndex_.try_emplace(BatchKey{&mesh, shader, material}, static_cast<std::uint32_t>(batches_.size()));
+    if (inserted)
+    {
+        batches_.push_back({&mesh, shader, material, 0, 0});
+    }
+    batches_[it->second].count += static_cast<std::uint32_t>(count);
+    worlds_.insert(worlds_.end(), worlds, worlds + count);
+    itemBatches_.insert(itemBatches_.end(), count, it->second);
+}
+
+void InstanceBatcher::build()
+{
+    const std::size_t batchCount = batches_.size();
+    order_.resize(batchCount);
+    std::iota(order_.begin(), order_.end(), 0U);
+    const std::less<const void*> less;
+    std::sort(order_.begin(),
+              order_.end(),
+              [this, &less](std::uint32_t lhs, std::uint32_t rhs)
+              {
+                  const InstanceBatch& a = batches_[lhs];
+                  const InstanceBatch& b = batches_[rhs];
+                  if (a.shader != b.shader)
+                  {
+                      return less(a.shader, b.shader);
+                  }
+                  if (a.material != b.material)
+                  {
+                      return less(a.material, b.material);
+                  }
+                  return less(a.mesh, b.mesh);
+              });
+
+    sortedBatches_.resize(batchCount);
+    remap_.resize(batchCount);
+    cursors_.resize(batchCount);
+    std::uint32_t first = 0;
+    for (std::uint32_t position = 0; position < batchCount; ++position)
+    {
+        InstanceBatch& batch = sortedBatches_[position];
+        batch = batches_[order_[position]];
+        batch.first = first;
+        first += batch.count;
+        remap_[order_[position]] = position;
+        cursors_[position] = batch.first;
+    }
+
+    const std::size_t itemCount = worlds_.size();
+    sortedWorlds_.resize(itemCount);
+    for (std::size_t item = 0; item < itemCount; ++item)
+    {
+        const std::uint32_t batch = remap_[itemBatches_[item]];
+        itemBatches_[item] = batch;
+        sortedWorlds_[cursors_[batch]++] = worlds_[item];
+    }
+    instances_.resize(itemCount);
+    SIMDMath::packAffine(sortedWorlds_.data(), instances_.data(), itemCount);
+    normalMatrices_.resize(itemCount * 12);
+    Matrix4::normalMatrices(sortedWorlds_.data(), normalMatrices_.data(), itemCount);
+
+    // Keep the bookkeeping in sorted order so more add() calls and another build() stay consistent.
+    for (auto& entry : batchIndex_)
+    {
+        entry.second = remap_[entry.second];
+    }
+    batches_.swap(sortedBatches_);
+}
+
+std::size_t InstanceBatcher::submit() const
+{
+    const Shader* boundShader = nullptr;
+    const Material* boundMaterial = nullptr;
+    std::size_t drawCalls = 0;
+    for (const InstanceBatch& batch : batches_)
+    {
+        if (batch.shader != boundShader)
+        {
+            if (batch.shader != nullptr)
+            {
+                batch.shader->bind();
+            }
+            boundShader = batch.shader;
+        }
+        if (batch.material != boundMaterial)
+        {
+            if (boundMaterial != nullptr)
+            {
+                boundMaterial->unbind();
+            }
+            if (batch.material != nullptr)
+            {
+                batch.material->bind();
+            }
+            boundMaterial = batch.material;
+        }
+        batch.mesh->drawInstanced(instances_.data() + batch.first,
+                                  normalMatrices_.data() + std::size_t{batch.first} * 12,
+                                  batch.count);
+        ++drawCalls;
+    }
+    if (boundMaterial != nullptr)
+    {
+        boundMaterial->unbind();
+    }
+    if (boundShader != nullptr)
+    {
+        boundShader->unbind();
+    }
+    return drawCalls;
+}
+} // namespace nre
@@ -0,0 +1,31 @@
+#include "Renderer/LODGroup.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace nre
+{
+void LODGroup::addLevel(std::shared_ptr<Mesh> mesh, float geometricError)
+{
+    if (!mesh)
+    {
+        throw std::runtime_error("LODGroup level has no mesh.");
+    }
+    if (!(geometricError >= 0.0F) || (!errors_.empty() && geometricError < errors_.back()))
+    {
+        throw std::runtime_error("LODGroup geometric errors must be non-negative and non-decreasing.");
+    }
+    if (meshes_.size() == kMaxLevels)
+    {
+        throw std::runtime_error("LODGroup has too many levels.");
+    }
+    meshes_.push_back(std::move(mesh));
+    errors_.push_back(geometricError);
+}
+
+void LODGroup::clear()
+{
+    meshes_.clear();
+    errors_.clear();
+}
+} // namespace nre
@@ -0,0 +1,190 @@
+#include "Renderer/MeshBounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+#include "Renderer/Mesh.h"
+
+namespace nre
+{
+namespace
+{
+Vector3 positionOf(const Vertex& vertex)
+{
+    return {vertex.position[0], vertex.position[1], vertex.position[2]};
+}
+
+void boxScalar(const Vertex* vertices, std::size_t index, std::size_t count, BoundingBox& box)
+{
+    for (; index < count; ++index)
+    {
+        const float* p = vertices[index].position;
+        box.min = {std::min(box.min.x, p[0]), std::min(box.min.y, p[1]), std::min(box.min.z, p[2])};
+        box.max = {std::max(box.max.x, p[0]), std::max(box.max.y, p[1]), std::max(box.max.z, p[2])};
+    }
+}
+
+#if defined(NRE_SIMD_X86)
+// A vertex's first four floats are its position and normal.x; the fourth lane is ignored.
+NRE_TARGET_SSE41 BoundingBox boxSSE(const Vertex* vertices, std::size_t count)
+{
+    __m128 minimum = _mm_loadu_ps(vertices[0].position);
+    __m128 maximum = minimum;
+    std::size_t index = 1;
+    for (; index < count; ++index)
+    {
+        const __m128 position = _mm_loadu_ps(vertices[index].position);
+        minimum = _mm_min_ps(minimum, position);
+        maximum = _mm_max_ps(maximum, position);
+    }
+    alignas(16) float low[4];
+    alignas(16) float high[4];
+    _mm_store_ps(low, minimum);
+    _mm_store_ps(high, maximum);
+    return {{low[0], low[1], low[2]}, {high[0], high[1], high[2]}};
+}
+
+NRE_TARGET_AVX2 inline __m256 loadPositionPair(const Vertex* vertices)
+{
+    return _mm256_insertf128_ps(
+        _mm256_castps128_ps256(_mm_loadu_ps(vertices[0].position)), _mm_loadu_ps(vertices[1].position), 1);
+}
+
+// Two vertices per register, with two independent accumulators to hide the min/max latency.
+NRE_TARGET_AVX2 BoundingBox boxAVX2(const Vertex* vertices, std::size_t count)
+{
+    const __m128 first = _mm_loadu_ps(vertices[0].position);
+    __m256 minimum0 = _mm256_insertf128_ps(_mm256_castps128_ps256(first), first, 1);
+    __m256 maximum0 = minimum0;
+    __m256 minimum1 = minimum0;
+    __m256 maximum1 = minimum0;
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m256 pair0 = loadPositionPair(vertices + index);
+        const __m256 pair1 = loadPositionPair(vertices + index + 2);
+        minimum0 = _mm256_min_ps(minimum0, pair0);
+        maximum0 = _mm256_max_ps(maximum0, pair0);
+        minimum1 = _mm256_min_ps(minimum1, pair1);
+        maximum1 = _mm256_max_ps(maximum1, pair1);
+    }
+    const __m256 minimum = _mm256_min_ps(minimum0, minimum1);
+    const __m256 maximum = _mm256_max_ps(maximum0, maximum1);
+    const __m128 low = _mm_min_ps(_mm256_castps256_ps128(minimum), _mm256_extractf128_ps(minimum, 1));
+    const __m128 high = _mm_max_ps(_mm256_castps256_ps128(maximum), _mm256_extractf128_ps(maximum, 1));
+    alignas(16) float lowLanes[4];
+    alignas(16) float highLanes[4];
+    _mm_store_ps(lowLanes, low);
+    _mm_store_ps(highLanes, high);
+    BoundingBox box{{lowLanes[0], lowLanes[1], lowLanes[2]}, {highLanes[0], highLanes[1], highLanes[2]}};
+    boxScalar(vertices, index, count, box);
+    return box;
+}
+#endif
+
+BoundingBox computeBox(const Vertex* vertices, std::size_t count)
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return boxAVX2(vertices, count);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return boxSSE(vertices, count);
+    }
+#endif
+    const Vector3 first = positionOf(vertices[0]);
+    BoundingBox box{first, first};
+    boxScalar(vertices, 1, count, box);
+    return box;
+}
+
+float distanceSquared(const Vector3& a, const Vector3& b)
+{
+    const Vector3 d = a - b;
+    return d.x * d.x + d.y * d.y + d.z * d.z;
+}
+
+// Starts from the most separated pair among the vertices on the box faces and grows the sphere to take in
+// every vertex left outside (Ritter 1990).
+Vector3 ritterCenter(const Vertex* vertices, std::size_t count, const BoundingBox& box)
+{
+    Vector3 low[3] = {positionOf(vertices[0]), positionOf(vertices[0]), positionOf(vertices[0])};
+    Vector3 high[3] = {low[0], low[0], low[0]};
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const float* p = vertices[index].position;
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            if (p[axis] == box.min[axis])
+            {
+                low[axis] = {p[0], p[1], p[2]};
+            }
+            if (p[axis] == box.max[axis])
+            {
+                high[axis] = {p[0], p[1], p[2]};
+            }
+        }
+    }
+    std::size_t widest = 0;
+    for (std::size_t axis = 1; axis < 3; ++axis)
+    {
+        if (distanceSquared(low[axis], high[axis]) > distanceSquared(low[widest], high[widest]))
+        {
+            widest = axis;
+        }
+    }
+
+    Vector3 center = (low[widest] + high[widest]) * 0.5F;
+    float radius = std::sqrt(distanceSquared(low[widest], high[widest])) * 0.5F;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const Vector3 p = positionOf(vertices[index]);
+        const float distance = std::sqrt(distanceSquared(p, center));
+        if (distance > radius)
+        {
+            const float grown = (radius + distance) * 0.5F;
+            center = center + (p - center) * ((distance - grown) / distance);
+            radius = grown;
+        }
+    }
+    return center;
+}
+} // namespace
+
+MeshBounds computeMeshBounds(const Vertex* vertices, std::size_t count)
+{
+    MeshBounds bounds;
+    if (count == 0)
+    {
+        return bounds;
+    }
+    bounds.box = computeBox(vertices, count);
+
+    // Radii are measured exactly from each candidate center rather than carried from the construction,
+    // so every vertex is inside despite rounding.
+    const Vector3 boxCenter = (bounds.box.min + bounds.box.max) * 0.5F;
+    const Vector3 ritter = ritterCenter(vertices, count, bounds.box);
+    float boxRadiusSquared = 0.0F;
+    float ritterRadiusSquared = 0.0F;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const Vector3 p = positionOf(vertices[index]);
+        boxRadiusSquared = std::max(boxRadiusSquared, distanceSquared(p, boxCenter));
+        ritterRadiusSquared = std::max(ritterRadiusSquared, distanceSquared(p, ritter));
+    }
+    if (ritterRadiusSquared < boxRadiusSquared)
+    {
+        bounds.sphere = {ritter, std::sqrt(ritterRadiusSquared)};
+    }
+    else
+    {
+        bounds.sphere = {boxCenter, std::sqrt(boxRadiusSquared)};
+    }
+    return bounds;
+}
+} // namespace nre
@@ -44,12 +44,44 @@ std::shared_ptr<Mesh> MeshCache::loadFromGenerator(const std::string& key,
         }
     }
 
-    const MeshData data = generator ? generator() : MeshData{};
+    MeshData data = generator ? generator() : MeshData{};
+    // The factory functions fill in the bounds; hand-assembled data may leave them unset.
+    if (data.bounds.sphere.radius <= 0.0F && !data.vertices.empty())
+    {
+        data.bounds = computeMeshBounds(data.vertices.data(), data.vertices.size());
+    }
     auto mesh = createMesh(data);
     cache_[key] = mesh;
     return mesh;
 }
 
+std::shared_ptr<Mesh> MeshCache::loadFromData(const std::string& key, const MeshData& data)
+{
+    if (auto it = cache_.find(key); it != cache_.end())
+    {
+        if (auto existing = it->second.lock())
+        {
+            return existing;
+        }
+    }
+
+    auto mesh = createMesh(data);
+    cache_[key] = mesh;
+    return mesh;
+}
+
+LODGroup MeshCache::loadLODGroup(const std::string& key, const std::vector<LODSource>& levels)
+{
+    LODGroup group;
+    for (std::size_t level = 0; level < levels.size(); ++level)
+    {
+        const LODSource& source = levels[level];
+        group.addLevel(loadFromGenerator(key + "#lod" + std::to_string(level), source.generator),
+                       source.geometricError);
+    }
+    return group;
+}
+
 void MeshCache::clear()
 {
     cache_.clear();
@@ -74,6 +106,7 @@ std::shared_ptr<Mesh> MeshCache::createMesh(const MeshData& data)
     }
 
     mesh->upload(data.vertices, data.indices);
+    mesh->setBounds(data.bounds);
     return std::shared_ptr<Mesh>(mesh.release());
 }
 } // namespace nre
@@ -332,6 +332,7 @@ MeshData makeTriangle()
         {{0.0F, 0.6F, 0.0F}, {0.0F, 0.0F, 1.0F}, {0.5F, 1.0F}},
     };
     data.indices = {0U, 1U, 2U};
+    data.bounds = computeMeshBounds(data.vertices.data(), data.vertices.size());
     return data;
 }
 
@@ -345,22 +346,28 @@ MeshData makeFullscreenQuad()
         {{-1.0F, 1.0F, 0.0F}, {0.0F, 0.0F, 1.0F}, {0.0F, 1.0F}},
     };
     data.indices = {0U, 1U, 2U, 2U, 3U, 0U};
+    data.bounds = computeMeshBounds(data.vertices.data(), data.vertices.size());
     return data;
 }
 
 MeshData loadMeshFromFile(const std::string& path)
 {
     const std::string ext = toLower(std::filesystem::path(path).extension().string());
+    MeshData data{};
     if (ext == ".obj")
     {
-        return loadObjMesh(path);
+        data = loadObjMesh(path);
     }
-    if (ext == ".gltf" || ext == ".glb")
+    else if (ext == ".gltf" || ext == ".glb")
     {
-        return loadGltfMesh(path);
+        data = loadGltfMesh(path);
     }
-
-    throw std::runtime_error("Unsupported mesh format: " + path);
+    else
+    {
+        throw std::runtime_error("Unsupported mesh format: " + path);
+    }
+    data.bounds = computeMeshBounds(data.vertices.data(), data.vertices.size());
+    return data;
 }
 
 MeshData addIndexedMesh(const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices)
@@ -368,6 +375,7 @@ MeshData addIndexedMesh(const std::vector<Vertex>& vertices, const std::vector<s
     MeshData data{};
     data.vertices = vertices;
     data.indices = indices;
+    data.bounds = computeMeshBounds(data.vertices.data(), data.vertices.size());
     return data;
 }
 } // namespace nre
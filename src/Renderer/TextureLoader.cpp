@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -28,20 +29,11 @@ namespace nre
 {
 TextureLoader::TextureLoader(RenderAPI& api) : api_(&api) {}
 
-std::shared_ptr<Texture> TextureLoader::load(const std::string& path)
+TextureImage TextureLoader::decode(const std::string& path)
 {
-    if (auto it = cache_.find(path); it != cache_.end())
-    {
-        if (auto existing = it->second.lock())
-        {
-            return existing;
-        }
-    }
-
-    if (api_ == nullptr)
-    {
-        throw std::runtime_error("TextureLoader has no associated RenderAPI.");
-    }
+    // stb_image's flip setting is process-wide, so decodes on different threads take turns.
+    static std::mutex decodeMutex;
+    std::lock_guard<std::mutex> lock(decodeMutex);
 
     int width = 0;
     int height = 0;
@@ -49,12 +41,12 @@ std::shared_ptr<Texture> TextureLoader::load(const std::string& path)
     stbi_set_flip_vertically_on_load(true);
     unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
 
-    std::vector<unsigned char> rgba;
+    TextureImage image;
     if (pixels == nullptr || width <= 0 || height <= 0)
     {
         // Fallback 2x2 checkerboard (magenta/black) so failures are obvious but non-fatal.
         width = height = 2;
-        rgba = {
+        image.rgba = {
             255, 0, 255, 255,   0, 0, 0, 255,
             0, 0, 0, 255,       255, 0, 255, 255
         };
@@ -62,13 +54,48 @@ std::shared_ptr<Texture> TextureLoader::load(const std::string& path)
     else
     {
         const std::size_t pixelCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
-        rgba.assign(pixels, pixels + pixelCount * 4);
+        image.rgba.assign(pixels, pixels + pixelCount * 4);
+    }
+    if (pixels != nullptr)
+    {
         stbi_image_free(pixels);
     }
+    image.width = static_cast<std::uint32_t>(width);
+    image.height = static_cast<std::uint32_t>(height);
+    return image;
+}
+
+std::shared_ptr<Texture> TextureLoader::load(const std::string& path)
+{
+    if (auto it = cache_.find(path); it != cache_.end())
+    {
+        if (auto existing = it->second.lock())
+        {
+            return existing;
+        }
+    }
+
+    return load(path, decode(path));
+}
+
+std::shared_ptr<Texture> TextureLoader::load(const std::string& path, const TextureImage& image)
+{
+    if (auto it = cache_.find(path); it != cache_.end())
+    {
+        if (auto existing = it->second.lock())
+        {
+            return existing;
+        }
+    }
+
+    if (api_ == nullptr)
+    {
+        throw std::runtime_error("TextureLoader has no associated RenderAPI.");
+    }
 
     TextureDescriptor descriptor;
-    descriptor.width = static_cast<std::uint32_t>(width);
-    descriptor.height = static_cast<std::uint32_t>(height);
+    descriptor.width = image.width;
+    descriptor.height = image.height;
     descriptor.format = TextureFormat::RGBA8;
 
     auto texture = api_->createTexture(descriptor);
@@ -77,7 +104,7 @@ std::shared_ptr<Texture> TextureLoader::load(const std::string& path)
         throw std::runtime_error("RenderAPI failed to create texture for: " + path);
     }
 
-    texture->upload(rgba.data(), rgba.size());
+    texture->upload(image.rgba.data(), image.rgba.size());
 
     auto shared = std::shared_ptr<Texture>(texture.release());
     cache_[path] = shared;
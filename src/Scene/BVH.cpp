@@ -0,0 +1,622 @@
+#include "Scene/BVH.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+#include "Core/JobSystem.h"
+
+namespace nre
+{
+namespace
+{
+constexpr std::size_t kBinCount = 16;
+// Cost of visiting a node relative to testing one primitive.
+constexpr float kTraversalCost = 1.0F;
+// Deeper splits fall back to object medians, which bounds the depth for the fixed traversal stacks.
+constexpr std::uint32_t kSAHDepthLimit = 40;
+constexpr std::size_t kStackSize = 96;
+// Nodes this large are binned across the workers while the top of the tree is split.
+constexpr std::size_t kParallelBinThreshold = 65536;
+// Enough subtree tasks per thread to even out unbalanced splits.
+constexpr std::size_t kTasksPerThread = 4;
+constexpr std::size_t kMinTaskSize = 1024;
+
+// In place, which keeps the box in registers across the build's per-primitive loops.
+inline void grow(BoundingBox& box, const Vector3& min, const Vector3& max)
+{
+    box.min.x = std::min(box.min.x, min.x);
+    box.min.y = std::min(box.min.y, min.y);
+    box.min.z = std::min(box.min.z, min.z);
+    box.max.x = std::max(box.max.x, max.x);
+    box.max.y = std::max(box.max.y, max.y);
+    box.max.z = std::max(box.max.z, max.z);
+}
+
+struct Bin
+{
+    BoundingBox bounds = emptyBox();
+    std::uint32_t count = 0;
+};
+
+using AxisBins = std::array<std::array<Bin, kBinCount>, 3>;
+
+struct RangeBounds
+{
+    BoundingBox bounds = emptyBox();
+    BoundingBox centroids = emptyBox();
+};
+
+struct Split
+{
+    int axis = -1;
+    // Bins below this one go left.
+    std::size_t bin = 0;
+    float cost = std::numeric_limits<float>::max();
+};
+
+template <typename Ref>
+inline Vector3 centroidOf(const Ref& ref)
+{
+    return (ref.min + ref.max) * 0.5F;
+}
+
+template <typename Ref>
+RangeBounds measure(const Ref* refs, std::size_t begin, std::size_t end)
+{
+    RangeBounds range;
+    for (std::size_t slot = begin; slot < end; ++slot)
+    {
+        const Vector3 centroid = centroidOf(refs[slot]);
+        grow(range.bounds, refs[slot].min, refs[slot].max);
+        grow(range.centroids, centroid, centroid);
+    }
+    return range;
+}
+
+// Scale mapping centroid offsets along each axis to binCount bins; zero for flat axes.
+Vector3 binScale(const BoundingBox& centroids, std::size_t binCount)
+{
+    const Vector3 extent = centroids.max - centroids.min;
+    // Slightly under binCount so the maximum centroid stays in the last bin.
+    const float bins = static_cast<float>(binCount) * 0.9999F;
+    return {extent.x > 0.0F ? bins / extent.x : 0.0F,
+            extent.y > 0.0F ? bins / extent.y : 0.0F,
+            extent.z > 0.0F ? bins / extent.z : 0.0F};
+}
+
+inline std::size_t binIndex(float value, float origin, float scale, std::size_t binCount)
+{
+    // Through int: the value is small and non-negative, and the signed conversion is a single instruction.
+    const auto bin = static_cast<std::size_t>(static_cast<int>((value - origin) * scale));
+    return std::min(bin, binCount - 1);
+}
+
+void resetBins(AxisBins& bins, std::size_t binCount)
+{
+    for (auto& axisBins : bins)
+    {
+        std::fill_n(axisBins.begin(), binCount, Bin{});
+    }
+}
+
+template <typename Ref>
+void fillBins(const Ref* refs,
+              std::size_t begin,
+              std::size_t end,
+              const BoundingBox& centroids,
+              const Vector3& scale,
+              std::size_t binCount,
+              AxisBins& bins)
+{
+    for (std::size_t slot = begin; slot < end; ++slot)
+    {
+        const Vector3 centroid = centroidOf(refs[slot]);
+        Bin& binX = bins[0][binIndex(centroid.x, centroids.min.x, scale.x, binCount)];
+        grow(binX.bounds, refs[slot].min, refs[slot].max);
+        ++binX.count;
+        Bin& binY = bins[1][binIndex(centroid.y, centroids.min.y, scale.y, binCount)];
+        grow(binY.bounds, refs[slot].min, refs[slot].max);
+        ++binY.count;
+        Bin& binZ = bins[2][binIndex(centroid.z, centroids.min.z, scale.z, binCount)];
+        grow(binZ.bounds, refs[slot].min, refs[slot].max);
+        ++binZ.count;
+    }
+}
+
+// Sweeps the bins of every non-flat axis; cost is the summed area-weighted primitive count of both sides.
+Split findSplit(const AxisBins& bins, const Vector3& scale, std::size_t binCount)
+{
+    Split best;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        if (scale[axis] <= 0.0F)
+        {
+            continue;
+        }
+        std::array<float, kBinCount> leftCost{};
+        std::array<std::uint32_t, kBinCount> leftCount{};
+        BoundingBox box = emptyBox();
+        std::uint32_t count = 0;
+        for (std::size_t bin = 0; bin + 1 < binCount; ++bin)
+        {
+            grow(box, bins[axis][bin].bounds.min, bins[axis][bin].bounds.max);
+            count += bins[axis][bin].count;
+            leftCost[bin] = halfSurfaceArea(box) * static_cast<float>(count);
+            leftCount[bin] = count;
+        }
+
+        box = emptyBox();
+        count = 0;
+        for (std::size_t bin = binCount - 1; bin > 0; --bin)
+        {
+            grow(box, bins[axis][bin].bounds.min, bins[axis][bin].bounds.max);
+            count += bins[axis][bin].count;
+            if (count == 0 || leftCount[bin - 1] == 0)
+            {
+                continue;
+            }
+            const float cost = leftCost[bin - 1] + halfSurfaceArea(box) * static_cast<float>(count);
+            if (cost < best.cost)
+            {
+                best = {static_cast<int>(axis), bin, cost};
+            }
+        }
+    }
+    return best;
+}
+
+std::size_t widestAxis(const BoundingBox& box)
+{
+    const Vector3 extent = box.max - box.min;
+    if (extent.x >= extent.y && extent.x >= extent.z)
+    {
+        return 0;
+    }
+    return extent.y >= extent.z ? 1 : 2;
+}
+} // namespace
+
+void BVH::build(const BoundingBox* bounds, std::size_t count, JobSystem* jobs)
+{
+    primitiveBounds_.assign(bounds, bounds + count);
+    triangleVertices_.clear();
+    buildPrimitives(jobs);
+}
+
+void BVH::build(const MeshData& mesh, JobSystem* jobs)
+{
+    const bool indexed = !mesh.indices.empty();
+    const std::size_t cornerCount = indexed ? mesh.indices.size() : mesh.vertices.size();
+    const std::size_t triangleCount = cornerCount / 3;
+
+    std::vector<Vector3> corners(triangleCount * 3);
+    for (std::size_t corner = 0; corner < corners.size(); ++corner)
+    {
+        const std::size_t vertex = indexed ? mesh.indices[corner] : corner;
+        if (vertex >= mesh.vertices.size())
+        {
+            throw std::runtime_error("BVH::build: mesh index out of range.");
+        }
+        const float* position = mesh.vertices[vertex].position;
+        corners[corner] = {position[0], position[1], position[2]};
+    }
+
+    primitiveBounds_.resize(triangleCount);
+    for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const Vector3* triangleCorners = corners.data() + triangle * 3;
+        BoundingBox box{triangleCorners[0], triangleCorners[0]};
+        box = merge(box, {triangleCorners[1], triangleCorners[1]});
+        primitiveBounds_[triangle] = merge(box, {triangleCorners[2], triangleCorners[2]});
+    }
+    buildPrimitives(jobs);
+
+    // Store corners in leaf order so each leaf reads one contiguous run.
+    triangleVertices_.resize(triangleCount * 3);
+    for (std::size_t slot = 0; slot < triangleCount; ++slot)
+    {
+        const std::size_t triangle = primitiveIndices_[slot];
+        std::copy_n(corners.begin() + static_cast<std::ptrdiff_t>(triangle * 3),
+                    3,
+                    triangleVertices_.begin() + static_cast<std::ptrdiff_t>(slot * 3));
+    }
+}
+
+void BVH::clear()
+{
+    nodes_.clear();
+    primitiveIndices_.clear();
+    triangleVertices_.clear();
+    primitiveBounds_.clear();
+    refs_.clear();
+}
+
+void BVH::buildPrimitives(JobSystem* jobs)
+{
+    const std::size_t count = primitiveBounds_.size();
+    nodes_.clear();
+    refs_.resize(count);
+    for (std::size_t primitive = 0; primitive < count; ++primitive)
+    {
+        const BoundingBox& bounds = primitiveBounds_[primitive];
+        refs_[primitive] = {bounds.min, static_cast<std::uint32_t>(primitive), bounds.max, 0};
+    }
+    primitiveIndices_.resize(count);
+    if (count == 0)
+    {
+        return;
+    }
+
+    nodes_.reserve(count * 2);
+    nodes_.resize(1);
+    const BuildTask root{0, 0, static_cast<std::uint32_t>(count), 0};
+    if (jobs == nullptr || jobs->workerCount() == 0)
+    {
+        buildSubtree(nodes_, root, 0, nullptr, nullptr);
+    }
+    else
+    {
+        buildParallel(root, *jobs);
+    }
+    for (std::size_t slot = 0; slot < count; ++slot)
+    {
+        primitiveIndices_[slot] = refs_[slot].index;
+    }
+}
+
+void BVH::buildParallel(const BuildTask& root, JobSystem& jobs)
+{
+    // Split the top on this thread, then build the remaining subtrees as independent tasks.
+    const std::size_t threads = jobs.workerCount() + 1;
+    const std::size_t taskSize = std::max(kMinTaskSize, (root.end - root.begin) / (threads * kTasksPerThread));
+    std::vector<BuildTask> tasks;
+    buildSubtree(nodes_, root, taskSize, &tasks, &jobs);
+
+    std::vector<std::vector<BVHNode>> subtrees(tasks.size());
+    jobs.parallelFor(tasks.size(),
+                     [this, &tasks, &subtrees](std::size_t task)
+                     {
+                         std::vector<BVHNode>& nodes = subtrees[task];
+                         nodes.reserve(static_cast<std::size_t>(tasks[task].end - tasks[task].begin) * 2);
+                         nodes.resize(1);
+                         BuildTask local = tasks[task];
+                         local.node = 0;
+                         buildSubtree(nodes, local, 0, nullptr, nullptr);
+                     });
+
+    // Splice each subtree in: its root replaces the placeholder and the rest is appended.
+    for (std::size_t task = 0; task < tasks.size(); ++task)
+    {
+        const std::vector<BVHNode>& subtree = subtrees[task];
+        const auto base = static_cast<std::uint32_t>(nodes_.size()) - 1U;
+        for (std::size_t local = 0; local < subtree.size(); ++local)
+        {
+            BVHNode node = subtree[local];
+            if (!node.isLeaf())
+            {
+                node.offset += base;
+            }
+            if (local == 0)
+            {
+                nodes_[tasks[task].node] = node;
+            }
+            else
+            {
+                nodes_.push_back(node);
+            }
+        }
+    }
+}
+
+// Splits the range of root depth-first into nodes. With a task size, ranges at or below it are left as
+// placeholder nodes and appended to deferred instead.
+void BVH::buildSubtree(std::vector<BVHNode>& nodes,
+                       const BuildTask& root,
+                       std::size_t taskSize,
+                       std::vector<BuildTask>* deferred,
+                       JobSystem* jobs)
+{
+    const PrimitiveRef* const refs = refs_.data();
+    std::vector<BuildTask> stack{root};
+    AxisBins bins;
+    while (!stack.empty())
+    {
+        const BuildTask task = stack.back();
+        stack.pop_back();
+        const std::size_t count = task.end - task.begin;
+        if (count <= taskSize)
+        {
+            deferred->push_back(task);
+            continue;
+        }
+
+        const std::size_t blockCount =
+            jobs != nullptr && count >= kParallelBinThreshold ? jobs->workerCount() + 1 : 1;
+        const auto blockBegin = [&task, count, blockCount](std::size_t block)
+        { return task.begin + count * block / blockCount; };
+
+        RangeBounds range;
+        if (blockCount > 1)
+        {
+            std::vector<RangeBounds> blockRanges(blockCount);
+            jobs->parallelFor(blockCount,
+                              [refs, &blockRanges, &blockBegin](std::size_t block)
+                              { blockRanges[block] = measure(refs, blockBegin(block), blockBegin(block + 1)); });
+            for (const RangeBounds& blockRange : blockRanges)
+            {
+                range.bounds = merge(range.bounds, blockRange.bounds);
+                range.centroids = merge(range.centroids, blockRange.centroids);
+            }
+        }
+        else
+        {
+            range = measure(refs, task.begin, task.end);
+        }
+        nodes[task.node].min = range.bounds.min;
+        nodes[task.node].max = range.bounds.max;
+
+        // Small nodes use one bin per primitive; the sweep cost otherwise dominates the leaves.
+        const std::size_t binCount = std::min(count, kBinCount);
+        const Vector3 scale = binScale(range.centroids, binCount);
+        std::size_t mid = task.begin;
+        if (task.depth < kSAHDepthLimit)
+        {
+            resetBins(bins, binCount);
+            if (blockCount > 1)
+            {
+                std::vector<AxisBins> blockBins(blockCount);
+                jobs->parallelFor(blockCount,
+                                  [refs, &blockBins, &blockBegin, &range, &scale, binCount](std::size_t block)
+                                  {
+                                      resetBins(blockBins[block], binCount);
+                                      fillBins(refs,
+                                               blockBegin(block),
+                                               blockBegin(block + 1),
+                                               range.centroids,
+                                               scale,
+                                               binCount,
+                                               blockBins[block]);
+                                  });
+                for (const AxisBins& partial : blockBins)
+                {
+                    for (std::size_t axis = 0; axis < 3; ++axis)
+                    {
+                        for (std::size_t bin = 0; bin < binCount; ++bin)
+                        {
+                            bins[axis][bin].bounds = merge(bins[axis][bin].bounds, partial[axis][bin].bounds);
+                            bins[axis][bin].count += partial[axis][bin].count;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                fillBins(refs, task.begin, task.end, range.centroids, scale, binCount, bins);
+            }
+
+            const Split split = findSplit(bins, scale, binCount);
+            const float leafCost = halfSurfaceArea(range.bounds) * static_cast<float>(count);
+            const float splitCost = halfSurfaceArea(range.bounds) * kTraversalCost + split.cost;
+            if (count <= kMaxLeafSize && (split.axis < 0 || splitCost >= leafCost))
+            {
+                nodes[task.node].offset = task.begin;
+                nodes[task.node].count = static_cast<std::uint32_t>(count);
+                continue;
+            }
+            if (split.axis >= 0)
+            {
+                const auto axis = static_cast<std::size_t>(split.axis);
+                const float origin = range.centroids.min[axis];
+                const float axisScale = scale[axis];
+                const auto goesLeft = [axis, origin, axisScale, binCount, &split](const PrimitiveRef& ref)
+                { return binIndex(centroidOf(ref)[axis], origin, axisScale, binCount) < split.bin; };
+                mid = static_cast<std::size_t>(
+                    std::partition(refs_.data() + task.begin, refs_.data() + task.end, goesLeft) - refs_.data());
+            }
+        }
+        else if (count <= kMaxLeafSize)
+        {
+            nodes[task.node].offset = task.begin;
+            nodes[task.node].count = static_cast<std::uint32_t>(count);
+            continue;
+        }
+
+        if (mid == task.begin)
+        {
+            // Coincident centroids or past the SAH depth limit: halve at the median of the widest axis.
+            const std::size_t axis = widestAxis(range.centroids);
+            mid = task.begin + count / 2;
+            std::nth_element(refs_.data() + task.begin,
+                             refs_.data() + mid,
+                             refs_.data() + task.end,
+                             [axis](const PrimitiveRef& a, const PrimitiveRef& b)
+                             { return centroidOf(a)[axis] < centroidOf(b)[axis]; });
+        }
+
+        const auto firstChild = static_cast<std::uint32_t>(nodes.size());
+        nodes.resize(nodes.size() + 2);
+        nodes[task.node].offset = firstChild;
+        nodes[task.node].count = 0;
+        const auto split = static_cast<std::uint32_t>(mid);
+        stack.push_back({firstChild + 1, split, task.end, task.depth + 1});
+        stack.push_back({firstChild, task.begin, split, task.depth + 1});
+    }
+}
+
+bool BVH::intersectPrimitive(const Ray& ray, std::uint32_t slot, float tMax, RayHit& hit) const noexcept
+{
+    if (!triangleVertices_.empty())
+    {
+        const Vector3* corners = triangleVertices_.data() + static_cast<std::size_t>(slot) * 3;
+        return RayMath::intersectTriangle(ray, corners[0], corners[1], corners[2], tMax, hit);
+    }
+    float tEntry = 0.0F;
+    if (!RayMath::intersectBox(ray, primitiveBounds_[primitiveIndices_[slot]], tMax, tEntry))
+    {
+        return false;
+    }
+    hit = {tEntry, 0.0F, 0.0F};
+    return true;
+}
+
+bool BVH::intersect(const Ray& ray, float tMax, BVHHit& hit) const
+{
+    struct Entry
+    {
+        std::uint32_t node;
+        float tEntry;
+    };
+
+    Entry stack[kStackSize];
+    std::size_t top = 0;
+    float rootEntry = 0.0F;
+    if (nodes_.empty() || !RayMath::intersectBox(ray, nodes_[0].bounds(), tMax, rootEntry))
+    {
+        return false;
+    }
+    stack[top++] = {0, rootEntry};
+
+    float closest = tMax;
+    bool found = false;
+    while (top > 0)
+    {
+        const Entry entry = stack[--top];
+        if (entry.tEntry > closest)
+        {
+            continue;
+        }
+        const BVHNode& node = nodes_[entry.node];
+        if (node.isLeaf())
+        {
+            for (std::uint32_t slot = node.offset; slot < node.offset + node.count; ++slot)
+            {
+                RayHit primitiveHit;
+                if (intersectPrimitive(ray, slot, closest, primitiveHit))
+                {
+                    closest = primitiveHit.t;
+                    hit = {primitiveIndices_[slot], primitiveHit.t, primitiveHit.u, primitiveHit.v};
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first so its hits can prune the other.
+        float tLeft = 0.0F;
+        float tRight = 0.0F;
+        const bool hitLeft = RayMath::intersectBox(ray, nodes_[node.offset].bounds(), closest, tLeft);
+        const bool hitRight = RayMath::intersectBox(ray, nodes_[node.offset + 1].bounds(), closest, tRight);
+        if (hitLeft && hitRight)
+        {
+            if (tLeft <= tRight)
+            {
+                stack[top++] = {node.offset + 1, tRight};
+                stack[top++] = {node.offset, tLeft};
+            }
+            else
+            {
+                stack[top++] = {node.offset, tLeft};
+                stack[top++] = {node.offset + 1, tRight};
+            }
+        }
+        else if (hitLeft)
+        {
+            stack[top++] = {node.offset, tLeft};
+        }
+        else if (hitRight)
+        {
+            stack[top++] = {node.offset + 1, tRight};
+        }
+    }
+    return found;
+}
+
+bool BVH::occluded(const Ray& ray, float tMax) const
+{
+    if (nodes_.empty())
+    {
+        return false;
+    }
+    std::uint32_t stack[kStackSize];
+    std::size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const BVHNode& node = nodes_[stack[--top]];
+        float tEntry = 0.0F;
+        if (!RayMath::intersectBox(ray, node.bounds(), tMax, tEntry))
+        {
+            continue;
+        }
+        if (!node.isLeaf())
+        {
+            stack[top++] = node.offset + 1;
+            stack[top++] = node.offset;
+            continue;
+        }
+        for (std::uint32_t slot = node.offset; slot < node.offset + node.count; ++slot)
+        {
+            RayHit hit;
+            if (intersectPrimitive(ray, slot, tMax, hit))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::size_t BVH::queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const
+{
+    struct Entry
+    {
+        std::uint32_t node;
+        // Set once an ancestor lay entirely inside the frustum: no further tests needed.
+        bool inside;
+    };
+
+    if (nodes_.empty())
+    {
+        return 0;
+    }
+    Entry stack[kStackSize];
+    std::size_t top = 0;
+    std::size_t found = 0;
+    stack[top++] = {0, false};
+    while (top > 0)
+    {
+        Entry entry = stack[--top];
+        const BVHNode& node = nodes_[entry.node];
+        if (!entry.inside)
+        {
+            const BoundingBox bounds = node.bounds();
+            if (!frustum.intersects(bounds))
+            {
+                continue;
+            }
+            entry.inside = frustum.contains(bounds);
+        }
+        if (!node.isLeaf())
+        {
+            stack[top++] = {node.offset + 1, entry.inside};
+            stack[top++] = {node.offset, entry.inside};
+            continue;
+        }
+        for (std::uint32_t slot = node.offset; slot < node.offset + node.count; ++slot)
+        {
+            const std::uint32_t primitive = primitiveIndices_[slot];
+            if (entry.inside || frustum.intersects(primitiveBounds_[primitive]))
+            {
+                if (found < capacity)
+                {
+                    out[found] = primitive;
+                }
+                ++found;
+            }
+        }
+    }
+    return found;
+}
+} // namespace nre
@@ -0,0 +1,483 @@
+#include "Scene/DynamicBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+namespace nre
+{
+namespace
+{
+// Rotations keep sibling heights within this of each other. A tighter bound (AVL-style, one) costs
+// noticeably more surface area; six still caps trees with 32-bit ids below 97 levels.
+constexpr std::uint32_t kMaxHeightDifference = 6;
+// A depth-first traversal holds at most one entry per level plus one.
+constexpr std::size_t kQueryStackSize = 128;
+
+std::uint32_t heightDifference(std::uint32_t a, std::uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+} // namespace
+
+DynamicBVH::DynamicBVH(float margin) : margin_(std::max(margin, 0.0F)) {}
+
+void DynamicBVH::insert(std::uint32_t id, const BoundingBox& bounds)
+{
+    remove(id);
+    if (id >= objects_.size())
+    {
+        objects_.resize(static_cast<std::size_t>(id) + 1);
+    }
+    const std::uint32_t leaf = allocateNode();
+    nodes_[leaf].bounds = fatten(bounds);
+    nodes_[leaf].id = id;
+    objects_[id] = {bounds, leaf, false};
+    insertLeaf(leaf);
+    ++objectCount_;
+}
+
+void DynamicBVH::remove(std::uint32_t id)
+{
+    if (!contains(id))
+    {
+        return;
+    }
+    Object& object = objects_[id];
+    removeLeaf(object.leaf);
+    freeNode(object.leaf);
+    object.leaf = kInvalidIndex;
+    object.moved = false;
+    --objectCount_;
+}
+
+bool DynamicBVH::update(std::uint32_t id, const BoundingBox& bounds)
+{
+    if (!contains(id))
+    {
+        insert(id, bounds);
+        return false;
+    }
+    Object& object = objects_[id];
+    object.bounds = bounds;
+    const std::uint32_t leaf = object.leaf;
+    if (encloses(nodes_[leaf].bounds, bounds))
+    {
+        return false;
+    }
+
+    const BoundingBox fat = fatten(bounds);
+    if (!overlaps(nodes_[leaf].bounds, fat))
+    {
+        // Refitting would stretch every ancestor across the jump; a fresh insertion finds a better home.
+        removeLeaf(leaf);
+        nodes_[leaf].bounds = fat;
+        insertLeaf(leaf);
+        return false;
+    }
+    nodes_[leaf].bounds = fat;
+    if (!object.moved)
+    {
+        object.moved = true;
+        moved_.push_back(id);
+    }
+    return true;
+}
+
+// Every ancestor of a moved leaf is refit exactly once, lowest first, so each node sees final child
+// bounds and may rotate before its parent is visited. Rotations only reshape the subtree below the node
+// being processed, so heights taken before the pass still order the remaining nodes correctly.
+void DynamicBVH::refit()
+{
+    if (moved_.empty())
+    {
+        return;
+    }
+    if (++refitPass_ == 0)
+    {
+        for (Node& node : nodes_)
+        {
+            node.refitPass = 0;
+        }
+        refitPass_ = 1;
+    }
+
+    refitKeys_.clear();
+    for (const std::uint32_t id : moved_)
+    {
+        if (!contains(id) || !objects_[id].moved)
+        {
+            continue;
+        }
+        objects_[id].moved = false;
+        for (std::uint32_t node = nodes_[objects_[id].leaf].parent;
+             node != kInvalidIndex && nodes_[node].refitPass != refitPass_;
+             node = nodes_[node].parent)
+        {
+            nodes_[node].refitPass = refitPass_;
+            refitKeys_.push_back(static_cast<std::uint64_t>(nodes_[node].height) << 32U | node);
+        }
+    }
+    moved_.clear();
+
+    std::sort(refitKeys_.begin(), refitKeys_.end());
+    for (const std::uint64_t key : refitKeys_)
+    {
+        const auto node = static_cast<std::uint32_t>(key);
+        refitNode(node);
+        rotate(node);
+    }
+}
+
+void DynamicBVH::clear()
+{
+    nodes_.clear();
+    root_ = kInvalidIndex;
+    freeList_ = kInvalidIndex;
+    freeCount_ = 0;
+    objects_.clear();
+    objectCount_ = 0;
+    moved_.clear();
+}
+
+bool DynamicBVH::contains(std::uint32_t id) const noexcept
+{
+    return id < objects_.size() && objects_[id].leaf != kInvalidIndex;
+}
+
+std::size_t DynamicBVH::height() const noexcept
+{
+    return root_ != kInvalidIndex ? nodes_[root_].height : 0;
+}
+
+BoundingBox DynamicBVH::bounds() const noexcept
+{
+    return root_ != kInvalidIndex ? nodes_[root_].bounds : BoundingBox{};
+}
+
+std::size_t DynamicBVH::queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const
+{
+    return query(
+        [&frustum](const BoundingBox& node)
+        {
+            if (!frustum.intersects(node))
+            {
+                return Overlap::Outside;
+            }
+            return frustum.contains(node) ? Overlap::Inside : Overlap::Intersects;
+        },
+        [&frustum](const BoundingBox& object) { return frustum.intersects(object); },
+        out,
+        capacity);
+}
+
+std::size_t DynamicBVH::queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const
+{
+    return query(
+        [&box](const BoundingBox& node)
+        {
+            if (!overlaps(box, node))
+            {
+                return Overlap::Outside;
+            }
+            return encloses(box, node) ? Overlap::Inside : Overlap::Intersects;
+        },
+        [&box](const BoundingBox& object) { return overlaps(box, object); },
+        out,
+        capacity);
+}
+
+std::size_t DynamicBVH::querySphere(const BoundingSphere& sphere, std::uint32_t* out, std::size_t capacity) const
+{
+    const float radiusSquared = sphere.radius * sphere.radius;
+    return query(
+        [&sphere, radiusSquared](const BoundingBox& node)
+        {
+            if (squaredDistanceToBox(sphere.center, node) > radiusSquared)
+            {
+                return Overlap::Outside;
+            }
+            return encloses(sphere, node) ? Overlap::Inside : Overlap::Intersects;
+        },
+        [&sphere, radiusSquared](const BoundingBox& object)
+        { return squaredDistanceToBox(sphere.center, object) <= radiusSquared; },
+        out,
+        capacity);
+}
+
+std::size_t DynamicBVH::queryRay(const Ray& ray, float tMax, std::uint32_t* out, std::size_t capacity) const
+{
+    return query(
+        [&ray, tMax](const BoundingBox& node)
+        {
+            float tEntry = 0.0F;
+            return RayMath::intersectBox(ray, node, tMax, tEntry) ? Overlap::Intersects : Overlap::Outside;
+        },
+        [&ray, tMax](const BoundingBox& object)
+        {
+            float tEntry = 0.0F;
+            return RayMath::intersectBox(ray, object, tMax, tEntry);
+        },
+        out,
+        capacity);
+}
+
+std::uint32_t DynamicBVH::allocateNode()
+{
+    if (freeList_ == kInvalidIndex)
+    {
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+    const std::uint32_t node = freeList_;
+    freeList_ = nodes_[node].id;
+    --freeCount_;
+    nodes_[node] = Node{};
+    return node;
+}
+
+void DynamicBVH::freeNode(std::uint32_t node)
+{
+    nodes_[node] = Node{};
+    nodes_[node].id = freeList_;
+    freeList_ = node;
+    ++freeCount_;
+}
+
+BoundingBox DynamicBVH::fatten(const BoundingBox& bounds) const noexcept
+{
+    const Vector3 margin{margin_, margin_, margin_};
+    return {bounds.min - margin, bounds.max + margin};
+}
+
+void DynamicBVH::insertLeaf(std::uint32_t leaf)
+{
+    if (root_ == kInvalidIndex)
+    {
+        root_ = leaf;
+        nodes_[leaf].parent = kInvalidIndex;
+        return;
+    }
+    const std::uint32_t sibling = findSibling(nodes_[leaf].bounds);
+    const std::uint32_t oldParent = nodes_[sibling].parent;
+    const std::uint32_t parent = allocateNode();
+    nodes_[parent].parent = oldParent;
+    nodes_[parent].left = sibling;
+    nodes_[parent].right = leaf;
+    if (oldParent == kInvalidIndex)
+    {
+        root_ = parent;
+    }
+    else
+    {
+        swapChild(oldParent, sibling, parent);
+    }
+    nodes_[sibling].parent = parent;
+    nodes_[leaf].parent = parent;
+    refitUpwards(parent);
+}
+
+void DynamicBVH::removeLeaf(std::uint32_t leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = kInvalidIndex;
+        return;
+    }
+    const std::uint32_t parent = nodes_[leaf].parent;
+    const std::uint32_t grandparent = nodes_[parent].parent;
+    const std::uint32_t sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+    if (grandparent == kInvalidIndex)
+    {
+        root_ = sibling;
+        nodes_[sibling].parent = kInvalidIndex;
+    }
+    else
+    {
+        swapChild(grandparent, parent, sibling);
+        refitUpwards(grandparent);
+    }
+    freeNode(parent);
+    nodes_[leaf].parent = kInvalidIndex;
+}
+
+// Greedy descent on the surface-area cost: pairing with a node costs the area of the new parent, and
+// every ancestor passed on the way grows by the area the leaf adds to it.
+std::uint32_t DynamicBVH::findSibling(const BoundingBox& bounds) const noexcept
+{
+    std::uint32_t index = root_;
+    while (!nodes_[index].isLeaf())
+    {
+        const Node& node = nodes_[index];
+        const float area = halfSurfaceArea(node.bounds);
+        const float combinedArea = halfSurfaceArea(merge(node.bounds, bounds));
+        const float cost = 2.0F * combinedArea;
+        const float inheritedCost = 2.0F * (combinedArea - area);
+
+        const auto descendCost = [this, &bounds, inheritedCost](std::uint32_t child)
+        {
+            const float grown = halfSurfaceArea(merge(nodes_[child].bounds, bounds));
+            return inheritedCost + (nodes_[child].isLeaf() ? grown : grown - halfSurfaceArea(nodes_[child].bounds));
+        };
+        const float leftCost = descendCost(node.left);
+        const float rightCost = descendCost(node.right);
+        if (cost < leftCost && cost < rightCost)
+        {
+            break;
+        }
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+    return index;
+}
+
+void DynamicBVH::refitUpwards(std::uint32_t node)
+{
+    for (; node != kInvalidIndex; node = nodes_[node].parent)
+    {
+        refitNode(node);
+        rotate(node);
+    }
+}
+
+void DynamicBVH::refitNode(std::uint32_t node)
+{
+    Node& inner = nodes_[node];
+    const Node& left = nodes_[inner.left];
+    const Node& right = nodes_[inner.right];
+    inner.bounds = merge(left.bounds, right.bounds);
+    inner.height = 1 + std::max(left.height, right.height);
+}
+
+// Tries swapping either child with one of the other child's children. The node's own bounds never
+// change; only the child receiving the swapped-in node is resized. A swap is taken when it shrinks that
+// child's surface area without unbalancing the heights, or unconditionally (best area first) when the
+// children's heights already differ by more than kMaxHeightDifference.
+void DynamicBVH::rotate(std::uint32_t node)
+{
+    const std::uint32_t children[2] = {nodes_[node].left, nodes_[node].right};
+    const bool unbalanced =
+        heightDifference(nodes_[children[0]].height, nodes_[children[1]].height) > kMaxHeightDifference;
+
+    float bestGain = 0.0F;
+    bool found = false;
+    std::uint32_t bestShort = kInvalidIndex;
+    std::uint32_t bestTall = kInvalidIndex;
+    std::uint32_t bestGrandchild = kInvalidIndex;
+    for (std::size_t side = 0; side < 2; ++side)
+    {
+        const std::uint32_t shortChild = children[side];
+        const std::uint32_t tallChild = children[1 - side];
+        const Node& tall = nodes_[tallChild];
+        if (tall.isLeaf() || (unbalanced && nodes_[shortChild].height > tall.height))
+        {
+            continue;
+        }
+        const float tallArea = halfSurfaceArea(tall.bounds);
+        const std::uint32_t grandchildren[2] = {tall.left, tall.right};
+        for (std::size_t pick = 0; pick < 2; ++pick)
+        {
+            const Node& grandchild = nodes_[grandchildren[pick]];
+            const Node& kept = nodes_[grandchildren[1 - pick]];
+            const std::uint32_t shortHeight = nodes_[shortChild].height;
+            const std::uint32_t newTallHeight = 1 + std::max(shortHeight, kept.height);
+            if (heightDifference(shortHeight, kept.height) > kMaxHeightDifference
+                || heightDifference(grandchild.height, newTallHeight) > kMaxHeightDifference)
+            {
+                continue;
+            }
+            const float gain = tallArea - halfSurfaceArea(merge(nodes_[shortChild].bounds, kept.bounds));
+            if ((unbalanced && (!found || gain > bestGain)) || (!unbalanced && gain > bestGain))
+            {
+                found = true;
+                bestGain = gain;
+                bestShort = shortChild;
+                bestTall = tallChild;
+                bestGrandchild = grandchildren[pick];
+            }
+        }
+    }
+    if (bestShort == kInvalidIndex)
+    {
+        return;
+    }
+
+    swapChild(node, bestShort, bestGrandchild);
+    swapChild(bestTall, bestGrandchild, bestShort);
+    refitNode(bestTall);
+    refitNode(node);
+}
+
+void DynamicBVH::swapChild(std::uint32_t parent, std::uint32_t oldChild, std::uint32_t newChild)
+{
+    Node& node = nodes_[parent];
+    if (node.left == oldChild)
+    {
+        node.left = newChild;
+    }
+    else
+    {
+        node.right = newChild;
+    }
+    nodes_[newChild].parent = parent;
+}
+
+template <typename NodeTest, typename ObjectTest>
+std::size_t DynamicBVH::query(const NodeTest& nodeTest,
+                              const ObjectTest& objectTest,
+                              std::uint32_t* out,
+                              std::size_t capacity) const
+{
+    struct Entry
+    {
+        std::uint32_t node;
+        // Set once an ancestor's bounds lay entirely inside the query: no further tests needed.
+        bool inside;
+    };
+
+    if (root_ == kInvalidIndex)
+    {
+        return 0;
+    }
+    const Overlap rootOverlap = nodeTest(nodes_[root_].bounds);
+    if (rootOverlap == Overlap::Outside)
+    {
+        return 0;
+    }
+
+    Entry stack[kQueryStackSize];
+    std::size_t top = 0;
+    std::size_t found = 0;
+    stack[top++] = {root_, rootOverlap == Overlap::Inside};
+    while (top > 0)
+    {
+        const Entry entry = stack[--top];
+        const Node& node = nodes_[entry.node];
+        if (node.isLeaf())
+        {
+            if (entry.inside || objectTest(objects_[node.id].bounds))
+            {
+                if (found < capacity)
+                {
+                    out[found] = node.id;
+                }
+                ++found;
+            }
+            continue;
+        }
+        for (const std::uint32_t child : {node.left, node.right})
+        {
+            if (entry.inside)
+            {
+                stack[top++] = {child, true};
+                continue;
+            }
+            const Overlap overlap = nodeTest(nodes_[child].bounds);
+            if (overlap != Overlap::Outside)
+            {
+                stack[top++] = {child, overlap == Overlap::Inside};
+            }
+        }
+    }
+    return found;
+}
+} // namespace nre
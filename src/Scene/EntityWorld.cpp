@@ -0,0 +1,431 @@
+#include "Scene/EntityWorld.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+#include "Core/JobSystem.h"
+
+namespace nre
+{
+namespace
+{
+// Columns start on a 16-byte boundary so SIMD loads over whole columns stay aligned.
+constexpr std::size_t kColumnAlignment = 16;
+
+struct ComponentTypes
+{
+    std::mutex mutex;
+    std::atomic<std::uint32_t> count{0};
+    std::array<std::size_t, ComponentRegistry::kMaxComponentTypes> sizes{};
+    std::array<std::size_t, ComponentRegistry::kMaxComponentTypes> alignments{};
+};
+
+ComponentTypes& componentTypes()
+{
+    static ComponentTypes types;
+    return types;
+}
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Places the columns after the entity handles and returns the bytes a chunk of capacity entities needs.
+std::size_t layoutColumns(const std::vector<std::uint32_t>& components,
+                          std::size_t capacity,
+                          std::uint32_t* offsets)
+{
+    std::size_t end = sizeof(Entity) * capacity;
+    for (const std::uint32_t component : components)
+    {
+        const std::size_t alignment = std::max(ComponentRegistry::alignment(component), kColumnAlignment);
+        const std::size_t offset = alignUp(end, alignment);
+        offsets[component] = static_cast<std::uint32_t>(offset);
+        end = offset + ComponentRegistry::size(component) * capacity;
+    }
+    return end;
+}
+} // namespace
+
+std::uint32_t ComponentRegistry::registerType(std::size_t size, std::size_t alignment)
+{
+    ComponentTypes& types = componentTypes();
+    std::lock_guard<std::mutex> lock(types.mutex);
+    const std::uint32_t id = types.count.load(std::memory_order_relaxed);
+    if (id == kMaxComponentTypes)
+    {
+        throw std::runtime_error("Too many component types registered.");
+    }
+    types.sizes[id] = size;
+    types.alignments[id] = alignment;
+    types.count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+std::size_t ComponentRegistry::size(std::uint32_t id) noexcept
+{
+    return componentTypes().sizes[id];
+}
+
+std::size_t ComponentRegistry::alignment(std::uint32_t id) noexcept
+{
+    return componentTypes().alignments[id];
+}
+
+EntityWorld::EntityWorld()
+{
+    archetypeFor(0);
+}
+
+EntityWorld::~EntityWorld() = default;
+
+Entity EntityWorld::create()
+{
+    return createWithMask(0);
+}
+
+void EntityWorld::destroy(Entity entity)
+{
+    if (!valid(entity))
+    {
+        return;
+    }
+    EntityRecord& record = records_[entity.index];
+    eraseRow(record.archetype, record.row);
+    record.alive = false;
+    if (++record.generation == 0)
+    {
+        record.generation = 1;
+    }
+    freeIndices_.push_back(entity.index);
+    --liveCount_;
+}
+
+void EntityWorld::clear()
+{
+    archetypes_.clear();
+    archetypeIndex_.clear();
+    records_.clear();
+    freeIndices_.clear();
+    liveCount_ = 0;
+    archetypeFor(0);
+}
+
+bool EntityWorld::valid(Entity entity) const noexcept
+{
+    return entity && entity.index < records_.size() && records_[entity.index].alive
+           && records_[entity.index].generation == entity.generation;
+}
+
+ChunkView EntityWorld::chunkView(const Archetype& archetype, std::size_t chunk) noexcept
+{
+    ChunkView view;
+    view.data_ = archetype.chunks[chunk]->bytes;
+    view.count_ = std::min(archetype.capacity, archetype.size - chunk * archetype.capacity);
+    view.offsets_ = archetype.offsets;
+    return view;
+}
+
+Entity EntityWorld::createWithMask(ComponentMask mask)
+{
+    const std::uint32_t archetypeIndex = archetypeFor(mask);
+
+    std::uint32_t index = 0;
+    if (!freeIndices_.empty())
+    {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(records_.size());
+        records_.emplace_back();
+    }
+
+    Archetype& archetype = *archetypes_[archetypeIndex];
+    const std::uint32_t row = allocateRow(archetype);
+    EntityRecord& record = records_[index];
+    record.archetype = archetypeIndex;
+    record.row = row;
+    record.alive = true;
+    ++liveCount_;
+
+    const Entity entity{index, record.generation};
+    ChunkView view = chunkView(archetype, row / archetype.capacity);
+    const std::size_t slot = row % archetype.capacity;
+    std::memcpy(view.data_ + slot * sizeof(Entity), &entity, sizeof(Entity));
+    for (const std::uint32_t component : archetype.components)
+    {
+        const std::size_t size = ComponentRegistry::size(component);
+        std::memset(view.data_ + archetype.offsets[component] + slot * size, 0, size);
+    }
+    return entity;
+}
+
+void* EntityWorld::addComponent(Entity entity, std::uint32_t component)
+{
+    const std::uint32_t index = checkedIndex(entity);
+    const ComponentMask bit = ComponentMask{1} << component;
+    const ComponentMask mask = archetypes_[records_[index].archetype]->mask;
+    if ((mask & bit) == 0)
+    {
+        moveEntity(index, archetypeFor(mask | bit));
+    }
+    return componentData(entity, component);
+}
+
+void EntityWorld::removeComponent(Entity entity, std::uint32_t component)
+{
+    const std::uint32_t index = checkedIndex(entity);
+    const ComponentMask bit = ComponentMask{1} << component;
+    const ComponentMask mask = archetypes_[records_[index].archetype]->mask;
+    if ((mask & bit) != 0)
+    {
+        moveEntity(index, archetypeFor(mask & ~bit));
+    }
+}
+
+void* EntityWorld::componentData(Entity entity, std::uint32_t component)
+{
+    void* data = findComponent(entity, component);
+    if (data == nullptr)
+    {
+        throw std::runtime_error("Entity is invalid or lacks the component.");
+    }
+    return data;
+}
+
+void* EntityWorld::findComponent(Entity entity, std::uint32_t component) const noexcept
+{
+    if (!valid(entity))
+    {
+        return nullptr;
+    }
+    const EntityRecord& record = records_[entity.index];
+    const Archetype& archetype = *archetypes_[record.archetype];
+    if ((archetype.mask & (ComponentMask{1} << component)) == 0)
+    {
+        return nullptr;
+    }
+    std::byte* chunk = archetype.chunks[record.row / archetype.capacity]->bytes;
+    const std::size_t slot = record.row % archetype.capacity;
+    return chunk + archetype.offsets[component] + slot * ComponentRegistry::size(component);
+}
+
+std::uint32_t EntityWorld::checkedIndex(Entity entity) const
+{
+    if (!valid(entity))
+    {
+        throw std::runtime_error("Invalid entity handle.");
+    }
+    return entity.index;
+}
+
+std::uint32_t EntityWorld::archetypeFor(ComponentMask mask)
+{
+    if (const auto it = archetypeIndex_.find(mask); it != archetypeIndex_.end())
+    {
+        return it->second;
+    }
+
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    std::size_t rowSize = sizeof(Entity);
+    for (std::uint32_t component = 0; component < ComponentRegistry::kMaxComponentTypes; ++component)
+    {
+        if ((mask & (ComponentMask{1} << component)) != 0)
+        {
+            archetype->components.push_back(component);
+            rowSize += ComponentRegistry::size(component);
+        }
+    }
+    // Start from the padding-free estimate and back off until the aligned columns fit.
+    std::size_t capacity = kChunkSize / rowSize;
+    while (capacity > 0 && layoutColumns(archetype->components, capacity, archetype->offsets) > kChunkSize)
+    {
+        --capacity;
+    }
+    if (capacity == 0)
+    {
+        throw std::runtime_error("Entity components do not fit in a chunk.");
+    }
+    archetype->capacity = capacity;
+
+    const auto index = static_cast<std::uint32_t>(archetypes_.size());
+    archetypes_.push_back(std::move(archetype));
+    archetypeIndex_.emplace(mask, index);
+    return index;
+}
+
+std::uint32_t EntityWorld::allocateRow(Archetype& archetype)
+{
+    const std::size_t row = archetype.size;
+    if (row / archetype.capacity == archetype.chunks.size())
+    {
+        archetype.chunks.push_back(std::make_unique<ChunkStorage>());
+    }
+    ++archetype.size;
+    return static_cast<std::uint32_t>(row);
+}
+
+// Fills the row with the archetype's last entity so the chunks stay dense.
+void EntityWorld::eraseRow(std::uint32_t archetypeIndex, std::uint32_t row)
+{
+    Archetype& archetype = *archetypes_[archetypeIndex];
+    const auto last = static_cast<std::uint32_t>(archetype.size - 1);
+    if (row != last)
+    {
+        std::byte* to = archetype.chunks[row / archetype.capacity]->bytes;
+        const std::byte* from = archetype.chunks[last / archetype.capacity]->bytes;
+        const std::size_t toSlot = row % archetype.capacity;
+        const std::size_t fromSlot = last % archetype.capacity;
+
+        Entity moved;
+        std::memcpy(&moved, from + fromSlot * sizeof(Entity), sizeof(Entity));
+        std::memcpy(to + toSlot * sizeof(Entity), &moved, sizeof(Entity));
+        for (const std::uint32_t component : archetype.components)
+        {
+            const std::size_t size = ComponentRegistry::size(component);
+            const std::size_t offset = archetype.offsets[component];
+            std::memcpy(to + offset + toSlot * size, from + offset + fromSlot * size, size);
+        }
+        records_[moved.index].row = row;
+    }
+    --archetype.size;
+}
+
+// Copies the components both archetypes share, zeroes the new ones and erases the old row.
+void EntityWorld::moveEntity(std::uint32_t index, std::uint32_t archetypeIndex)
+{
+    EntityRecord& record = records_[index];
+    const std::uint32_t oldArchetypeIndex = record.archetype;
+    const std::uint32_t oldRow = record.row;
+    Archetype& target = *archetypes_[archetypeIndex];
+    const Archetype& source = *archetypes_[oldArchetypeIndex];
+
+    const std::uint32_t row = allocateRow(target);
+    std::byte* to = target.chunks[row / target.capacity]->bytes;
+    const std::byte* from = source.chunks[oldRow / source.capacity]->bytes;
+    const std::size_t toSlot = row % target.capacity;
+    const std::size_t fromSlot = oldRow % source.capacity;
+
+    const Entity entity{index, record.generation};
+    std::memcpy(to + toSlot * sizeof(Entity), &entity, sizeof(Entity));
+    for (const std::uint32_t component : target.components)
+    {
+        const std::size_t size = ComponentRegistry::size(component);
+        std::byte* destination = to + target.offsets[component] + toSlot * size;
+        if ((source.mask & (ComponentMask{1} << component)) != 0)
+        {
+            std::memcpy(destination, from + source.offsets[component] + fromSlot * size, size);
+        }
+        else
+        {
+            std::memset(destination, 0, size);
+        }
+    }
+
+    eraseRow(oldArchetypeIndex, oldRow);
+    record.archetype = archetypeIndex;
+    record.row = row;
+}
+
+void EntityWorld::gatherChunks(ComponentMask required)
+{
+    queryChunks_.clear();
+    for (const auto& archetype : archetypes_)
+    {
+        if ((archetype->mask & required) != required)
+        {
+            continue;
+        }
+        for (std::size_t chunk = 0; chunk * archetype->capacity < archetype->size; ++chunk)
+        {
+            queryChunks_.push_back(chunkView(*archetype, chunk));
+        }
+    }
+}
+
+void EntityWorld::runChunks(JobSystem* jobs, const std::function<void(const ChunkView&)>& fn)
+{
+    if (jobs != nullptr && jobs->workerCount() > 0 && queryChunks_.size() > 1)
+    {
+        jobs->parallelFor(queryChunks_.size(), [this, &fn](std::size_t index) { fn(queryChunks_[index]); });
+        return;
+    }
+    for (const ChunkView& chunk : queryChunks_)
+    {
+        fn(chunk);
+    }
+}
+
+void EntityCommandBuffer::destroy(Entity entity)
+{
+    commands_.push_back({CommandType::Destroy, entity, 0, 0, 0});
+}
+
+void EntityCommandBuffer::playback(EntityWorld& world)
+{
+    for (const Command& command : commands_)
+    {
+        switch (command.type)
+        {
+        case CommandType::Create:
+        {
+            const Entity entity = world.createWithMask(command.mask);
+            std::size_t offset = command.dataOffset;
+            for (std::uint32_t index = 0; index < command.component; ++index)
+            {
+                std::uint32_t component = 0;
+                std::memcpy(&component, data_.data() + offset, sizeof(component));
+                offset += sizeof(component);
+                const std::size_t size = ComponentRegistry::size(component);
+                std::memcpy(world.componentData(entity, component), data_.data() + offset, size);
+                offset += size;
+            }
+            break;
+        }
+        case CommandType::Destroy:
+            world.destroy(command.entity);
+            break;
+        case CommandType::Add:
+            if (world.valid(command.entity))
+            {
+                std::memcpy(world.addComponent(command.entity, command.component),
+                            data_.data() + command.dataOffset,
+                            ComponentRegistry::size(command.component));
+            }
+            break;
+        case CommandType::Remove:
+            if (world.valid(command.entity))
+            {
+                world.removeComponent(command.entity, command.component);
+            }
+            break;
+        }
+    }
+    clear();
+}
+
+void EntityCommandBuffer::clear() noexcept
+{
+    commands_.clear();
+    data_.clear();
+}
+
+void EntityCommandBuffer::appendData(const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const std::byte*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+}
+
+void EntityCommandBuffer::appendComponent(std::uint32_t component, const void* data, std::size_t size)
+{
+    appendData(&component, sizeof(component));
+    appendData(data, size);
+}
+} // namespace nre
@@ -0,0 +1,324 @@
+#include "Scene/Frustum.h"
+
+#include <cmath>
+
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+using PlaneArray = std::array<Plane, Frustum::PlaneCount>;
+
+Plane makePlane(const Matrix4& m, int row, float sign)
+{
+    const float a = m.at(3, 0) + sign * m.at(row, 0);
+    const float b = m.at(3, 1) + sign * m.at(row, 1);
+    const float c = m.at(3, 2) + sign * m.at(row, 2);
+    const float d = m.at(3, 3) + sign * m.at(row, 3);
+
+    const float length = std::sqrt(a * a + b * b + c * c);
+    if (length <= 0.0F)
+    {
+        return {{a, b, c}, d};
+    }
+    const float invLength = 1.0F / length;
+    return {{a * invLength, b * invLength, c * invLength}, d * invLength};
+}
+
+bool sphereVisible(const PlaneArray& planes, float x, float y, float z, float radius)
+{
+    for (const Plane& plane : planes)
+    {
+        if (plane.normal.x * x + plane.normal.y * y + plane.normal.z * z + plane.distance < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tests the box corner furthest along each plane normal.
+bool boxVisible(const PlaneArray& planes, const Vector3& min, const Vector3& max)
+{
+    for (const Plane& plane : planes)
+    {
+        const float x = plane.normal.x >= 0.0F ? max.x : min.x;
+        const float y = plane.normal.y >= 0.0F ? max.y : min.y;
+        const float z = plane.normal.z >= 0.0F ? max.z : min.z;
+        if (plane.normal.x * x + plane.normal.y * y + plane.normal.z * z + plane.distance < 0.0F)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tests the box corner furthest against each plane normal.
+bool boxInside(const PlaneArray& planes, const Vector3& min, const Vector3& max)
+{
+    for (const Plane& plane : planes)
+    {
+        const float x = plane.normal.x >= 0.0F ? min.x : max.x;
+        const float y = plane.normal.y >= 0.0F ? min.y : max.y;
+        const float z = plane.normal.z >= 0.0F ? min.z : max.z;
+        if (plane.normal.x * x + plane.normal.y * y + plane.normal.z * z + plane.distance < 0.0F)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t cullSpheresScalar(const PlaneArray& planes,
+                              const BoundingSphereStreams& s,
+                              std::size_t begin,
+                              std::size_t count,
+                              std::uint32_t* out)
+{
+    std::size_t written = 0;
+    for (std::size_t index = begin; index < count; ++index)
+    {
+        out[written] = static_cast<std::uint32_t>(index);
+        written += sphereVisible(planes, s.centerX[index], s.centerY[index], s.centerZ[index], s.radius[index]) ? 1U
+                                                                                                              : 0U;
+    }
+    return written;
+}
+
+std::size_t cullBoxesScalar(const PlaneArray& planes,
+                            const BoundingBoxStreams& s,
+                            std::size_t begin,
+                            std::size_t count,
+                            std::uint32_t* out)
+{
+    std::size_t written = 0;
+    for (std::size_t index = begin; index < count; ++index)
+    {
+        const Vector3 min{s.minX[index], s.minY[index], s.minZ[index]};
+        const Vector3 max{s.maxX[index], s.maxY[index], s.maxZ[index]};
+        out[written] = static_cast<std::uint32_t>(index);
+        written += boxVisible(planes, min, max) ? 1U : 0U;
+    }
+    return written;
+}
+
+// Branch-free compaction: every slot is written, but only visible lanes advance the cursor.
+// The cursor never passes the lane being written, so out needs no slack beyond count.
+std::size_t compact(unsigned int mask, std::size_t base, std::size_t lanes, std::uint32_t* out)
+{
+    std::size_t written = 0;
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+        out[written] = static_cast<std::uint32_t>(base + lane);
+        written += (mask >> lane) & 1U;
+    }
+    return written;
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 std::size_t cullSpheresSSE(const PlaneArray& planes,
+                                            const BoundingSphereStreams& s,
+                                            std::size_t begin,
+                                            std::size_t count,
+                                            std::uint32_t* out)
+{
+    std::size_t written = 0;
+    std::size_t index = begin;
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 x = _mm_loadu_ps(s.centerX + index);
+        const __m128 y = _mm_loadu_ps(s.centerY + index);
+        const __m128 z = _mm_loadu_ps(s.centerZ + index);
+        const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(s.radius + index));
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const Plane& plane : planes)
+        {
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(plane.normal.x), x);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal.y), y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal.z), z));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.distance));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negRadius));
+        }
+        written += compact(static_cast<unsigned int>(_mm_movemask_ps(visible)), index, 4, out + written);
+    }
+    return written + cullSpheresScalar(planes, s, index, count, out + written);
+}
+
+NRE_TARGET_SSE41 std::size_t cullBoxesSSE(const PlaneArray& planes,
+                                          const BoundingBoxStreams& s,
+                                          std::size_t begin,
+                                          std::size_t count,
+                                          std::uint32_t* out)
+{
+    std::size_t written = 0;
+    std::size_t index = begin;
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const Plane& plane : planes)
+        {
+            // The furthest corner is chosen per plane, so it is a stream selection rather than a blend.
+            const float* px = plane.normal.x >= 0.0F ? s.maxX : s.minX;
+            const float* py = plane.normal.y >= 0.0F ? s.maxY : s.minY;
+            const float* pz = plane.normal.z >= 0.0F ? s.maxZ : s.minZ;
+
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(plane.normal.x), _mm_loadu_ps(px + index));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal.y), _mm_loadu_ps(py + index)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal.z), _mm_loadu_ps(pz + index)));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.distance));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+        written += compact(static_cast<unsigned int>(_mm_movemask_ps(visible)), index, 4, out + written);
+    }
+    return written + cullBoxesScalar(planes, s, index, count, out + written);
+}
+
+NRE_TARGET_AVX2 std::size_t cullSpheresAVX2(const PlaneArray& planes,
+                                            const BoundingSphereStreams& s,
+                                            std::size_t count,
+                                            std::uint32_t* out)
+{
+    std::size_t written = 0;
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(s.centerX + index);
+        const __m256 y = _mm256_loadu_ps(s.centerY + index);
+        const __m256 z = _mm256_loadu_ps(s.centerZ + index);
+        const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(s.radius + index));
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const Plane& plane : planes)
+        {
+            __m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.x), x, _mm256_set1_ps(plane.distance));
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.y), y, distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.z), z, distance);
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+        written += compact(static_cast<unsigned int>(_mm256_movemask_ps(visible)), index, 8, out + written);
+    }
+    return written + cullSpheresSSE(planes, s, index, count, out + written);
+}
+
+NRE_TARGET_AVX2 std::size_t cullBoxesAVX2(const PlaneArray& planes,
+                                          const BoundingBoxStreams& s,
+                                          std::size_t count,
+                                          std::uint32_t* out)
+{
+    std::size_t written = 0;
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const Plane& plane : planes)
+        {
+            const float* px = plane.normal.x >= 0.0F ? s.maxX : s.minX;
+            const float* py = plane.normal.y >= 0.0F ? s.maxY : s.minY;
+            const float* pz = plane.normal.z >= 0.0F ? s.maxZ : s.minZ;
+
+            __m256 distance = _mm256_fmadd_ps(
+                _mm256_set1_ps(plane.normal.x), _mm256_loadu_ps(px + index), _mm256_set1_ps(plane.distance));
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.y), _mm256_loadu_ps(py + index), distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.z), _mm256_loadu_ps(pz + index), distance);
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        written += compact(static_cast<unsigned int>(_mm256_movemask_ps(visible)), index, 8, out + written);
+    }
+    return written + cullBoxesSSE(planes, s, index, count, out + written);
+}
+#endif
+} // namespace
+
+Frustum::Frustum(const Matrix4& viewProjection)
+{
+    planes_[Left] = makePlane(viewProjection, 0, 1.0F);
+    planes_[Right] = makePlane(viewProjection, 0, -1.0F);
+    planes_[Bottom] = makePlane(viewProjection, 1, 1.0F);
+    planes_[Top] = makePlane(viewProjection, 1, -1.0F);
+    planes_[Near] = makePlane(viewProjection, 2, 1.0F);
+    planes_[Far] = makePlane(viewProjection, 2, -1.0F);
+}
+
+bool Frustum::intersects(const BoundingSphere& sphere) const noexcept
+{
+    return sphereVisible(planes_, sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius);
+}
+
+bool Frustum::intersects(const BoundingBox& box) const noexcept
+{
+    return boxVisible(planes_, box.min, box.max);
+}
+
+bool Frustum::contains(const BoundingBox& box) const noexcept
+{
+    return boxInside(planes_, box.min, box.max);
+}
+
+bool Frustum::intersects(const BoundingBox& box, std::uint32_t& planeMask) const noexcept
+{
+    for (std::size_t index = 0; index < PlaneCount; ++index)
+    {
+        const std::uint32_t bit = 1U << index;
+        if ((planeMask & bit) == 0)
+        {
+            continue;
+        }
+        const Plane& plane = planes_[index];
+        const bool positiveX = plane.normal.x >= 0.0F;
+        const bool positiveY = plane.normal.y >= 0.0F;
+        const bool positiveZ = plane.normal.z >= 0.0F;
+        const float farthest = plane.normal.x * (positiveX ? box.max.x : box.min.x)
+                               + plane.normal.y * (positiveY ? box.max.y : box.min.y)
+                               + plane.normal.z * (positiveZ ? box.max.z : box.min.z) + plane.distance;
+        if (farthest < 0.0F)
+        {
+            return false;
+        }
+        const float nearest = plane.normal.x * (positiveX ? box.min.x : box.max.x)
+                              + plane.normal.y * (positiveY ? box.min.y : box.max.y)
+                              + plane.normal.z * (positiveZ ? box.min.z : box.max.z) + plane.distance;
+        if (nearest >= 0.0F)
+        {
+            planeMask &= ~bit;
+        }
+    }
+    return true;
+}
+
+std::size_t Frustum::cullSpheres(const BoundingSphereStreams& spheres,
+                                 std::size_t count,
+                                 std::uint32_t* visibleIndices) const
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return cullSpheresAVX2(planes_, spheres, count, visibleIndices);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return cullSpheresSSE(planes_, spheres, 0, count, visibleIndices);
+    }
+#endif
+    return cullSpheresScalar(planes_, spheres, 0, count, visibleIndices);
+}
+
+std::size_t Frustum::cullBoxes(const BoundingBoxStreams& boxes, std::size_t count, std::uint32_t* visibleIndices) const
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return cullBoxesAVX2(planes_, boxes, count, visibleIndices);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return cullBoxesSSE(planes_, boxes, 0, count, visibleIndices);
+    }
+#endif
+    return cullBoxesScalar(planes_, boxes, 0, count, visibleIndices);
+}
+} // namespace nre
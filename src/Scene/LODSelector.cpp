@@ -0,0 +1,275 @@
+#include "Scene/LODSelector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+#include "Renderer/LODGroup.h"
+#include "Scene/Camera.h"
+
+namespace nre
+{
+namespace
+{
+// Budgets at which each level past the first becomes selectable: an object moves to level t + 1 once its
+// budget reaches coarsen[t] and leaves it once the budget drops below refine[t].
+struct LevelThresholds
+{
+    float coarsen[LODGroup::kMaxLevels];
+    float refine[LODGroup::kMaxLevels];
+    std::size_t count = 0;
+};
+
+struct BudgetParams
+{
+    Vector3 eye;
+    float scale;
+};
+
+float errorBudget(const BudgetParams& p, float x, float y, float z, float radius)
+{
+    const float dx = x - p.eye.x;
+    const float dy = y - p.eye.y;
+    const float dz = z - p.eye.z;
+    return std::max(std::sqrt(dx * dx + dy * dy + dz * dz) - radius, 0.0F) * p.scale;
+}
+
+void budgetsScalar(const BudgetParams& p,
+                   const BoundingSphereStreams& s,
+                   std::size_t index,
+                   std::size_t count,
+                   float* out)
+{
+    for (; index < count; ++index)
+    {
+        out[index] = errorBudget(p, s.centerX[index], s.centerY[index], s.centerZ[index], s.radius[index]);
+    }
+}
+
+void selectScalar(const BudgetParams& p,
+                  const LevelThresholds& t,
+                  const BoundingSphereStreams& s,
+                  std::size_t index,
+                  std::size_t count,
+                  std::uint8_t* levels)
+{
+    for (; index < count; ++index)
+    {
+        const float budget = errorBudget(p, s.centerX[index], s.centerY[index], s.centerZ[index], s.radius[index]);
+        unsigned int coarsest = 0;
+        unsigned int finest = 0;
+        for (std::size_t level = 0; level < t.count; ++level)
+        {
+            coarsest += budget >= t.refine[level] ? 1U : 0U;
+            finest += budget >= t.coarsen[level] ? 1U : 0U;
+        }
+        const unsigned int previous = levels[index];
+        levels[index] = static_cast<std::uint8_t>(std::min(std::max(previous, finest), coarsest));
+    }
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 inline __m128 budgetSSE(const BudgetParams& p, const BoundingSphereStreams& s, std::size_t index)
+{
+    const __m128 dx = _mm_sub_ps(_mm_loadu_ps(s.centerX + index), _mm_set1_ps(p.eye.x));
+    const __m128 dy = _mm_sub_ps(_mm_loadu_ps(s.centerY + index), _mm_set1_ps(p.eye.y));
+    const __m128 dz = _mm_sub_ps(_mm_loadu_ps(s.centerZ + index), _mm_set1_ps(p.eye.z));
+    const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    const __m128 gap = _mm_sub_ps(_mm_sqrt_ps(lengthSquared), _mm_loadu_ps(s.radius + index));
+    return _mm_mul_ps(_mm_max_ps(gap, _mm_setzero_ps()), _mm_set1_ps(p.scale));
+}
+
+NRE_TARGET_SSE41 void budgetsSSE(const BudgetParams& p, const BoundingSphereStreams& s, std::size_t count, float* out)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        _mm_storeu_ps(out + index, budgetSSE(p, s, index));
+    }
+    budgetsScalar(p, s, index, count, out);
+}
+
+NRE_TARGET_SSE41 void selectSSE(const BudgetParams& p,
+                                const LevelThresholds& t,
+                                const BoundingSphereStreams& s,
+                                std::size_t count,
+                                std::uint8_t* levels)
+{
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 budget = budgetSSE(p, s, index);
+        // Compare masks are -1 per passing lane, so subtracting them counts levels.
+        __m128i coarsest = _mm_setzero_si128();
+        __m128i finest = _mm_setzero_si128();
+        for (std::size_t level = 0; level < t.count; ++level)
+        {
+            coarsest = _mm_sub_epi32(coarsest, _mm_castps_si128(_mm_cmpge_ps(budget, _mm_set1_ps(t.refine[level]))));
+            finest = _mm_sub_epi32(finest, _mm_castps_si128(_mm_cmpge_ps(budget, _mm_set1_ps(t.coarsen[level]))));
+        }
+
+        std::int32_t packed = 0;
+        std::memcpy(&packed, levels + index, sizeof(packed));
+        __m128i previous = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+        previous = _mm_min_epi32(_mm_max_epi32(previous, finest), coarsest);
+        previous = _mm_packus_epi16(_mm_packus_epi32(previous, previous), previous);
+        packed = _mm_cvtsi128_si32(previous);
+        std::memcpy(levels + index, &packed, sizeof(packed));
+    }
+    selectScalar(p, t, s, index, count, levels);
+}
+
+NRE_TARGET_AVX2 inline __m256 budgetAVX2(const BudgetParams& p, const BoundingSphereStreams& s, std::size_t index)
+{
+    const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(s.centerX + index), _mm256_set1_ps(p.eye.x));
+    const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(s.centerY + index), _mm256_set1_ps(p.eye.y));
+    const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(s.centerZ + index), _mm256_set1_ps(p.eye.z));
+    const __m256 lengthSquared = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+    const __m256 gap = _mm256_sub_ps(_mm256_sqrt_ps(lengthSquared), _mm256_loadu_ps(s.radius + index));
+    return _mm256_mul_ps(_mm256_max_ps(gap, _mm256_setzero_ps()), _mm256_set1_ps(p.scale));
+}
+
+NRE_TARGET_AVX2 void budgetsAVX2(const BudgetParams& p, const BoundingSphereStreams& s, std::size_t count, float* out)
+{
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        _mm256_storeu_ps(out + index, budgetAVX2(p, s, index));
+    }
+    budgetsScalar(p, s, index, count, out);
+}
+
+NRE_TARGET_AVX2 void selectAVX2(const BudgetParams& p,
+                                const LevelThresholds& t,
+                                const BoundingSphereStreams& s,
+                                std::size_t count,
+                                std::uint8_t* levels)
+{
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        const __m256 budget = budgetAVX2(p, s, index);
+        __m256i coarsest = _mm256_setzero_si256();
+        __m256i finest = _mm256_setzero_si256();
+        for (std::size_t level = 0; level < t.count; ++level)
+        {
+            const __m256 refine = _mm256_cmp_ps(budget, _mm256_set1_ps(t.refine[level]), _CMP_GE_OQ);
+            const __m256 coarsen = _mm256_cmp_ps(budget, _mm256_set1_ps(t.coarsen[level]), _CMP_GE_OQ);
+            coarsest = _mm256_sub_epi32(coarsest, _mm256_castps_si256(refine));
+            finest = _mm256_sub_epi32(finest, _mm256_castps_si256(coarsen));
+        }
+
+        __m256i previous = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(levels + index)));
+        previous = _mm256_min_epi32(_mm256_max_epi32(previous, finest), coarsest);
+        const __m128i words =
+            _mm_packus_epi32(_mm256_castsi256_si128(previous), _mm256_extracti128_si256(previous, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(levels + index), _mm_packus_epi16(words, words));
+    }
+    selectScalar(p, t, s, index, count, levels);
+}
+#endif
+} // namespace
+
+void LODSelector::setCamera(const Camera& camera, float viewportHeight)
+{
+    const Matrix4 cameraToWorld = camera.view().inverseAffine();
+    eye_ = {cameraToWorld.at(0, 3), cameraToWorld.at(1, 3), cameraToWorld.at(2, 3)};
+    pixelScale_ = camera.projection().at(1, 1) * viewportHeight * 0.5F;
+    updateBudgetScale();
+}
+
+void LODSelector::setErrorThreshold(float pixels)
+{
+    if (!(pixels > 0.0F))
+    {
+        throw std::runtime_error("LODSelector error threshold must be positive.");
+    }
+    threshold_ = pixels;
+    updateBudgetScale();
+}
+
+void LODSelector::setBias(float bias)
+{
+    bias_ = bias;
+    updateBudgetScale();
+}
+
+void LODSelector::setHysteresis(float fraction)
+{
+    if (!(fraction >= 0.0F))
+    {
+        throw std::runtime_error("LODSelector hysteresis must not be negative.");
+    }
+    hysteresis_ = fraction;
+}
+
+void LODSelector::updateBudgetScale() noexcept
+{
+    budgetScale_ = pixelScale_ > 0.0F ? threshold_ * std::exp2(bias_) / pixelScale_ : 0.0F;
+}
+
+void LODSelector::computeErrorBudgets(const BoundingSphereStreams& spheres, std::size_t count, float* budgets) const
+{
+    const BudgetParams params{eye_, budgetScale_};
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        budgetsAVX2(params, spheres, count, budgets);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        budgetsSSE(params, spheres, count, budgets);
+        return;
+    }
+#endif
+    budgetsScalar(params, spheres, 0, count, budgets);
+}
+
+void LODSelector::select(const BoundingSphereStreams& spheres,
+                         std::size_t count,
+                         const LODGroup& group,
+                         std::uint8_t* levels) const
+{
+    select(spheres, count, group.geometricErrors(), group.levelCount(), levels);
+}
+
+void LODSelector::select(const BoundingSphereStreams& spheres,
+                         std::size_t count,
+                         const float* levelErrors,
+                         std::size_t levelCount,
+                         std::uint8_t* levels) const
+{
+    if (levelCount == 0)
+    {
+        return;
+    }
+    const BudgetParams params{eye_, budgetScale_};
+    LevelThresholds thresholds;
+    thresholds.count = std::min(levelCount, LODGroup::kMaxLevels) - 1;
+    for (std::size_t level = 0; level < thresholds.count; ++level)
+    {
+        thresholds.coarsen[level] = levelErrors[level + 1] * (1.0F + hysteresis_);
+        thresholds.refine[level] = levelErrors[level + 1] / (1.0F + hysteresis_);
+    }
+
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        selectAVX2(params, thresholds, spheres, count, levels);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        selectSSE(params, thresholds, spheres, count, levels);
+        return;
+    }
+#endif
+    selectScalar(params, thresholds, spheres, 0, count, levels);
+}
+} // namespace nre
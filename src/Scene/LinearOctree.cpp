@@ -0,0 +1,581 @@
+#include "Scene/LinearOctree.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "Core/JobSystem.h"
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+using PlaneArray = std::array<Plane, Frustum::PlaneCount>;
+
+constexpr std::uint32_t kAxisBits = 10;
+constexpr float kAxisCells = static_cast<float>((1U << kAxisBits) - 1U);
+constexpr std::uint32_t kRadixBits = 10;
+constexpr std::size_t kRadixBuckets = std::size_t{1} << kRadixBits;
+constexpr std::uint32_t kRadixPasses = 3;
+constexpr int kCodeShift = 32;
+// Below this many elements per block the sort and bounds passes are not worth spreading across workers.
+constexpr std::size_t kMinBlockSize = 16384;
+constexpr std::size_t kGatherPrefetch = 16;
+constexpr std::size_t kLeafBatch = 64;
+constexpr std::size_t kQueryStackSize = LinearOctree::kMaxDepth * 7 + 8;
+constexpr std::size_t kLanePadding = 7;
+
+// Spreads 10 bits so that two zero bits follow each one.
+std::uint32_t expandBits(std::uint32_t value)
+{
+    value = (value * 0x00010001U) & 0xFF0000FFU;
+    value = (value * 0x00000101U) & 0x0F00F00FU;
+    value = (value * 0x00000011U) & 0xC30C30C3U;
+    value = (value * 0x00000005U) & 0x49249249U;
+    return value;
+}
+
+std::uint32_t quantize(float value, float origin, float scale)
+{
+    const float cell = std::clamp((value - origin) * scale, 0.0F, kAxisCells);
+    return static_cast<std::uint32_t>(cell);
+}
+
+std::uint32_t mortonCode(std::uint64_t key)
+{
+    return static_cast<std::uint32_t>(key >> kCodeShift);
+}
+
+// Returns the mask of lanes [first, first + lanes) that touch the frustum; inside receives the lanes that
+// lie entirely within it.
+unsigned int classifyScalar(const PlaneArray& planes,
+                            const BoundingBoxStreams& s,
+                            std::size_t first,
+                            std::size_t lanes,
+                            unsigned int& inside)
+{
+    unsigned int visible = 0;
+    inside = 0;
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+        const std::size_t index = first + lane;
+        const BoundingBox box{{s.minX[index], s.minY[index], s.minZ[index]},
+                              {s.maxX[index], s.maxY[index], s.maxZ[index]}};
+        bool touches = true;
+        bool within = true;
+        for (const Plane& plane : planes)
+        {
+            const Vector3 nearCorner{plane.normal.x >= 0.0F ? box.max.x : box.min.x,
+                                     plane.normal.y >= 0.0F ? box.max.y : box.min.y,
+                                     plane.normal.z >= 0.0F ? box.max.z : box.min.z};
+            const Vector3 farCorner{plane.normal.x >= 0.0F ? box.min.x : box.max.x,
+                                    plane.normal.y >= 0.0F ? box.min.y : box.max.y,
+                                    plane.normal.z >= 0.0F ? box.min.z : box.max.z};
+            touches = touches && Vector3::dot(plane.normal, nearCorner) + plane.distance >= 0.0F;
+            within = within && Vector3::dot(plane.normal, farCorner) + plane.distance >= 0.0F;
+        }
+        visible |= (touches ? 1U : 0U) << lane;
+        inside |= (touches && within ? 1U : 0U) << lane;
+    }
+    return visible;
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 unsigned int classifySSE(const PlaneArray& planes,
+                                          const BoundingBoxStreams& s,
+                                          std::size_t first,
+                                          std::size_t lanes,
+                                          unsigned int& inside)
+{
+    unsigned int visible = 0;
+    inside = 0;
+    for (std::size_t half = 0; half < lanes; half += 4)
+    {
+        const std::size_t index = first + half;
+        __m128 touches = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 within = touches;
+        for (const Plane& plane : planes)
+        {
+            const bool px = plane.normal.x >= 0.0F;
+            const bool py = plane.normal.y >= 0.0F;
+            const bool pz = plane.normal.z >= 0.0F;
+            const __m128 nx = _mm_set1_ps(plane.normal.x);
+            const __m128 ny = _mm_set1_ps(plane.normal.y);
+            const __m128 nz = _mm_set1_ps(plane.normal.z);
+            const __m128 d = _mm_set1_ps(plane.distance);
+
+            __m128 nearDistance = _mm_mul_ps(nx, _mm_loadu_ps((px ? s.maxX : s.minX) + index));
+            nearDistance = _mm_add_ps(nearDistance, _mm_mul_ps(ny, _mm_loadu_ps((py ? s.maxY : s.minY) + index)));
+            nearDistance = _mm_add_ps(nearDistance, _mm_mul_ps(nz, _mm_loadu_ps((pz ? s.maxZ : s.minZ) + index)));
+            nearDistance = _mm_add_ps(nearDistance, d);
+
+            __m128 farDistance = _mm_mul_ps(nx, _mm_loadu_ps((px ? s.minX : s.maxX) + index));
+            farDistance = _mm_add_ps(farDistance, _mm_mul_ps(ny, _mm_loadu_ps((py ? s.minY : s.maxY) + index)));
+            farDistance = _mm_add_ps(farDistance, _mm_mul_ps(nz, _mm_loadu_ps((pz ? s.minZ : s.maxZ) + index)));
+            farDistance = _mm_add_ps(farDistance, d);
+
+            touches = _mm_and_ps(touches, _mm_cmpge_ps(nearDistance, _mm_setzero_ps()));
+            within = _mm_and_ps(within, _mm_cmpge_ps(farDistance, _mm_setzero_ps()));
+        }
+        const auto touchMask = static_cast<unsigned int>(_mm_movemask_ps(touches));
+        visible |= touchMask << half;
+        inside |= (touchMask & static_cast<unsigned int>(_mm_movemask_ps(within))) << half;
+    }
+    const unsigned int laneMask = (1U << lanes) - 1U;
+    inside &= laneMask;
+    return visible & laneMask;
+}
+
+NRE_TARGET_AVX2 unsigned int classifyAVX2(const PlaneArray& planes,
+                                          const BoundingBoxStreams& s,
+                                          std::size_t first,
+                                          std::size_t lanes,
+                                          unsigned int& inside)
+{
+    __m256 touches = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    __m256 within = touches;
+    for (const Plane& plane : planes)
+    {
+        const bool px = plane.normal.x >= 0.0F;
+        const bool py = plane.normal.y >= 0.0F;
+        const bool pz = plane.normal.z >= 0.0F;
+        const __m256 nx = _mm256_set1_ps(plane.normal.x);
+        const __m256 ny = _mm256_set1_ps(plane.normal.y);
+        const __m256 nz = _mm256_set1_ps(plane.normal.z);
+        const __m256 d = _mm256_set1_ps(plane.distance);
+
+        __m256 nearDistance = _mm256_fmadd_ps(nx, _mm256_loadu_ps((px ? s.maxX : s.minX) + first), d);
+        nearDistance = _mm256_fmadd_ps(ny, _mm256_loadu_ps((py ? s.maxY : s.minY) + first), nearDistance);
+        nearDistance = _mm256_fmadd_ps(nz, _mm256_loadu_ps((pz ? s.maxZ : s.minZ) + first), nearDistance);
+
+        __m256 farDistance = _mm256_fmadd_ps(nx, _mm256_loadu_ps((px ? s.minX : s.maxX) + first), d);
+        farDistance = _mm256_fmadd_ps(ny, _mm256_loadu_ps((py ? s.minY : s.maxY) + first), farDistance);
+        farDistance = _mm256_fmadd_ps(nz, _mm256_loadu_ps((pz ? s.minZ : s.maxZ) + first), farDistance);
+
+        touches = _mm256_and_ps(touches, _mm256_cmp_ps(nearDistance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        within = _mm256_and_ps(within, _mm256_cmp_ps(farDistance, _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+    const unsigned int laneMask = (1U << lanes) - 1U;
+    const unsigned int visible = static_cast<unsigned int>(_mm256_movemask_ps(touches)) & laneMask;
+    inside = visible & static_cast<unsigned int>(_mm256_movemask_ps(within));
+    return visible;
+}
+#endif
+
+unsigned int classifyChildren(const PlaneArray& planes,
+                              const BoundingBoxStreams& s,
+                              std::size_t first,
+                              std::size_t lanes,
+                              unsigned int& inside)
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return classifyAVX2(planes, s, first, lanes, inside);
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return classifySSE(planes, s, first, lanes, inside);
+    }
+#endif
+    return classifyScalar(planes, s, first, lanes, inside);
+}
+} // namespace
+
+void LinearOctree::BoxStreams::resize(std::size_t count)
+{
+    minX.resize(count);
+    minY.resize(count);
+    minZ.resize(count);
+    maxX.resize(count);
+    maxY.resize(count);
+    maxZ.resize(count);
+}
+
+BoundingBoxStreams LinearOctree::BoxStreams::view(std::size_t offset) const noexcept
+{
+    return {minX.data() + offset,
+            minY.data() + offset,
+            minZ.data() + offset,
+            maxX.data() + offset,
+            maxY.data() + offset,
+            maxZ.data() + offset};
+}
+
+BoundingBox LinearOctree::BoxStreams::box(std::size_t index) const noexcept
+{
+    return {{minX[index], minY[index], minZ[index]}, {maxX[index], maxY[index], maxZ[index]}};
+}
+
+void LinearOctree::build(const BoundingBox* boxes,
+                         std::size_t count,
+                         std::size_t maxDepth,
+                         std::size_t leafCapacity,
+                         JobSystem* jobs)
+{
+    clear();
+    if (count == 0)
+    {
+        return;
+    }
+    sortByMortonCode(boxes, count, jobs);
+    buildNodes(std::min(maxDepth, kMaxDepth), std::max<std::size_t>(leafCapacity, 1));
+    computeNodeBounds(jobs);
+}
+
+void LinearOctree::clear()
+{
+    nodes_.clear();
+    nodeBounds_.resize(0);
+    objectBounds_.resize(0);
+    ids_.clear();
+}
+
+BoundingBox LinearOctree::bounds() const noexcept
+{
+    return nodes_.empty() ? BoundingBox{} : nodeBounds_.box(0);
+}
+
+void LinearOctree::sortByMortonCode(const BoundingBox* boxes, std::size_t count, JobSystem* jobs)
+{
+    const std::size_t blockCount = JobSystem::blockCount(jobs, count, kMinBlockSize);
+
+    // Quantize over the bounds of the centers so the codes use the full grid.
+    std::vector<BoundingBox> blockBounds(blockCount, emptyBox());
+    JobSystem::forEachBlock(jobs,
+                            blockCount,
+                            count,
+                            [boxes, &blockBounds](std::size_t block, std::size_t begin, std::size_t end)
+                            {
+                                BoundingBox local = emptyBox();
+                                for (std::size_t index = begin; index < end; ++index)
+                                {
+                                    const Vector3 center = (boxes[index].min + boxes[index].max) * 0.5F;
+                                    local = merge(local, {center, center});
+                                }
+                                blockBounds[block] = local;
+                            });
+    BoundingBox centers = emptyBox();
+    for (const BoundingBox& block : blockBounds)
+    {
+        centers = merge(centers, block);
+    }
+    const Vector3 extent = centers.max - centers.min;
+    const Vector3 scale{extent.x > 0.0F ? kAxisCells / extent.x : 0.0F,
+                        extent.y > 0.0F ? kAxisCells / extent.y : 0.0F,
+                        extent.z > 0.0F ? kAxisCells / extent.z : 0.0F};
+
+    keys_.resize(count);
+    sortScratch_.resize(count);
+    JobSystem::forEachBlock(jobs,
+                            blockCount,
+                            count,
+                            [this, boxes, &centers, &scale](std::size_t, std::size_t begin, std::size_t end)
+                            {
+                                for (std::size_t index = begin; index < end; ++index)
+                                {
+                                    const Vector3 center = (boxes[index].min + boxes[index].max) * 0.5F;
+                                    const std::uint32_t code =
+                                        (expandBits(quantize(center.x, centers.min.x, scale.x)) << 2)
+                                        | (expandBits(quantize(center.y, centers.min.y, scale.y)) << 1)
+                                        | expandBits(quantize(center.z, centers.min.z, scale.z));
+                                    keys_[index] = (static_cast<std::uint64_t>(code) << kCodeShift) | index;
+                                }
+                            });
+
+    // LSD radix sort on the code bits. Each block histograms its share, the per-block offsets are laid
+    // out digit-major, and every block then scatters its share stably.
+    std::vector<std::uint32_t> offsets(blockCount * kRadixBuckets);
+    for (std::uint32_t pass = 0; pass < kRadixPasses; ++pass)
+    {
+        const std::uint32_t shift = kCodeShift + pass * kRadixBits;
+        std::fill(offsets.begin(), offsets.end(), 0U);
+        JobSystem::forEachBlock(jobs,
+                                blockCount,
+                                count,
+                                [this, shift, &offsets](std::size_t block, std::size_t begin, std::size_t end)
+                                {
+                                    std::uint32_t* counts = offsets.data() + block * kRadixBuckets;
+                                    for (std::size_t index = begin; index < end; ++index)
+                                    {
+                                        ++counts[(keys_[index] >> shift) & (kRadixBuckets - 1)];
+                                    }
+                                });
+
+        std::uint32_t running = 0;
+        for (std::size_t digit = 0; digit < kRadixBuckets; ++digit)
+        {
+            for (std::size_t block = 0; block < blockCount; ++block)
+            {
+                const std::uint32_t bucket = offsets[block * kRadixBuckets + digit];
+                offsets[block * kRadixBuckets + digit] = running;
+                running += bucket;
+            }
+        }
+
+        JobSystem::forEachBlock(jobs,
+                                blockCount,
+                                count,
+                                [this, shift, &offsets](std::size_t block, std::size_t begin, std::size_t end)
+                                {
+                                    std::uint32_t* cursors = offsets.data() + block * kRadixBuckets;
+                                    for (std::size_t index = begin; index < end; ++index)
+                                    {
+                                        const std::uint64_t key = keys_[index];
+                                        sortScratch_[cursors[(key >> shift) & (kRadixBuckets - 1)]++] = key;
+                                    }
+                                });
+        keys_.swap(sortScratch_);
+    }
+
+    ids_.resize(count);
+    objectBounds_.resize(count);
+    JobSystem::forEachBlock(jobs,
+                            blockCount,
+                            count,
+                            [this, boxes](std::size_t, std::size_t begin, std::size_t end)
+                            {
+                                for (std::size_t index = begin; index < end; ++index)
+                                {
+#if defined(NRE_SIMD_X86)
+                                    // The ids jump across the input; fetch ahead to hide the misses.
+                                    if (index + kGatherPrefetch < end)
+                                    {
+                                        const std::size_t ahead =
+                                            static_cast<std::uint32_t>(keys_[index + kGatherPrefetch]);
+                                        _mm_prefetch(reinterpret_cast<const char*>(boxes + ahead), _MM_HINT_T0);
+                                    }
+#endif
+                                    const auto id = static_cast<std::uint32_t>(keys_[index]);
+                                    const BoundingBox& box = boxes[id];
+                                    ids_[index] = id;
+                                    objectBounds_.minX[index] = box.min.x;
+                                    objectBounds_.minY[index] = box.min.y;
+                                    objectBounds_.minZ[index] = box.min.z;
+                                    objectBounds_.maxX[index] = box.max.x;
+                                    objectBounds_.maxY[index] = box.max.y;
+                                    objectBounds_.maxZ[index] = box.max.z;
+                                }
+                            });
+}
+
+// Splits level by level, so nodes come out in locational-code order with siblings adjacent.
+void LinearOctree::buildNodes(std::size_t maxDepth, std::size_t leafCapacity)
+{
+    Node root;
+    root.end = static_cast<std::uint32_t>(ids_.size());
+    nodes_.push_back(root);
+
+    std::size_t levelBegin = 0;
+    for (std::size_t depth = 0; levelBegin < nodes_.size() && depth < maxDepth; ++depth)
+    {
+        const std::size_t levelEnd = nodes_.size();
+        const auto shift = static_cast<std::uint32_t>(3 * (kMaxDepth - depth - 1));
+        for (std::size_t index = levelBegin; index < levelEnd; ++index)
+        {
+            const Node node = nodes_[index];
+            if (node.end - node.begin <= leafCapacity)
+            {
+                continue;
+            }
+            const auto firstChild = static_cast<std::uint32_t>(nodes_.size());
+            std::uint32_t begin = node.begin;
+            while (begin < node.end)
+            {
+                const std::uint32_t octant = (mortonCode(keys_[begin]) >> shift) & 7U;
+                const auto split = std::partition_point(
+                    keys_.begin() + static_cast<std::ptrdiff_t>(begin),
+                    keys_.begin() + static_cast<std::ptrdiff_t>(node.end),
+                    [shift, octant](std::uint64_t key) { return ((mortonCode(key) >> shift) & 7U) <= octant; });
+
+                Node child;
+                child.key = (node.key << 3) | octant;
+                child.begin = begin;
+                child.end = static_cast<std::uint32_t>(split - keys_.begin());
+                nodes_.push_back(child);
+                begin = child.end;
+            }
+            nodes_[index].firstChild = firstChild;
+            nodes_[index].childCount = static_cast<std::uint32_t>(nodes_.size()) - firstChild;
+        }
+        levelBegin = levelEnd;
+    }
+}
+
+void LinearOctree::computeNodeBounds(JobSystem* jobs)
+{
+    nodeBounds_.resize(nodes_.size() + kLanePadding);
+    const auto store = [this](std::size_t index, const BoundingBox& box)
+    {
+        nodeBounds_.minX[index] = box.min.x;
+        nodeBounds_.minY[index] = box.min.y;
+        nodeBounds_.minZ[index] = box.min.z;
+        nodeBounds_.maxX[index] = box.max.x;
+        nodeBounds_.maxY[index] = box.max.y;
+        nodeBounds_.maxZ[index] = box.max.z;
+    };
+
+    JobSystem::forEachBlock(jobs,
+                            JobSystem::blockCount(jobs, nodes_.size(), kMinBlockSize),
+                            nodes_.size(),
+                            [this, &store](std::size_t, std::size_t begin, std::size_t end)
+                            {
+                                for (std::size_t index = begin; index < end; ++index)
+                                {
+                                    const Node& node = nodes_[index];
+                                    if (node.childCount != 0)
+                                    {
+                                        continue;
+                                    }
+                                    BoundingBox box = emptyBox();
+                                    for (std::uint32_t object = node.begin; object < node.end; ++object)
+                                    {
+                                        box = merge(box, objectBounds_.box(object));
+                                    }
+                                    store(index, box);
+                                }
+                            });
+
+    // Children always follow their parent.
+    for (std::size_t index = nodes_.size(); index-- > 0;)
+    {
+        const Node& node = nodes_[index];
+        if (node.childCount == 0)
+        {
+            continue;
+        }
+        BoundingBox box = emptyBox();
+        for (std::uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+        {
+            box = merge(box, nodeBounds_.box(child));
+        }
+        store(index, box);
+    }
+}
+
+std::size_t LinearOctree::emitRange(std::uint32_t begin,
+                                    std::uint32_t end,
+                                    std::uint32_t* out,
+                                    std::size_t found,
+                                    std::size_t capacity) const noexcept
+{
+    if (found < capacity)
+    {
+        const std::size_t copied = std::min<std::size_t>(end - begin, capacity - found);
+        std::copy_n(ids_.begin() + static_cast<std::ptrdiff_t>(begin), copied, out + found);
+    }
+    return found + (end - begin);
+}
+
+std::size_t LinearOctree::queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const
+{
+    if (nodes_.empty())
+    {
+        return 0;
+    }
+    const BoundingBox rootBox = nodeBounds_.box(0);
+    if (!frustum.intersects(rootBox))
+    {
+        return 0;
+    }
+    if (frustum.contains(rootBox))
+    {
+        return emitRange(0, nodes_[0].end, out, 0, capacity);
+    }
+
+    const BoundingBoxStreams nodeStreams = nodeBounds_.view(0);
+    std::uint32_t stack[kQueryStackSize];
+    std::uint32_t visible[kLeafBatch];
+    std::size_t top = 0;
+    std::size_t found = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const Node& node = nodes_[stack[--top]];
+        if (node.childCount == 0)
+        {
+            for (std::uint32_t begin = node.begin; begin < node.end; begin += kLeafBatch)
+            {
+                const std::size_t batch = std::min<std::size_t>(node.end - begin, kLeafBatch);
+                const std::size_t visibleCount = frustum.cullBoxes(objectBounds_.view(begin), batch, visible);
+                for (std::size_t index = 0; index < visibleCount; ++index)
+                {
+                    if (found < capacity)
+                    {
+                        out[found] = ids_[begin + visible[index]];
+                    }
+                    ++found;
+                }
+            }
+            continue;
+        }
+
+        unsigned int inside = 0;
+        const unsigned int touching =
+            classifyChildren(frustum.planes(), nodeStreams, node.firstChild, node.childCount, inside);
+        for (std::uint32_t lane = 0; lane < node.childCount; ++lane)
+        {
+            if (((inside >> lane) & 1U) != 0)
+            {
+                const Node& child = nodes_[node.firstChild + lane];
+                found = emitRange(child.begin, child.end, out, found, capacity);
+            }
+            else if (((touching >> lane) & 1U) != 0)
+            {
+                stack[top++] = node.firstChild + lane;
+            }
+        }
+    }
+    return found;
+}
+
+std::size_t LinearOctree::queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const
+{
+    if (nodes_.empty())
+    {
+        return 0;
+    }
+    std::uint32_t stack[kQueryStackSize];
+    std::size_t top = 0;
+    std::size_t found = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const std::uint32_t index = stack[--top];
+        const BoundingBox nodeBox = nodeBounds_.box(index);
+        if (!overlaps(box, nodeBox))
+        {
+            continue;
+        }
+        const Node& node = nodes_[index];
+        if (encloses(box, nodeBox))
+        {
+            found = emitRange(node.begin, node.end, out, found, capacity);
+            continue;
+        }
+        if (node.childCount == 0)
+        {
+            for (std::uint32_t object = node.begin; object < node.end; ++object)
+            {
+                if (overlaps(box, objectBounds_.box(object)))
+                {
+                    if (found < capacity)
+                    {
+                        out[found] = ids_[object];
+                    }
+                    ++found;
+                }
+            }
+            continue;
+        }
+        for (std::uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+        {
+            stack[top++] = child;
+        }
+    }
+    return found;
+}
+} // namespace nre
@@ -0,0 +1,523 @@
+#include "Scene/OcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "Core/JobSystem.h"
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+constexpr std::size_t kTileWidth = OcclusionCuller::kTileWidth;
+constexpr std::size_t kTileHeight = OcclusionCuller::kTileHeight;
+constexpr std::uint32_t kFullMask = 0xFFFFFFFFU;
+// Tile rows rasterized per task.
+constexpr std::size_t kBandTileRows = 4;
+constexpr float kPixelCenters[kTileWidth] = {0.5F, 1.5F, 2.5F, 3.5F, 4.5F, 5.5F, 6.5F, 7.5F};
+
+// Bit row * kTileWidth + column is set for each pixel center of the tile inside all three edges. Every
+// path evaluates a * x + (b * y + c) in the same order, so they agree bit for bit.
+using TileMaskFunction = std::uint32_t (*)(const float*, const float*, const float*, float, float);
+
+std::uint32_t tileMaskScalar(const float* a, const float* b, const float* c, float tileX, float tileY)
+{
+    std::uint32_t mask = 0;
+    for (std::size_t row = 0; row < kTileHeight; ++row)
+    {
+        const float y = tileY + static_cast<float>(row) + 0.5F;
+        for (std::size_t column = 0; column < kTileWidth; ++column)
+        {
+            const float x = tileX + kPixelCenters[column];
+            bool inside = true;
+            for (std::size_t edge = 0; edge < 3; ++edge)
+            {
+                inside = inside && a[edge] * x + (b[edge] * y + c[edge]) >= 0.0F;
+            }
+            if (inside)
+            {
+                mask |= 1U << (row * kTileWidth + column);
+            }
+        }
+    }
+    return mask;
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 std::uint32_t tileMaskSSE(const float* a, const float* b, const float* c, float tileX, float tileY)
+{
+    const __m128 left = _mm_add_ps(_mm_set1_ps(tileX), _mm_loadu_ps(kPixelCenters));
+    const __m128 right = _mm_add_ps(_mm_set1_ps(tileX), _mm_loadu_ps(kPixelCenters + 4));
+    __m128 columnTermsLeft[3];
+    __m128 columnTermsRight[3];
+    for (std::size_t edge = 0; edge < 3; ++edge)
+    {
+        columnTermsLeft[edge] = _mm_mul_ps(_mm_set1_ps(a[edge]), left);
+        columnTermsRight[edge] = _mm_mul_ps(_mm_set1_ps(a[edge]), right);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    std::uint32_t mask = 0;
+    for (std::size_t row = 0; row < kTileHeight; ++row)
+    {
+        const float y = tileY + static_cast<float>(row) + 0.5F;
+        __m128 insideLeft = _mm_cmpeq_ps(zero, zero);
+        __m128 insideRight = insideLeft;
+        for (std::size_t edge = 0; edge < 3; ++edge)
+        {
+            const __m128 rowTerm = _mm_set1_ps(b[edge] * y + c[edge]);
+            insideLeft = _mm_and_ps(insideLeft, _mm_cmpge_ps(_mm_add_ps(columnTermsLeft[edge], rowTerm), zero));
+            insideRight = _mm_and_ps(insideRight, _mm_cmpge_ps(_mm_add_ps(columnTermsRight[edge], rowTerm), zero));
+        }
+        const auto bits = static_cast<std::uint32_t>(_mm_movemask_ps(insideLeft))
+                          | (static_cast<std::uint32_t>(_mm_movemask_ps(insideRight)) << 4);
+        mask |= bits << (row * kTileWidth);
+    }
+    return mask;
+}
+
+NRE_TARGET_AVX2 std::uint32_t tileMaskAVX2(const float* a, const float* b, const float* c, float tileX, float tileY)
+{
+    const __m256 columns = _mm256_add_ps(_mm256_set1_ps(tileX), _mm256_loadu_ps(kPixelCenters));
+    __m256 columnTerms[3];
+    for (std::size_t edge = 0; edge < 3; ++edge)
+    {
+        columnTerms[edge] = _mm256_mul_ps(_mm256_set1_ps(a[edge]), columns);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    std::uint32_t mask = 0;
+    for (std::size_t row = 0; row < kTileHeight; ++row)
+    {
+        const float y = tileY + static_cast<float>(row) + 0.5F;
+        __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+        for (std::size_t edge = 0; edge < 3; ++edge)
+        {
+            const __m256 rowTerm = _mm256_set1_ps(b[edge] * y + c[edge]);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(columnTerms[edge], rowTerm), zero, _CMP_GE_OQ));
+        }
+        mask |= static_cast<std::uint32_t>(_mm256_movemask_ps(inside)) << (row * kTileWidth);
+    }
+    return mask;
+}
+#endif
+
+TileMaskFunction selectTileMask()
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        return tileMaskAVX2;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        return tileMaskSSE;
+    }
+#endif
+    return tileMaskScalar;
+}
+
+// Merges a triangle covering coverage with every covered pixel at or nearer than depth. A triangle far
+// behind the working layer would drag it back towards z0, so the layer is restarted from the triangle
+// instead; once the working layer covers the whole tile it becomes the new z0.
+void updateTile(float& z0, float& z1, std::uint32_t& mask, std::uint32_t coverage, float depth)
+{
+    if (depth >= z0)
+    {
+        return;
+    }
+    if (mask != 0 && depth - z1 > z0 - depth)
+    {
+        mask = 0;
+        z1 = 0.0F;
+    }
+    z1 = std::max(z1, depth);
+    mask |= coverage;
+    if (mask == kFullMask)
+    {
+        z0 = z1;
+        z1 = 0.0F;
+        mask = 0;
+    }
+}
+
+std::size_t roundUp(std::size_t value, std::size_t multiple)
+{
+    return (std::max<std::size_t>(value, 1) + multiple - 1) / multiple * multiple;
+}
+} // namespace
+
+OcclusionCuller::OcclusionCuller(std::size_t width, std::size_t height)
+{
+    resize(width, height);
+}
+
+void OcclusionCuller::resize(std::size_t width, std::size_t height)
+{
+    width_ = roundUp(width, kTileWidth);
+    height_ = roundUp(height, kTileHeight);
+    tilesX_ = width_ / kTileWidth;
+    tilesY_ = height_ / kTileHeight;
+    tiles_.assign(tilesX_ * tilesY_, Tile{});
+}
+
+void OcclusionCuller::beginFrame(const Matrix4& viewProjection)
+{
+    viewProjection_ = viewProjection;
+    std::fill(tiles_.begin(), tiles_.end(), Tile{});
+    occluders_.clear();
+}
+
+void OcclusionCuller::addOccluder(const MeshData& mesh, const Matrix4& model, bool twoSided)
+{
+    occluders_.push_back({&mesh, model, twoSided});
+}
+
+void OcclusionCuller::rasterize(JobSystem* jobs)
+{
+    const std::size_t occluderCount = occluders_.size();
+    if (triangles_.size() < occluderCount)
+    {
+        triangles_.resize(occluderCount);
+    }
+    const bool parallel = jobs != nullptr && jobs->workerCount() > 0;
+
+    const auto setup = [this](std::size_t index)
+    {
+        triangles_[index].clear();
+        setupOccluder(occluders_[index], triangles_[index]);
+    };
+    if (parallel && occluderCount > 1)
+    {
+        jobs->parallelFor(occluderCount, setup);
+    }
+    else
+    {
+        for (std::size_t index = 0; index < occluderCount; ++index)
+        {
+            setup(index);
+        }
+    }
+
+    // Bands own disjoint tiles, so they need no synchronization.
+    const std::size_t bandCount = (tilesY_ + kBandTileRows - 1) / kBandTileRows;
+    const auto band = [this](std::size_t index)
+    { rasterizeBand(index * kBandTileRows, std::min(tilesY_, (index + 1) * kBandTileRows)); };
+    if (parallel && bandCount > 1)
+    {
+        jobs->parallelFor(bandCount, band);
+    }
+    else
+    {
+        for (std::size_t index = 0; index < bandCount; ++index)
+        {
+            band(index);
+        }
+    }
+}
+
+std::size_t OcclusionCuller::triangleCount() const noexcept
+{
+    std::size_t count = 0;
+    for (std::size_t index = 0; index < occluders_.size() && index < triangles_.size(); ++index)
+    {
+        count += triangles_[index].size();
+    }
+    return count;
+}
+
+// Conservative: boxes crossing the near plane are visible, and the nearest corner depth is tested against
+// the occluder depth bound of every pixel the box's screen rectangle touches.
+bool OcclusionCuller::isVisible(const BoundingBox& box) const noexcept
+{
+    const Matrix4& m = viewProjection_;
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    float minDepth = std::numeric_limits<float>::max();
+    for (std::uint32_t corner = 0; corner < 8; ++corner)
+    {
+        const float x = (corner & 1U) != 0 ? box.max.x : box.min.x;
+        const float y = (corner & 2U) != 0 ? box.max.y : box.min.y;
+        const float z = (corner & 4U) != 0 ? box.max.z : box.min.z;
+        const float clipX = m.at(0, 0) * x + m.at(0, 1) * y + m.at(0, 2) * z + m.at(0, 3);
+        const float clipY = m.at(1, 0) * x + m.at(1, 1) * y + m.at(1, 2) * z + m.at(1, 3);
+        const float clipZ = m.at(2, 0) * x + m.at(2, 1) * y + m.at(2, 2) * z + m.at(2, 3);
+        const float clipW = m.at(3, 0) * x + m.at(3, 1) * y + m.at(3, 2) * z + m.at(3, 3);
+        if (clipZ < -clipW || clipW <= 0.0F)
+        {
+            return true;
+        }
+        const float inverseW = 1.0F / clipW;
+        const float screenX = (clipX * inverseW * 0.5F + 0.5F) * static_cast<float>(width_);
+        const float screenY = (0.5F - clipY * inverseW * 0.5F) * static_cast<float>(height_);
+        minX = std::min(minX, screenX);
+        maxX = std::max(maxX, screenX);
+        minY = std::min(minY, screenY);
+        maxY = std::max(maxY, screenY);
+        minDepth = std::min(minDepth, clipZ * inverseW * 0.5F + 0.5F);
+    }
+    if (maxX <= 0.0F || maxY <= 0.0F || minX >= static_cast<float>(width_) || minY >= static_cast<float>(height_)
+        || minDepth > 1.0F)
+    {
+        return false;
+    }
+
+    const auto firstColumn = static_cast<std::size_t>(std::max(std::floor(minX), 0.0F));
+    const auto firstRow = static_cast<std::size_t>(std::max(std::floor(minY), 0.0F));
+    const std::size_t endColumn =
+        std::max(std::min(static_cast<std::size_t>(std::ceil(maxX)), width_), firstColumn + 1);
+    const std::size_t endRow = std::max(std::min(static_cast<std::size_t>(std::ceil(maxY)), height_), firstRow + 1);
+    for (std::size_t tileY = firstRow / kTileHeight; tileY <= (endRow - 1) / kTileHeight; ++tileY)
+    {
+        const std::size_t rowBegin = std::max(firstRow, tileY * kTileHeight) - tileY * kTileHeight;
+        const std::size_t rowEnd = std::min(endRow, (tileY + 1) * kTileHeight) - tileY * kTileHeight;
+        for (std::size_t tileX = firstColumn / kTileWidth; tileX <= (endColumn - 1) / kTileWidth; ++tileX)
+        {
+            const std::size_t columnBegin = std::max(firstColumn, tileX * kTileWidth) - tileX * kTileWidth;
+            const std::size_t columnEnd = std::min(endColumn, (tileX + 1) * kTileWidth) - tileX * kTileWidth;
+            const std::uint32_t rowBits = ((1U << (columnEnd - columnBegin)) - 1U) << columnBegin;
+            std::uint32_t rectangle = 0;
+            for (std::size_t row = rowBegin; row < rowEnd; ++row)
+            {
+                rectangle |= rowBits << (row * kTileWidth);
+            }
+            const Tile& tile = tiles_[tileY * tilesX_ + tileX];
+            const float bound = (rectangle & ~tile.mask) != 0 ? tile.z0 : tile.z1;
+            if (minDepth < bound)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::size_t OcclusionCuller::cullBoxes(const BoundingBox* boxes, std::size_t count, std::uint32_t* visibleIndices) const
+{
+    std::size_t visible = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        if (isVisible(boxes[index]))
+        {
+            visibleIndices[visible++] = static_cast<std::uint32_t>(index);
+        }
+    }
+    return visible;
+}
+
+std::size_t OcclusionCuller::filterVisible(const BoundingBox* boxes,
+                                           const std::uint32_t* ids,
+                                           std::size_t count,
+                                           std::uint32_t* out) const
+{
+    std::size_t kept = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const std::uint32_t id = ids[index];
+        if (isVisible(boxes[id]))
+        {
+            out[kept++] = id;
+        }
+    }
+    return kept;
+}
+
+void OcclusionCuller::setupOccluder(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const
+{
+    const Matrix4 m = viewProjection_ * occluder.model;
+    const std::vector<Vertex>& vertices = occluder.mesh->vertices;
+    const std::vector<std::uint32_t>& indices = occluder.mesh->indices;
+    const bool indexed = !indices.empty();
+    const std::size_t cornerCount = indexed ? indices.size() : vertices.size();
+
+    ClipVertex clip[3];
+    for (std::size_t first = 0; first + 3 <= cornerCount; first += 3)
+    {
+        bool valid = true;
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::size_t vertex = indexed ? indices[first + corner] : first + corner;
+            if (vertex >= vertices.size())
+            {
+                valid = false;
+                break;
+            }
+            const float* p = vertices[vertex].position;
+            clip[corner] = {m.at(0, 0) * p[0] + m.at(0, 1) * p[1] + m.at(0, 2) * p[2] + m.at(0, 3),
+                            m.at(1, 0) * p[0] + m.at(1, 1) * p[1] + m.at(1, 2) * p[2] + m.at(1, 3),
+                            m.at(2, 0) * p[0] + m.at(2, 1) * p[1] + m.at(2, 2) * p[2] + m.at(2, 3),
+                            m.at(3, 0) * p[0] + m.at(3, 1) * p[1] + m.at(3, 2) * p[2] + m.at(3, 3)};
+        }
+        if (valid)
+        {
+            setupTriangle(clip, occluder.twoSided, triangles);
+        }
+    }
+}
+
+// Rejects triangles entirely outside one frustum plane, clips the rest against the near plane (the only
+// clip that matters; the others are handled by the screen bounds) and fans the result into screen space.
+void OcclusionCuller::setupTriangle(const ClipVertex* vertices,
+                                    bool twoSided,
+                                    std::vector<ScreenTriangle>& triangles) const
+{
+    const ClipVertex& a = vertices[0];
+    const ClipVertex& b = vertices[1];
+    const ClipVertex& c = vertices[2];
+    if ((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w)
+        || (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w)
+        || (a.z > a.w && b.z > b.w && c.z > c.w))
+    {
+        return;
+    }
+
+    ClipVertex polygon[4];
+    std::size_t count = 0;
+    for (std::size_t index = 0; index < 3; ++index)
+    {
+        const ClipVertex& current = vertices[index];
+        const ClipVertex& next = vertices[(index + 1) % 3];
+        const float currentDistance = current.z + current.w;
+        const float nextDistance = next.z + next.w;
+        if (currentDistance >= 0.0F)
+        {
+            polygon[count++] = current;
+        }
+        if ((currentDistance >= 0.0F) != (nextDistance >= 0.0F))
+        {
+            const float t = currentDistance / (currentDistance - nextDistance);
+            polygon[count++] = {current.x + (next.x - current.x) * t,
+                                current.y + (next.y - current.y) * t,
+                                current.z + (next.z - current.z) * t,
+                                current.w + (next.w - current.w) * t};
+        }
+    }
+    if (count < 3)
+    {
+        return;
+    }
+
+    ScreenVertex screen[4];
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const ClipVertex& vertex = polygon[index];
+        if (vertex.w <= 0.0F)
+        {
+            return;
+        }
+        const float inverseW = 1.0F / vertex.w;
+        screen[index] = {(vertex.x * inverseW * 0.5F + 0.5F) * static_cast<float>(width_),
+                         (0.5F - vertex.y * inverseW * 0.5F) * static_cast<float>(height_),
+                         vertex.z * inverseW * 0.5F + 0.5F};
+    }
+    for (std::size_t index = 1; index + 1 < count; ++index)
+    {
+        emitTriangle(screen[0], screen[index], screen[index + 1], twoSided, triangles);
+    }
+}
+
+void OcclusionCuller::emitTriangle(ScreenVertex a,
+                                   ScreenVertex b,
+                                   ScreenVertex c,
+                                   bool twoSided,
+                                   std::vector<ScreenTriangle>& triangles) const
+{
+    // Screen y points down, so counter-clockwise front faces have a negative area here.
+    float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+    if (area >= 0.0F)
+    {
+        if (!twoSided || area == 0.0F)
+        {
+            return;
+        }
+        std::swap(b, c);
+        area = -area;
+    }
+
+    const float minX = std::max(std::floor(std::min({a.x, b.x, c.x})), 0.0F);
+    const float minY = std::max(std::floor(std::min({a.y, b.y, c.y})), 0.0F);
+    const float maxX = std::min(std::ceil(std::max({a.x, b.x, c.x})), static_cast<float>(width_));
+    const float maxY = std::min(std::ceil(std::max({a.y, b.y, c.y})), static_cast<float>(height_));
+    if (minX >= maxX || minY >= maxY || std::min({a.z, b.z, c.z}) > 1.0F)
+    {
+        return;
+    }
+
+    ScreenTriangle triangle;
+    const ScreenVertex corners[3] = {a, b, c};
+    for (std::size_t edge = 0; edge < 3; ++edge)
+    {
+        const ScreenVertex& from = corners[edge];
+        const ScreenVertex& to = corners[(edge + 1) % 3];
+        triangle.edgeA[edge] = to.y - from.y;
+        triangle.edgeB[edge] = from.x - to.x;
+        triangle.edgeC[edge] = (to.x - from.x) * from.y - (to.y - from.y) * from.x;
+    }
+    triangle.depthA = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+    triangle.depthB = ((b.x - a.x) * (c.z - a.z) - (c.x - a.x) * (b.z - a.z)) / area;
+    triangle.depthC = a.z - triangle.depthA * a.x - triangle.depthB * a.y;
+    triangle.maxDepth = std::min(std::max({a.z, b.z, c.z}), 1.0F);
+    triangle.minX = static_cast<std::int32_t>(minX);
+    triangle.minY = static_cast<std::int32_t>(minY);
+    triangle.maxX = static_cast<std::int32_t>(maxX);
+    triangle.maxY = static_cast<std::int32_t>(maxY);
+    triangles.push_back(triangle);
+}
+
+void OcclusionCuller::rasterizeBand(std::size_t firstTileRow, std::size_t endTileRow)
+{
+    const TileMaskFunction tileMask = selectTileMask();
+    const auto bandTop = static_cast<std::int32_t>(firstTileRow * kTileHeight);
+    const auto bandBottom = static_cast<std::int32_t>(endTileRow * kTileHeight);
+    for (std::size_t occluder = 0; occluder < occluders_.size(); ++occluder)
+    {
+        for (const ScreenTriangle& triangle : triangles_[occluder])
+        {
+            const std::int32_t top = std::max(triangle.minY, bandTop);
+            const std::int32_t bottom = std::min(triangle.maxY, bandBottom);
+            if (top >= bottom)
+            {
+                continue;
+            }
+            const auto firstTileX = static_cast<std::size_t>(triangle.minX) / kTileWidth;
+            const auto lastTileX = static_cast<std::size_t>(triangle.maxX - 1) / kTileWidth;
+            const auto firstTileY = static_cast<std::size_t>(top) / kTileHeight;
+            const auto lastTileY = static_cast<std::size_t>(bottom - 1) / kTileHeight;
+            for (std::size_t tileY = firstTileY; tileY <= lastTileY; ++tileY)
+            {
+                const auto tileTop = static_cast<float>(tileY * kTileHeight);
+                const float depthTop = std::max(tileTop, static_cast<float>(triangle.minY));
+                const float depthBottom = std::min(tileTop + kTileHeight, static_cast<float>(triangle.maxY));
+                const float rowDepth =
+                    std::max(triangle.depthB * depthTop, triangle.depthB * depthBottom) + triangle.depthC;
+                for (std::size_t tileX = firstTileX; tileX <= lastTileX; ++tileX)
+                {
+                    const auto tileLeft = static_cast<float>(tileX * kTileWidth);
+                    const std::uint32_t coverage =
+                        tileMask(triangle.edgeA, triangle.edgeB, triangle.edgeC, tileLeft, tileTop);
+                    if (coverage == 0)
+                    {
+                        continue;
+                    }
+                    // Depth is planar, so its farthest point over the part of the tile inside the triangle's
+                    // bounds lies on a corner of that rectangle.
+                    const float depthLeft = std::max(tileLeft, static_cast<float>(triangle.minX));
+                    const float depthRight = std::min(tileLeft + kTileWidth, static_cast<float>(triangle.maxX));
+                    const float depth = std::min(
+                        rowDepth + std::max(triangle.depthA * depthLeft, triangle.depthA * depthRight),
+                        triangle.maxDepth);
+                    Tile& tile = tiles_[tileY * tilesX_ + tileX];
+                    updateTile(tile.z0, tile.z1, tile.mask, coverage, depth);
+                }
+            }
+        }
+    }
+}
+} // namespace nre
@@ -1,37 +1,410 @@
 #include "Scene/Octree.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace nre
 {
-OctreeNode::OctreeNode(const BoundingBox& bounds) : bounds_(bounds) {}
+namespace
+{
+constexpr std::size_t kChildCount = 8;
+// Loose bounds extend the cell by its half size on every side.
+constexpr float kLooseness = 2.0F;
+// Depth-first traversal pushes at most seven siblings per level plus the eight children of the last.
+constexpr std::size_t kQueryStackSize = Octree::kMaxDepth * (kChildCount - 1) + kChildCount;
+
+Vector3 centerOf(const BoundingBox& box)
+{
+    return (box.min + box.max) * 0.5F;
+}
+
+float halfExtentOf(const BoundingBox& box)
+{
+    const Vector3 extent = (box.max - box.min) * 0.5F;
+    return std::max(extent.x, std::max(extent.y, extent.z));
+}
+
+} // namespace
+
+Octree::Octree(const BoundingBox& bounds, std::size_t maxDepth, std::size_t nodeCapacity)
+    : bounds_(bounds), maxDepth_(std::min(maxDepth, kMaxDepth)), nodeCapacity_(std::max<std::size_t>(nodeCapacity, 1))
+{
+    // The root cell is the cube around bounds; every cell below is an exact octant of its parent.
+    Node root;
+    root.center = centerOf(bounds);
+    root.halfSize = halfExtentOf(bounds);
+    nodes_.push_back(std::move(root));
+}
 
-bool OctreeNode::isLeaf() const noexcept
+void Octree::insert(std::uint32_t id, const BoundingBox& bounds)
 {
-    for (const auto& child : children_)
+    if (contains(id))
     {
-        if (child)
+        detach(id);
+    }
+    if (id >= objects_.size())
+    {
+        objects_.resize(static_cast<std::size_t>(id) + 1);
+    }
+    objects_[id].bounds = bounds;
+    attach(id, findNode(bounds));
+}
+
+void Octree::remove(std::uint32_t id)
+{
+    if (!contains(id))
+    {
+        return;
+    }
+    const std::uint32_t node = objects_[id].node;
+    detach(id);
+
+    // Merge the highest ancestor that dropped to half capacity; the objects below it still fit its
+    // larger bounds.
+    std::uint32_t mergeRoot = kInvalidIndex;
+    for (std::uint32_t ancestor = node; ancestor != kInvalidIndex; ancestor = nodes_[ancestor].parent)
+    {
+        if (nodes_[ancestor].firstChild != kInvalidIndex && nodes_[ancestor].subtreeCount <= nodeCapacity_ / 2)
         {
-            return false;
+            mergeRoot = ancestor;
         }
     }
-    return true;
+    if (mergeRoot != kInvalidIndex)
+    {
+        collapse(mergeRoot);
+    }
 }
 
-void OctreeNode::subdivide()
+void Octree::update(std::uint32_t id, const BoundingBox& bounds)
 {
-    if (!isLeaf())
+    if (!contains(id))
+    {
+        insert(id, bounds);
+        return;
+    }
+    const std::uint32_t node = objects_[id].node;
+    const bool canDescend = nodes_[node].firstChild != kInvalidIndex && fitsChild(node, bounds);
+    if (belongsTo(node, bounds) && !canDescend)
     {
+        objects_[id].bounds = bounds;
         return;
     }
+    remove(id);
+    insert(id, bounds);
+}
+
+void Octree::clear()
+{
+    nodes_.resize(1);
+    nodes_[0].firstChild = kInvalidIndex;
+    nodes_[0].subtreeCount = 0;
+    nodes_[0].objects.clear();
+    freeBlocks_.clear();
+    objects_.clear();
+    objectCount_ = 0;
+}
+
+bool Octree::contains(std::uint32_t id) const noexcept
+{
+    return id < objects_.size() && objects_[id].node != kInvalidIndex;
+}
+
+std::size_t Octree::queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const
+{
+    return query(
+        [&frustum](const BoundingBox& node)
+        {
+            if (!frustum.intersects(node))
+            {
+                return Overlap::Outside;
+            }
+            return frustum.contains(node) ? Overlap::Inside : Overlap::Intersects;
+        },
+        [&frustum](const BoundingBox& object) { return frustum.intersects(object); },
+        out,
+        capacity);
+}
+
+std::size_t Octree::queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const
+{
+    return query(
+        [&box](const BoundingBox& node)
+        {
+            if (!overlaps(box, node))
+            {
+                return Overlap::Outside;
+            }
+            return encloses(box, node) ? Overlap::Inside : Overlap::Intersects;
+        },
+        [&box](const BoundingBox& object) { return overlaps(box, object); },
+        out,
+        capacity);
+}
+
+std::size_t Octree::querySphere(const BoundingSphere& sphere, std::uint32_t* out, std::size_t capacity) const
+{
+    const float radiusSquared = sphere.radius * sphere.radius;
+    return query(
+        [&sphere, radiusSquared](const BoundingBox& node)
+        {
+            if (squaredDistanceToBox(sphere.center, node) > radiusSquared)
+            {
+                return Overlap::Outside;
+            }
+            return encloses(sphere, node) ? Overlap::Inside : Overlap::Intersects;
+        },
+        [&sphere, radiusSquared](const BoundingBox& object)
+        { return squaredDistanceToBox(sphere.center, object) <= radiusSquared; },
+        out,
+        capacity);
+}
+
+std::size_t Octree::queryRay(const Ray& ray, float tMax, std::uint32_t* out, std::size_t capacity) const
+{
+    return query(
+        [&ray, tMax](const BoundingBox& node)
+        {
+            float tEntry = 0.0F;
+            return RayMath::intersectBox(ray, node, tMax, tEntry) ? Overlap::Intersects : Overlap::Outside;
+        },
+        [&ray, tMax](const BoundingBox& object)
+        {
+            float tEntry = 0.0F;
+            return RayMath::intersectBox(ray, object, tMax, tEntry);
+        },
+        out,
+        capacity);
+}
+
+// Descends while the object fits a child, splitting full leaves on the way.
+std::uint32_t Octree::findNode(const BoundingBox& bounds)
+{
+    const Vector3 center = centerOf(bounds);
+    std::uint32_t node = 0;
+    while (fitsChild(node, bounds))
+    {
+        if (nodes_[node].firstChild == kInvalidIndex)
+        {
+            if (nodes_[node].objects.size() < nodeCapacity_)
+            {
+                break;
+            }
+            subdivide(node);
+        }
+        node = childFor(node, center);
+    }
+    return node;
+}
 
-    for (auto& child : children_)
+// The root accepts everything, including objects outside its cell.
+bool Octree::belongsTo(std::uint32_t node, const BoundingBox& bounds) const noexcept
+{
+    if (node == 0)
     {
-        child = std::make_unique<OctreeNode>(bounds_);
+        return true;
     }
+    const Node& cell = nodes_[node];
+    const Vector3 offset = centerOf(bounds) - cell.center;
+    return std::abs(offset.x) <= cell.halfSize && std::abs(offset.y) <= cell.halfSize
+           && std::abs(offset.z) <= cell.halfSize && halfExtentOf(bounds) <= cell.halfSize;
 }
 
-Octree::Octree(const BoundingBox& bounds, std::size_t maxDepth)
-    : root_(std::make_unique<OctreeNode>(bounds)), maxDepth_(maxDepth)
+bool Octree::fitsChild(std::uint32_t node, const BoundingBox& bounds) const noexcept
 {
-    (void)maxDepth_;
+    const Node& cell = nodes_[node];
+    if (cell.depth >= maxDepth_ || halfExtentOf(bounds) > cell.halfSize * 0.5F)
+    {
+        return false;
+    }
+    const Vector3 offset = centerOf(bounds) - cell.center;
+    return std::abs(offset.x) <= cell.halfSize && std::abs(offset.y) <= cell.halfSize
+           && std::abs(offset.z) <= cell.halfSize;
+}
+
+std::uint32_t Octree::childFor(std::uint32_t node, const Vector3& point) const noexcept
+{
+    const Node& cell = nodes_[node];
+    const std::uint32_t octant = (point.x >= cell.center.x ? 1U : 0U) | (point.y >= cell.center.y ? 2U : 0U)
+                                 | (point.z >= cell.center.z ? 4U : 0U);
+    return cell.firstChild + octant;
+}
+
+void Octree::attach(std::uint32_t id, std::uint32_t node)
+{
+    std::vector<std::uint32_t>& list = nodes_[node].objects;
+    objects_[id].node = node;
+    objects_[id].slot = static_cast<std::uint32_t>(list.size());
+    list.push_back(id);
+    for (std::uint32_t ancestor = node; ancestor != kInvalidIndex; ancestor = nodes_[ancestor].parent)
+    {
+        ++nodes_[ancestor].subtreeCount;
+    }
+    ++objectCount_;
+}
+
+// Swap-removes the id from its node's list.
+void Octree::detach(std::uint32_t id)
+{
+    Object& object = objects_[id];
+    std::vector<std::uint32_t>& list = nodes_[object.node].objects;
+    const std::uint32_t last = list.back();
+    list[object.slot] = last;
+    objects_[last].slot = object.slot;
+    list.pop_back();
+    for (std::uint32_t ancestor = object.node; ancestor != kInvalidIndex; ancestor = nodes_[ancestor].parent)
+    {
+        --nodes_[ancestor].subtreeCount;
+    }
+    object.node = kInvalidIndex;
+    --objectCount_;
+}
+
+void Octree::subdivide(std::uint32_t node)
+{
+    std::uint32_t first = 0;
+    if (!freeBlocks_.empty())
+    {
+        first = freeBlocks_.back();
+        freeBlocks_.pop_back();
+    }
+    else
+    {
+        first = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.resize(nodes_.size() + kChildCount);
+    }
+
+    const Vector3 center = nodes_[node].center;
+    const float quarter = nodes_[node].halfSize * 0.5F;
+    for (std::uint32_t octant = 0; octant < kChildCount; ++octant)
+    {
+        Node& child = nodes_[first + octant];
+        child.center = {center.x + ((octant & 1U) != 0 ? quarter : -quarter),
+                        center.y + ((octant & 2U) != 0 ? quarter : -quarter),
+                        center.z + ((octant & 4U) != 0 ? quarter : -quarter)};
+        child.halfSize = quarter;
+        child.parent = node;
+        child.firstChild = kInvalidIndex;
+        child.depth = nodes_[node].depth + 1;
+        child.subtreeCount = 0;
+        child.objects.clear();
+    }
+    nodes_[node].firstChild = first;
+
+    // Push down what now fits; a detach swaps the last id into the current slot.
+    std::size_t slot = 0;
+    while (slot < nodes_[node].objects.size())
+    {
+        const std::uint32_t id = nodes_[node].objects[slot];
+        const BoundingBox& bounds = objects_[id].bounds;
+        if (fitsChild(node, bounds))
+        {
+            detach(id);
+            attach(id, childFor(node, centerOf(bounds)));
+        }
+        else
+        {
+            ++slot;
+        }
+    }
+}
+
+void Octree::collapse(std::uint32_t node)
+{
+    const std::uint32_t first = nodes_[node].firstChild;
+    for (std::uint32_t octant = 0; octant < kChildCount; ++octant)
+    {
+        gather(first + octant, node);
+    }
+    nodes_[node].firstChild = kInvalidIndex;
+    freeBlocks_.push_back(first);
+}
+
+// Moves every object below node into target and releases node's descendants.
+void Octree::gather(std::uint32_t node, std::uint32_t target)
+{
+    for (const std::uint32_t id : nodes_[node].objects)
+    {
+        objects_[id].node = target;
+        objects_[id].slot = static_cast<std::uint32_t>(nodes_[target].objects.size());
+        nodes_[target].objects.push_back(id);
+    }
+    nodes_[node].objects.clear();
+    nodes_[node].subtreeCount = 0;
+
+    const std::uint32_t first = nodes_[node].firstChild;
+    if (first != kInvalidIndex)
+    {
+        for (std::uint32_t octant = 0; octant < kChildCount; ++octant)
+        {
+            gather(first + octant, target);
+        }
+        nodes_[node].firstChild = kInvalidIndex;
+        freeBlocks_.push_back(first);
+    }
+}
+
+BoundingBox Octree::looseBounds(const Node& node) const noexcept
+{
+    const float extent = node.halfSize * kLooseness;
+    const Vector3 offset{extent, extent, extent};
+    return {node.center - offset, node.center + offset};
+}
+
+template <typename NodeTest, typename ObjectTest>
+std::size_t Octree::query(const NodeTest& nodeTest,
+                          const ObjectTest& objectTest,
+                          std::uint32_t* out,
+                          std::size_t capacity) const
+{
+    struct Entry
+    {
+        std::uint32_t node;
+        // Set once an ancestor's bounds lay entirely inside the query: no further tests needed.
+        bool inside;
+    };
+
+    Entry stack[kQueryStackSize];
+    std::size_t top = 0;
+    std::size_t found = 0;
+    stack[top++] = {0, false};
+    while (top > 0)
+    {
+        const Entry entry = stack[--top];
+        const Node& node = nodes_[entry.node];
+        for (const std::uint32_t id : node.objects)
+        {
+            if (entry.inside || objectTest(objects_[id].bounds))
+            {
+                if (found < capacity)
+                {
+                    out[found] = id;
+                }
+                ++found;
+            }
+        }
+        if (node.firstChild == kInvalidIndex)
+        {
+            continue;
+        }
+        for (std::uint32_t octant = 0; octant < kChildCount; ++octant)
+        {
+            const std::uint32_t child = node.firstChild + octant;
+            if (nodes_[child].subtreeCount == 0)
+            {
+                continue;
+            }
+            if (entry.inside)
+            {
+                stack[top++] = {child, true};
+                continue;
+            }
+            const Overlap overlap = nodeTest(looseBounds(nodes_[child]));
+            if (overlap != Overlap::Outside)
+            {
+                stack[top++] = {child, overlap == Overlap::Inside};
+            }
+        }
+    }
+    return found;
 }
 } // namespace nre
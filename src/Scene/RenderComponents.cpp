@@ -0,0 +1,70 @@
+#include "Scene/RenderComponents.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace nre
+{
+void updateWorldTransforms(EntityWorld& world, JobSystem* jobs)
+{
+    world.parallelForEachChunk<Transform, WorldTransform>(
+        jobs,
+        [](const ChunkView& chunk)
+        {
+            const Transform* transforms = chunk.column<Transform>();
+            WorldTransform* worlds = chunk.column<WorldTransform>();
+            for (std::size_t index = 0; index < chunk.size(); ++index)
+            {
+                worlds[index].matrix = transforms[index].localMatrix();
+            }
+        });
+}
+
+void updateWorldBounds(EntityWorld& world, JobSystem* jobs)
+{
+    world.parallelForEachChunk<LocalBounds, WorldTransform, WorldBounds>(
+        jobs,
+        [](const ChunkView& chunk)
+        {
+            const LocalBounds* locals = chunk.column<LocalBounds>();
+            const WorldTransform* worlds = chunk.column<WorldTransform>();
+            WorldBounds* bounds = chunk.column<WorldBounds>();
+            for (std::size_t index = 0; index < chunk.size(); ++index)
+            {
+                bounds[index].box = transformBounds(locals[index].box, worlds[index].matrix);
+            }
+        });
+}
+
+void collectDrawItems(EntityWorld& world, const Frustum& frustum, std::vector<DrawItem>& out)
+{
+    out.clear();
+    world.forEachChunk<MeshComponent, MaterialComponent, WorldTransform>(
+        [&frustum, &out](const ChunkView& chunk)
+        {
+            const MeshComponent* meshes = chunk.column<MeshComponent>();
+            const MaterialComponent* materials = chunk.column<MaterialComponent>();
+            const WorldTransform* worlds = chunk.column<WorldTransform>();
+            const WorldBounds* bounds = chunk.column<WorldBounds>();
+            for (std::size_t index = 0; index < chunk.size(); ++index)
+            {
+                if (meshes[index].mesh == nullptr || (bounds != nullptr && !frustum.intersects(bounds[index].box)))
+                {
+                    continue;
+                }
+                out.push_back({meshes[index].mesh, materials[index].material, worlds[index].matrix});
+            }
+        });
+    std::sort(out.begin(),
+              out.end(),
+              [](const DrawItem& lhs, const DrawItem& rhs)
+              {
+                  const std::less<const void*> less;
+                  if (lhs.material != rhs.material)
+                  {
+                      return less(lhs.material, rhs.material);
+                  }
+                  return less(lhs.mesh, rhs.mesh);
+              });
+}
+} // namespace nre
@@ -0,0 +1,433 @@
+#include "Scene/SceneFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "Scene/TransformHierarchy.h"
+
+namespace nre
+{
+namespace
+{
+// "NRSC" read as a little-endian integer.
+constexpr std::uint32_t kMagic = 0x4353524EU;
+constexpr std::uint32_t kByteOrderMark = 0x01020304U;
+constexpr std::size_t kSectionAlignment = 16;
+
+enum Section : std::uint32_t
+{
+    Parents,
+    SubtreeEnds,
+    PositionX,
+    PositionY,
+    PositionZ,
+    RotationX,
+    RotationY,
+    RotationZ,
+    RotationW,
+    ScaleX,
+    ScaleY,
+    ScaleZ,
+    BoundsMinX,
+    BoundsMinY,
+    BoundsMinZ,
+    BoundsMaxX,
+    BoundsMaxY,
+    BoundsMaxZ,
+    BoundsFlags,
+    MeshIndices,
+    MaterialIndices,
+    MeshNames,
+    MaterialNames,
+    Strings,
+    SectionCount
+};
+
+struct FileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t sectionCount;
+    std::uint64_t fileSize;
+    std::uint64_t nodeCount;
+    std::uint64_t meshCount;
+    std::uint64_t materialCount;
+};
+
+struct SectionEntry
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(FileHeader) == 48 && sizeof(SectionEntry) == 16, "Scene file records must not be padded");
+
+struct StringRecord
+{
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Element size of each section; Strings holds bytes.
+std::size_t elementSize(std::uint32_t section)
+{
+    switch (section)
+    {
+    case BoundsFlags:
+    case Strings:
+        return 1;
+    case MeshNames:
+    case MaterialNames:
+        return sizeof(StringRecord);
+    default:
+        return 4;
+    }
+}
+
+[[noreturn]] void corrupt(const std::string& path, const char* reason)
+{
+    throw std::runtime_error("Invalid scene file '" + path + "': " + reason);
+}
+
+// Serialized sections, built in memory and then laid out behind the header.
+struct SectionData
+{
+    std::vector<std::byte> bytes[SectionCount];
+
+    template <typename T>
+    void append(std::uint32_t section, const T& value)
+    {
+        const auto* data = reinterpret_cast<const std::byte*>(&value);
+        bytes[section].insert(bytes[section].end(), data, data + sizeof(T));
+    }
+};
+} // namespace
+
+SceneFile::SceneFile(const std::string& path) : file_(path)
+{
+    const std::byte* data = file_.data();
+    const std::size_t size = file_.size();
+    if (size < sizeof(FileHeader))
+    {
+        corrupt(path, "truncated header");
+    }
+    FileHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kMagic)
+    {
+        corrupt(path, "not a scene file");
+    }
+    if (header.byteOrder != kByteOrderMark)
+    {
+        corrupt(path, "written with a different byte order");
+    }
+    if (header.version != kVersion)
+    {
+        corrupt(path, "unsupported version");
+    }
+    if (header.sectionCount != SectionCount || header.fileSize != size
+        || size < sizeof(FileHeader) + sizeof(SectionEntry) * SectionCount)
+    {
+        corrupt(path, "truncated or malformed section table");
+    }
+
+    const auto* table = reinterpret_cast<const SectionEntry*>(data + sizeof(FileHeader));
+    const std::byte* sections[SectionCount] = {};
+    for (std::uint32_t section = 0; section < SectionCount; ++section)
+    {
+        const SectionEntry& entry = table[section];
+        if (entry.offset % kSectionAlignment != 0 || entry.offset > size || entry.size > size - entry.offset)
+        {
+            corrupt(path, "section out of range");
+        }
+        if (section != Strings)
+        {
+            // The counts come from the file, so compare them against the size by division: multiplying
+            // could wrap around and accept a short section.
+            const std::uint64_t count = section < MeshNames    ? header.nodeCount
+                                        : section == MeshNames ? header.meshCount
+                                                               : header.materialCount;
+            const std::uint64_t element = elementSize(section);
+            if (entry.size % element != 0 || count != entry.size / element)
+            {
+                corrupt(path, "section size mismatch");
+            }
+        }
+        sections[section] = data + entry.offset;
+    }
+    // Every count now matches a section inside the mapping, so it fits in std::size_t.
+    nodeCount_ = static_cast<std::size_t>(header.nodeCount);
+    meshCount_ = static_cast<std::size_t>(header.meshCount);
+    materialCount_ = static_cast<std::size_t>(header.materialCount);
+
+    const auto floats = [&sections](std::uint32_t section)
+    { return reinterpret_cast<const float*>(sections[section]); };
+    parents_ = reinterpret_cast<const std::uint32_t*>(sections[Parents]);
+    subtreeEnds_ = reinterpret_cast<const std::uint32_t*>(sections[SubtreeEnds]);
+    transforms_ = {floats(PositionX),
+                   floats(PositionY),
+                   floats(PositionZ),
+                   floats(RotationX),
+                   floats(RotationY),
+                   floats(RotationZ),
+                   floats(RotationW),
+                   floats(ScaleX),
+                   floats(ScaleY),
+                   floats(ScaleZ)};
+    bounds_ = {floats(BoundsMinX),
+               floats(BoundsMinY),
+               floats(BoundsMinZ),
+               floats(BoundsMaxX),
+               floats(BoundsMaxY),
+               floats(BoundsMaxZ)};
+    boundsFlags_ = reinterpret_cast<const std::uint8_t*>(sections[BoundsFlags]);
+    meshIndices_ = reinterpret_cast<const std::uint32_t*>(sections[MeshIndices]);
+    materialIndices_ = reinterpret_cast<const std::uint32_t*>(sections[MaterialIndices]);
+    meshNames_ = reinterpret_cast<const StringRef*>(sections[MeshNames]);
+    materialNames_ = reinterpret_cast<const StringRef*>(sections[MaterialNames]);
+    strings_ = reinterpret_cast<const char*>(sections[Strings]);
+
+    // The traversal guarantees everything else relies on: parents first and properly nested subtrees.
+    for (std::size_t node = 0; node < nodeCount_; ++node)
+    {
+        const std::uint32_t parent = parents_[node];
+        const std::uint32_t end = subtreeEnds_[node];
+        if (end <= node || end > nodeCount_)
+        {
+            corrupt(path, "bad subtree range");
+        }
+        if (parent != kInvalidIndex && (parent >= node || end > subtreeEnds_[parent]))
+        {
+            corrupt(path, "nodes out of depth-first order");
+        }
+        if ((meshIndices_[node] != kInvalidIndex && meshIndices_[node] >= meshCount_)
+            || (materialIndices_[node] != kInvalidIndex && materialIndices_[node] >= materialCount_))
+        {
+            corrupt(path, "mesh or material index out of range");
+        }
+    }
+    const std::uint64_t stringBytes = table[Strings].size;
+    const auto validStrings = [stringBytes](const StringRef* names, std::size_t count)
+    {
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            if (std::uint64_t{names[index].offset} + names[index].length > stringBytes)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!validStrings(meshNames_, meshCount_) || !validStrings(materialNames_, materialCount_))
+    {
+        corrupt(path, "name out of range");
+    }
+}
+
+std::string_view SceneFile::meshName(std::size_t mesh) const
+{
+    if (mesh >= meshCount_)
+    {
+        throw std::runtime_error("Scene file mesh index out of range");
+    }
+    return {strings_ + meshNames_[mesh].offset, meshNames_[mesh].length};
+}
+
+std::string_view SceneFile::materialName(std::size_t material) const
+{
+    if (material >= materialCount_)
+    {
+        throw std::runtime_error("Scene file material index out of range");
+    }
+    return {strings_ + materialNames_[material].offset, materialNames_[material].length};
+}
+
+void SceneFile::computeWorldMatrices(Matrix4* out) const
+{
+    Transform::composeLocalMatrices(transforms_, out, nodeCount_);
+    for (std::size_t node = 0; node < nodeCount_; ++node)
+    {
+        if (parents_[node] != kInvalidIndex)
+        {
+            out[node] = out[parents_[node]] * out[node];
+        }
+    }
+}
+
+std::uint32_t SceneFileBuilder::addMesh(const std::string& name)
+{
+    meshes_.push_back(name);
+    return static_cast<std::uint32_t>(meshes_.size() - 1);
+}
+
+std::uint32_t SceneFileBuilder::addMaterial(const std::string& name)
+{
+    materials_.push_back(name);
+    return static_cast<std::uint32_t>(materials_.size() - 1);
+}
+
+std::uint32_t SceneFileBuilder::addNode(std::uint32_t parent,
+                                        const Transform& local,
+                                        const BoundingBox* bounds,
+                                        std::uint32_t mesh,
+                                        std::uint32_t material)
+{
+    std::size_t depth = 0;
+    if (parent != SceneFile::kInvalidIndex)
+    {
+        const auto it = std::find(openPath_.rbegin(), openPath_.rend(), parent);
+        if (it == openPath_.rend())
+        {
+            throw std::runtime_error("Scene file nodes must be added in depth-first order");
+        }
+        depth = static_cast<std::size_t>(openPath_.rend() - it);
+    }
+    if ((mesh != SceneFile::kInvalidIndex && mesh >= meshes_.size())
+        || (material != SceneFile::kInvalidIndex && material >= materials_.size()))
+    {
+        throw std::runtime_error("Scene file mesh or material index out of range");
+    }
+
+    const auto index = static_cast<std::uint32_t>(parents_.size());
+    openPath_.resize(depth);
+    openPath_.push_back(index);
+    parents_.push_back(parent);
+    transforms_.push_back(local);
+    bounds_.push_back(bounds != nullptr ? *bounds : BoundingBox{});
+    boundsFlags_.push_back(bounds != nullptr ? 1 : 0);
+    meshIndices_.push_back(mesh);
+    materialIndices_.push_back(material);
+    return index;
+}
+
+std::uint32_t SceneFileBuilder::addHierarchy(const TransformHierarchy& hierarchy, std::uint32_t parent)
+{
+    const auto first = static_cast<std::uint32_t>(parents_.size());
+    const std::uint32_t* parents = hierarchy.parentIndices();
+    for (std::uint32_t index = 0; index < hierarchy.size(); ++index)
+    {
+        const std::uint32_t localParent = parents[index];
+        addNode(localParent != TransformHierarchy::kInvalidIndex ? first + localParent : parent,
+                hierarchy.localTransform(hierarchy.handleAt(index)));
+    }
+    return first;
+}
+
+void SceneFileBuilder::write(const std::string& path) const
+{
+    const std::size_t nodeCount = parents_.size();
+    std::vector<std::uint32_t> subtreeEnds(nodeCount);
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        subtreeEnds[node] = static_cast<std::uint32_t>(node + 1);
+    }
+    for (std::size_t node = nodeCount; node-- > 0;)
+    {
+        if (parents_[node] != SceneFile::kInvalidIndex)
+        {
+            subtreeEnds[parents_[node]] = std::max(subtreeEnds[parents_[node]], subtreeEnds[node]);
+        }
+    }
+
+    SectionData sections;
+    for (std::uint32_t section = 0; section < MeshNames; ++section)
+    {
+        sections.bytes[section].reserve(nodeCount * elementSize(section));
+    }
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        const Transform& transform = transforms_[node];
+        const BoundingBox& box = bounds_[node];
+        sections.append(Parents, parents_[node]);
+        sections.append(SubtreeEnds, subtreeEnds[node]);
+        sections.append(PositionX, transform.position().x);
+        sections.append(PositionY, transform.position().y);
+        sections.append(PositionZ, transform.position().z);
+        sections.append(RotationX, transform.rotation().x);
+        sections.append(RotationY, transform.rotation().y);
+        sections.append(RotationZ, transform.rotation().z);
+        sections.append(RotationW, transform.rotation().w);
+        sections.append(ScaleX, transform.scale().x);
+        sections.append(ScaleY, transform.scale().y);
+        sections.append(ScaleZ, transform.scale().z);
+        sections.append(BoundsMinX, box.min.x);
+        sections.append(BoundsMinY, box.min.y);
+        sections.append(BoundsMinZ, box.min.z);
+        sections.append(BoundsMaxX, box.max.x);
+        sections.append(BoundsMaxY, box.max.y);
+        sections.append(BoundsMaxZ, box.max.z);
+        sections.append(BoundsFlags, boundsFlags_[node]);
+        sections.append(MeshIndices, meshIndices_[node]);
+        sections.append(MaterialIndices, materialIndices_[node]);
+    }
+    const auto appendNames = [&sections](std::uint32_t section, const std::vector<std::string>& names)
+    {
+        for (const std::string& name : names)
+        {
+            const StringRecord record{static_cast<std::uint32_t>(sections.bytes[Strings].size()),
+                                      static_cast<std::uint32_t>(name.size())};
+            sections.append(section, record);
+            const auto* bytes = reinterpret_cast<const std::byte*>(name.data());
+            sections.bytes[Strings].insert(sections.bytes[Strings].end(), bytes, bytes + name.size());
+        }
+    };
+    appendNames(MeshNames, meshes_);
+    appendNames(MaterialNames, materials_);
+
+    SectionEntry table[SectionCount] = {};
+    std::size_t cursor = sizeof(FileHeader) + sizeof(table);
+    for (std::uint32_t section = 0; section < SectionCount; ++section)
+    {
+        cursor = alignUp(cursor, kSectionAlignment);
+        table[section] = {cursor, sections.bytes[section].size()};
+        cursor += sections.bytes[section].size();
+    }
+    const FileHeader header{kMagic,
+                            SceneFile::kVersion,
+                            kByteOrderMark,
+                            SectionCount,
+                            cursor,
+                            nodeCount,
+                            meshes_.size(),
+                            materials_.size()};
+
+    std::vector<std::byte> file(cursor);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + sizeof(header), table, sizeof(table));
+    for (std::uint32_t section = 0; section < SectionCount; ++section)
+    {
+        if (!sections.bytes[section].empty())
+        {
+            std::memcpy(file.data() + table[section].offset, sections.bytes[section].data(), table[section].size);
+        }
+    }
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!stream)
+    {
+        throw std::runtime_error("Failed to write scene file: " + path);
+    }
+}
+
+void SceneFileBuilder::clear()
+{
+    meshes_.clear();
+    materials_.clear();
+    parents_.clear();
+    transforms_.clear();
+    bounds_.clear();
+    boundsFlags_.clear();
+    meshIndices_.clear();
+    materialIndices_.clear();
+    openPath_.clear();
+}
+} // namespace nre
@@ -1,16 +1,30 @@
 #include "Scene/SceneGraph.h"
 
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
 #include "Scene/Transform.h"
 
 namespace nre
 {
-SceneNode::SceneNode() : transform_(std::make_unique<Transform>()) {}
+namespace
+{
+// Traversal depth that keeps its own plane mask; deeper nodes reuse the mask of the deepest tracked
+// ancestor, which only costs redundant plane tests.
+constexpr std::size_t kCullStackSize = 64;
+} // namespace
+
+SceneNode::SceneNode(TransformHierarchy& hierarchy, NodeHandle parent)
+    : hierarchy_(&hierarchy), handle_(hierarchy.create(parent))
+{
+}
 
 SceneNode::~SceneNode() = default;
 
 SceneNode& SceneNode::addChild()
 {
-    children_.push_back(std::make_unique<SceneNode>());
+    children_.push_back(std::make_unique<SceneNode>(*hierarchy_, handle_));
     return *children_.back();
 }
 
@@ -19,15 +33,263 @@ const std::vector<std::unique_ptr<SceneNode>>& SceneNode::children() const noexc
     return children_;
 }
 
-Transform& SceneNode::transform() noexcept
+Transform SceneNode::transform() const
+{
+    return hierarchy_->localTransform(handle_);
+}
+
+void SceneNode::setTransform(const Transform& transform)
+{
+    hierarchy_->setLocalTransform(handle_, transform);
+}
+
+void SceneNode::setPosition(const Vector3& position)
+{
+    hierarchy_->setPosition(handle_, position);
+}
+
+void SceneNode::setRotation(const Quaternion& rotation)
 {
-    return *transform_;
+    hierarchy_->setRotation(handle_, rotation);
+}
+
+void SceneNode::setScale(const Vector3& scale)
+{
+    hierarchy_->setScale(handle_, scale);
+}
+
+const Matrix4& SceneNode::worldMatrix() const
+{
+    return hierarchy_->worldMatrix(handle_);
+}
+
+SceneGraph::SceneGraph()
+    : hierarchy_(std::make_unique<TransformHierarchy>()), root_(std::make_unique<SceneNode>(*hierarchy_, NodeHandle{}))
+{
+}
+
+std::size_t SceneGraph::updateWorldMatrices(JobSystem* jobs)
+{
+    const std::size_t updated = hierarchy_->updateWorldMatrices(jobs);
+    const Matrix4* world = hierarchy_->worldMatrices();
+    if (worldBounds_.size() < localBounds_.size())
+    {
+        worldBounds_.resize(localBounds_.size());
+    }
+    const bool rebuild = subtreeVersion_ != hierarchy_->structureVersion();
+    for (const std::uint32_t index : hierarchy_->updatedIndices())
+    {
+        const std::uint32_t slot = hierarchy_->handleAt(index).slot;
+        if (slot < hasBounds_.size() && hasBounds_[slot] != 0)
+        {
+            worldBounds_[slot] = transformBounds(localBounds_[slot], world[index]);
+            spatialIndex_.update(slot, worldBounds_[slot]);
+            if (!rebuild)
+            {
+                markSubtreeDirty(index);
+            }
+        }
+    }
+    for (const NodeHandle node : pendingBounds_)
+    {
+        if (!hierarchy_->valid(node))
+        {
+            continue;
+        }
+        if (hasBounds_[node.slot] != 0)
+        {
+            worldBounds_[node.slot] = transformBounds(localBounds_[node.slot], hierarchy_->worldMatrix(node));
+            spatialIndex_.update(node.slot, worldBounds_[node.slot]);
+        }
+        if (!rebuild)
+        {
+            markSubtreeDirty(hierarchy_->denseIndex(node));
+        }
+    }
+    pendingBounds_.clear();
+    spatialIndex_.refit();
+
+    if (rebuild)
+    {
+        rebuildSubtreeBounds();
+    }
+    else
+    {
+        refreshDirtySubtrees();
+    }
+    return updated;
 }
 
-const Transform& SceneNode::transform() const noexcept
+void SceneGraph::setLocalBounds(NodeHandle node, const BoundingBox& bounds)
 {
-    return *transform_;
+    if (!hierarchy_->valid(node))
+    {
+        throw std::runtime_error("Invalid scene node handle");
+    }
+    if (node.slot >= localBounds_.size())
+    {
+        localBounds_.resize(static_cast<std::size_t>(node.slot) + 1);
+        hasBounds_.resize(static_cast<std::size_t>(node.slot) + 1, 0);
+    }
+    localBounds_[node.slot] = bounds;
+    hasBounds_[node.slot] = 1;
+    pendingBounds_.push_back(node);
 }
 
-SceneGraph::SceneGraph() : root_(std::make_unique<SceneNode>()) {}
+void SceneGraph::clearLocalBounds(NodeHandle node)
+{
+    if (!hierarchy_->valid(node))
+    {
+        throw std::runtime_error("Invalid scene node handle");
+    }
+    // Nodes that never had bounds have nothing to clear, and no entry in hasBounds_ for the update.
+    if (node.slot >= hasBounds_.size() || hasBounds_[node.slot] == 0)
+    {
+        return;
+    }
+    hasBounds_[node.slot] = 0;
+    spatialIndex_.remove(node.slot);
+    pendingBounds_.push_back(node);
+}
+
+BoundingBox SceneGraph::subtreeBounds(NodeHandle node) const
+{
+    checkSubtreeBounds();
+    return subtreeBounds_[hierarchy_->denseIndex(node)];
+}
+
+std::size_t SceneGraph::cullFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const
+{
+    checkSubtreeBounds();
+
+    struct Level
+    {
+        std::uint32_t end;
+        std::uint32_t planeMask;
+    };
+    Level stack[kCullStackSize];
+    std::size_t depth = 0;
+    std::size_t found = 0;
+    const std::uint32_t* subtreeEnds = hierarchy_->subtreeEnds();
+    const auto count = static_cast<std::uint32_t>(subtreeBounds_.size());
+    const auto emit = [out, capacity, &found](std::uint32_t slot)
+    {
+        if (found < capacity)
+        {
+            out[found] = slot;
+        }
+        ++found;
+    };
+
+    std::uint32_t index = 0;
+    while (index < count)
+    {
+        while (depth > 0 && stack[depth - 1].end <= index)
+        {
+            --depth;
+        }
+        std::uint32_t planeMask = depth > 0 ? stack[depth - 1].planeMask : Frustum::kAllPlanes;
+        const std::uint32_t end = subtreeEnds[index];
+        if (!frustum.intersects(subtreeBounds_[index], planeMask))
+        {
+            index = end;
+            continue;
+        }
+        if (planeMask == 0)
+        {
+            for (; index < end; ++index)
+            {
+                const std::uint32_t slot = hierarchy_->handleAt(index).slot;
+                if (slot < hasBounds_.size() && hasBounds_[slot] != 0)
+                {
+                    emit(slot);
+                }
+            }
+            continue;
+        }
+
+        const std::uint32_t slot = hierarchy_->handleAt(index).slot;
+        if (slot < hasBounds_.size() && hasBounds_[slot] != 0)
+        {
+            // A leaf's own box is its subtree box, which just passed.
+            std::uint32_t ownMask = planeMask;
+            if (end == index + 1 || frustum.intersects(worldBounds_[slot], ownMask))
+            {
+                emit(slot);
+            }
+        }
+        if (end > index + 1 && depth < kCullStackSize)
+        {
+            stack[depth++] = {end, planeMask};
+        }
+        ++index;
+    }
+    return found;
+}
+
+void SceneGraph::checkSubtreeBounds() const
+{
+    if (subtreeVersion_ != hierarchy_->structureVersion())
+    {
+        throw std::runtime_error("Scene nodes changed since the last updateWorldMatrices()");
+    }
+}
+
+BoundingBox SceneGraph::ownBounds(std::uint32_t index) const noexcept
+{
+    const std::uint32_t slot = hierarchy_->handleAt(index).slot;
+    return slot < hasBounds_.size() && hasBounds_[slot] != 0 ? worldBounds_[slot] : emptyBox();
+}
+
+// Children follow their parents in the dense order, so one backward pass folds every box into its parent.
+void SceneGraph::rebuildSubtreeBounds()
+{
+    const std::size_t count = hierarchy_->size();
+    const std::uint32_t* parents = hierarchy_->parentIndices();
+    subtreeBounds_.resize(count);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        subtreeBounds_[index] = ownBounds(static_cast<std::uint32_t>(index));
+    }
+    for (std::size_t index = count; index-- > 0;)
+    {
+        if (parents[index] != TransformHierarchy::kInvalidIndex)
+        {
+            subtreeBounds_[parents[index]] = merge(subtreeBounds_[parents[index]], subtreeBounds_[index]);
+        }
+    }
+    subtreeDirty_.assign(count, 0);
+    dirtySubtrees_.clear();
+    subtreeVersion_ = hierarchy_->structureVersion();
+}
+
+// Queues the node and its ancestors; stops at the first ancestor already queued.
+void SceneGraph::markSubtreeDirty(std::uint32_t index)
+{
+    const std::uint32_t* parents = hierarchy_->parentIndices();
+    while (index != TransformHierarchy::kInvalidIndex && subtreeDirty_[index] == 0)
+    {
+        subtreeDirty_[index] = 1;
+        dirtySubtrees_.push_back(index);
+        index = parents[index];
+    }
+}
+
+// Recomputes the queued nodes children first, each from its own box and its direct children's boxes.
+void SceneGraph::refreshDirtySubtrees()
+{
+    const std::uint32_t* subtreeEnds = hierarchy_->subtreeEnds();
+    std::sort(dirtySubtrees_.begin(), dirtySubtrees_.end(), std::greater<>());
+    for (const std::uint32_t index : dirtySubtrees_)
+    {
+        BoundingBox bounds = ownBounds(index);
+        for (std::uint32_t child = index + 1; child < subtreeEnds[index]; child = subtreeEnds[child])
+        {
+            bounds = merge(bounds, subtreeBounds_[child]);
+        }
+        subtreeBounds_[index] = bounds;
+        subtreeDirty_[index] = 0;
+    }
+    dirtySubtrees_.clear();
+}
 } // namespace nre
@@ -0,0 +1,337 @@
+#include "Scene/SpatialHashGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "Core/JobSystem.h"
+
+namespace nre
+{
+namespace
+{
+// Cell coordinates are clamped to 21 signed bits per axis so a cell packs into one 64-bit key. Objects
+// beyond the outermost cells share them, which the queries account for.
+constexpr std::uint32_t kCellBits = 21;
+constexpr std::int32_t kCellBias = 1 << (kCellBits - 1);
+constexpr std::uint64_t kCellMask = (std::uint64_t{1} << kCellBits) - 1;
+constexpr std::uint64_t kOversizedCell = ~std::uint64_t{0};
+constexpr std::size_t kMinBuckets = 64;
+// Objects with a larger half extent, in cells, are kept out of the grid so they do not widen every query.
+constexpr float kMaxHalfExtentInCells = 1.0F;
+// Below this many objects per block the build passes are not worth spreading across workers.
+constexpr std::size_t kMinBlockSize = 16384;
+
+std::uint64_t packCell(std::int32_t x, std::int32_t y, std::int32_t z)
+{
+    return (static_cast<std::uint64_t>(x + kCellBias) << (2 * kCellBits))
+           | (static_cast<std::uint64_t>(y + kCellBias) << kCellBits) | static_cast<std::uint64_t>(z + kCellBias);
+}
+
+std::int32_t unpackAxis(std::uint64_t cell, std::uint32_t shift)
+{
+    return static_cast<std::int32_t>((cell >> shift) & kCellMask) - kCellBias;
+}
+
+// Fibonacci hashing; the high bits of the product mix all three coordinates.
+std::uint32_t bucketOf(std::uint64_t cell, std::size_t bucketCount)
+{
+    const auto hash = static_cast<std::uint32_t>((cell * 0x9E3779B97F4A7C15ULL) >> 32);
+    return hash & static_cast<std::uint32_t>(bucketCount - 1);
+}
+
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) : cellSize_(1.0F), inverseCellSize_(1.0F)
+{
+    setCellSize(cellSize);
+}
+
+void SpatialHashGrid::setCellSize(float cellSize)
+{
+    if (!(cellSize > 0.0F))
+    {
+        throw std::runtime_error("SpatialHashGrid cell size must be positive");
+    }
+    cellSize_ = cellSize;
+    inverseCellSize_ = 1.0F / cellSize;
+    clear();
+}
+
+// Two passes over the objects. The first computes every object's cell and bucket and histograms the
+// buckets per block; the offsets are then laid out bucket-major so the second pass can scatter each
+// block's objects stably and without synchronization. Oversized objects go to one extra bucket past the
+// hashed ones.
+void SpatialHashGrid::build(const BoundingBox* boxes, std::size_t count, JobSystem* jobs)
+{
+    std::size_t bucketCount = kMinBuckets;
+    while (bucketCount < count * 2)
+    {
+        bucketCount *= 2;
+    }
+    const std::size_t slotCount = bucketCount + 1;
+    const std::size_t blockCount = JobSystem::blockCount(jobs, count, kMinBlockSize);
+    const float maxHalfExtent = cellSize_ * kMaxHalfExtentInCells;
+
+    objectCells_.resize(count);
+    objectBuckets_.resize(count);
+    offsets_.assign(blockCount * slotCount, 0U);
+    std::vector<Vector3> blockExtents(blockCount);
+    JobSystem::forEachBlock(jobs,
+                            blockCount,
+                            count,
+                            [this, boxes, bucketCount, slotCount, maxHalfExtent, &blockExtents](std::size_t block,
+                                                                                                std::size_t begin,
+                                                                                                std::size_t end)
+                            {
+                                std::uint32_t* counts = offsets_.data() + block * slotCount;
+                                Vector3 extent;
+                                for (std::size_t index = begin; index < end; ++index)
+                                {
+                                    const BoundingBox& box = boxes[index];
+                                    const Vector3 halfExtent = (box.max - box.min) * 0.5F;
+                                    if (halfExtent.x > maxHalfExtent || halfExtent.y > maxHalfExtent
+                                        || halfExtent.z > maxHalfExtent)
+                                    {
+                                        objectCells_[index] = kOversizedCell;
+                                        objectBuckets_[index] = static_cast<std::uint32_t>(bucketCount);
+                                        ++counts[bucketCount];
+                                        continue;
+                                    }
+                                    const std::uint64_t cell = packCell(cellCoordinate((box.min.x + box.max.x) * 0.5F),
+                                                                        cellCoordinate((box.min.y + box.max.y) * 0.5F),
+                                                                        cellCoordinate((box.min.z + box.max.z) * 0.5F));
+                                    const std::uint32_t bucket = bucketOf(cell, bucketCount);
+                                    objectCells_[index] = cell;
+                                    objectBuckets_[index] = bucket;
+                                    ++counts[bucket];
+                                    extent.x = std::max(extent.x, halfExtent.x);
+                                    extent.y = std::max(extent.y, halfExtent.y);
+                                    extent.z = std::max(extent.z, halfExtent.z);
+                                }
+                                blockExtents[block] = extent;
+                            });
+
+    maxHalfExtent_ = {};
+    for (const Vector3& extent : blockExtents)
+    {
+        maxHalfExtent_.x = std::max(maxHalfExtent_.x, extent.x);
+        maxHalfExtent_.y = std::max(maxHalfExtent_.y, extent.y);
+        maxHalfExtent_.z = std::max(maxHalfExtent_.z, extent.z);
+    }
+
+    bucketStart_.resize(slotCount + 1);
+    std::uint32_t running = 0;
+    for (std::size_t bucket = 0; bucket < slotCount; ++bucket)
+    {
+        bucketStart_[bucket] = running;
+        for (std::size_t block = 0; block < blockCount; ++block)
+        {
+            const std::uint32_t blockCountInBucket = offsets_[block * slotCount + bucket];
+            offsets_[block * slotCount + bucket] = running;
+            running += blockCountInBucket;
+        }
+    }
+    bucketStart_[slotCount] = running;
+
+    ids_.resize(count);
+    cells_.resize(count);
+    bounds_.resize(count);
+    JobSystem::forEachBlock(jobs,
+                            blockCount,
+                            count,
+                            [this, boxes, slotCount](std::size_t block, std::size_t begin, std::size_t end)
+                            {
+                                std::uint32_t* cursors = offsets_.data() + block * slotCount;
+                                for (std::size_t index = begin; index < end; ++index)
+                                {
+                                    const std::uint32_t slot = cursors[objectBuckets_[index]]++;
+                                    ids_[slot] = static_cast<std::uint32_t>(index);
+                                    cells_[slot] = objectCells_[index];
+                                    bounds_[slot] = boxes[index];
+                                }
+                            });
+}
+
+void SpatialHashGrid::clear()
+{
+    ids_.clear();
+    cells_.clear();
+    bounds_.clear();
+    bucketStart_.clear();
+    maxHalfExtent_ = {};
+}
+
+// Walks the entries in bucket order and tests each run of entries from one cell against the cell's
+// widened bounds first, so whole cells are rejected or accepted with one test.
+std::size_t SpatialHashGrid::queryFrustum(const Frustum& frustum, std::uint32_t* out, std::size_t capacity) const
+{
+    if (ids_.empty())
+    {
+        return 0;
+    }
+    std::size_t found = 0;
+    const std::size_t bucketCount = this->bucketCount();
+    const std::size_t count = bucketStart_[bucketCount];
+    for (std::uint32_t entry = bucketStart_[bucketCount]; entry < bucketStart_[bucketCount + 1]; ++entry)
+    {
+        if (frustum.intersects(bounds_[entry]))
+        {
+            if (found < capacity)
+            {
+                out[found] = ids_[entry];
+            }
+            ++found;
+        }
+    }
+    std::size_t begin = 0;
+    while (begin < count)
+    {
+        const std::uint64_t cell = cells_[begin];
+        std::size_t end = begin + 1;
+        while (end < count && cells_[end] == cell)
+        {
+            ++end;
+        }
+        const BoundingBox bounds = cellBounds(cell);
+        if (frustum.intersects(bounds))
+        {
+            const bool inside = frustum.contains(bounds);
+            for (std::size_t entry = begin; entry < end; ++entry)
+            {
+                if (inside || frustum.intersects(bounds_[entry]))
+                {
+                    if (found < capacity)
+                    {
+                        out[found] = ids_[entry];
+                    }
+                    ++found;
+                }
+            }
+        }
+        begin = end;
+    }
+    return found;
+}
+
+std::size_t SpatialHashGrid::queryBox(const BoundingBox& box, std::uint32_t* out, std::size_t capacity) const
+{
+    return queryRange(box, [&box](const BoundingBox& object) { return overlaps(box, object); }, out, capacity);
+}
+
+std::size_t SpatialHashGrid::querySphere(const BoundingSphere& sphere, std::uint32_t* out, std::size_t capacity) const
+{
+    const float radiusSquared = sphere.radius * sphere.radius;
+    const Vector3 radius{sphere.radius, sphere.radius, sphere.radius};
+    return queryRange({sphere.center - radius, sphere.center + radius},
+                      [&sphere, radiusSquared](const BoundingBox& object)
+                      { return squaredDistanceToBox(sphere.center, object) <= radiusSquared; },
+                      out,
+                      capacity);
+}
+
+std::int32_t SpatialHashGrid::cellCoordinate(float value) const noexcept
+{
+    const float cell = std::floor(value * inverseCellSize_);
+    return static_cast<std::int32_t>(
+        std::clamp(cell, -static_cast<float>(kCellBias), static_cast<float>(kCellBias - 1)));
+}
+
+// Cells holding the centers of all objects that can overlap box.
+SpatialHashGrid::CellRange SpatialHashGrid::cellRange(const BoundingBox& box) const noexcept
+{
+    const Vector3 min = box.min - maxHalfExtent_;
+    const Vector3 max = box.max + maxHalfExtent_;
+    return {{cellCoordinate(min.x), cellCoordinate(min.y), cellCoordinate(min.z)},
+            {cellCoordinate(max.x), cellCoordinate(max.y), cellCoordinate(max.z)}};
+}
+
+// The cell widened by the largest half extent, which encloses every object centered in it. The outermost
+// cells also hold everything clamped into them, so they are unbounded on their outer side.
+BoundingBox SpatialHashGrid::cellBounds(std::uint64_t cell) const noexcept
+{
+    constexpr float kUnbounded = std::numeric_limits<float>::max();
+    const std::int32_t coordinates[3] = {unpackAxis(cell, 2 * kCellBits), unpackAxis(cell, kCellBits),
+                                         unpackAxis(cell, 0)};
+    float min[3];
+    float max[3];
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        const std::int32_t coordinate = coordinates[axis];
+        min[axis] = coordinate == -kCellBias ? -kUnbounded : static_cast<float>(coordinate) * cellSize_;
+        max[axis] = coordinate == kCellBias - 1 ? kUnbounded : static_cast<float>(coordinate + 1) * cellSize_;
+    }
+    return {{min[0] - maxHalfExtent_.x, min[1] - maxHalfExtent_.y, min[2] - maxHalfExtent_.z},
+            {max[0] + maxHalfExtent_.x, max[1] + maxHalfExtent_.y, max[2] + maxHalfExtent_.z}};
+}
+
+template <typename ObjectTest>
+std::size_t SpatialHashGrid::queryRange(const BoundingBox& box,
+                                        const ObjectTest& objectTest,
+                                        std::uint32_t* out,
+                                        std::size_t capacity) const
+{
+    std::size_t found = 0;
+    const auto emit = [&found, out, capacity](std::uint32_t id)
+    {
+        if (found < capacity)
+        {
+            out[found] = id;
+        }
+        ++found;
+    };
+    if (ids_.empty())
+    {
+        return 0;
+    }
+    const std::size_t bucketCount = this->bucketCount();
+    for (std::uint32_t entry = bucketStart_[bucketCount]; entry < bucketStart_[bucketCount + 1]; ++entry)
+    {
+        if (objectTest(bounds_[entry]))
+        {
+            emit(ids_[entry]);
+        }
+    }
+
+    const CellRange range = cellRange(box);
+    std::uint64_t cellCount = 1;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        cellCount *= static_cast<std::uint64_t>(range.max[axis] - range.min[axis]) + 1;
+    }
+    if (cellCount > bucketStart_[bucketCount])
+    {
+        // Probing more cells than there are objects costs more than testing them all.
+        for (std::size_t entry = 0; entry < bucketStart_[bucketCount]; ++entry)
+        {
+            if (objectTest(bounds_[entry]))
+            {
+                emit(ids_[entry]);
+            }
+        }
+        return found;
+    }
+
+    for (std::int32_t x = range.min[0]; x <= range.max[0]; ++x)
+    {
+        for (std::int32_t y = range.min[1]; y <= range.max[1]; ++y)
+        {
+            for (std::int32_t z = range.min[2]; z <= range.max[2]; ++z)
+            {
+                const std::uint64_t cell = packCell(x, y, z);
+                const std::uint32_t bucket = bucketOf(cell, bucketCount);
+                // Other cells may share the bucket; the cell check keeps them from being reported twice.
+                for (std::uint32_t entry = bucketStart_[bucket]; entry < bucketStart_[bucket + 1]; ++entry)
+                {
+                    if (cells_[entry] == cell && objectTest(bounds_[entry]))
+                    {
+                        emit(ids_[entry]);
+                    }
+                }
+            }
+        }
+    }
+    return found;
+}
+} // namespace nre
@@ -1,7 +1,285 @@
 #include "Scene/Transform.h"
 
+#include "Math/SIMD_Intrinsics.h"
+#include "Math/SIMD_Math.h"
+
 namespace nre
 {
+namespace
+{
+void composeScalar(const TransformStreams& s, std::size_t index, float* m)
+{
+    const float x = s.rotationX[index];
+    const float y = s.rotationY[index];
+    const float z = s.rotationZ[index];
+    const float w = s.rotationW[index];
+    const float sx = s.scaleX[index];
+    const float sy = s.scaleY[index];
+    const float sz = s.scaleZ[index];
+
+    const float xx = x * x;
+    const float yy = y * y;
+    const float zz = z * z;
+    const float xy = x * y;
+    const float xz = x * z;
+    const float yz = y * z;
+    const float wx = w * x;
+    const float wy = w * y;
+    const float wz = w * z;
+
+    m[0] = (1.0F - 2.0F * (yy + zz)) * sx;
+    m[1] = (2.0F * (xy + wz)) * sx;
+    m[2] = (2.0F * (xz - wy)) * sx;
+    m[3] = 0.0F;
+
+    m[4] = (2.0F * (xy - wz)) * sy;
+    m[5] = (1.0F - 2.0F * (xx + zz)) * sy;
+    m[6] = (2.0F * (yz + wx)) * sy;
+    m[7] = 0.0F;
+
+    m[8] = (2.0F * (xz + wy)) * sz;
+    m[9] = (2.0F * (yz - wx)) * sz;
+    m[10] = (1.0F - 2.0F * (xx + yy)) * sz;
+    m[11] = 0.0F;
+
+    m[12] = s.positionX[index];
+    m[13] = s.positionY[index];
+    m[14] = s.positionZ[index];
+    m[15] = 1.0F;
+}
+
+TransformStreams offsetStreams(const TransformStreams& s, std::size_t offset)
+{
+    TransformStreams result = s;
+    result.positionX += offset;
+    result.positionY += offset;
+    result.positionZ += offset;
+    result.rotationX += offset;
+    result.rotationY += offset;
+    result.rotationZ += offset;
+    result.rotationW += offset;
+    result.scaleX += offset;
+    result.scaleY += offset;
+    result.scaleZ += offset;
+    return result;
+}
+
+void composeBatchScalar(const Matrix4* parent, const TransformStreams& streams, Matrix4* out, std::size_t count)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        composeScalar(streams, index, out[index].dataPtr());
+        if (parent != nullptr)
+        {
+            SIMDMath::multiply4x4Scalar(parent->dataPtr(), out[index].dataPtr(), out[index].dataPtr(), 1);
+        }
+    }
+}
+
+#if defined(NRE_SIMD_X86)
+NRE_TARGET_SSE41 void composeBatchSSE(const Matrix4* parent,
+                                      const TransformStreams& s,
+                                      Matrix4* out,
+                                      std::size_t count)
+{
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 two = _mm_set1_ps(2.0F);
+    const __m128 zero = _mm_setzero_ps();
+
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 x = _mm_loadu_ps(s.rotationX + index);
+        const __m128 y = _mm_loadu_ps(s.rotationY + index);
+        const __m128 z = _mm_loadu_ps(s.rotationZ + index);
+        const __m128 w = _mm_loadu_ps(s.rotationW + index);
+        const __m128 sx = _mm_loadu_ps(s.scaleX + index);
+        const __m128 sy = _mm_loadu_ps(s.scaleY + index);
+        const __m128 sz = _mm_loadu_ps(s.scaleZ + index);
+
+        const __m128 xx = _mm_mul_ps(x, x);
+        const __m128 yy = _mm_mul_ps(y, y);
+        const __m128 zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y);
+        const __m128 xz = _mm_mul_ps(x, z);
+        const __m128 yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x);
+        const __m128 wy = _mm_mul_ps(w, y);
+        const __m128 wz = _mm_mul_ps(w, z);
+
+        __m128 m[16];
+        m[0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        m[1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        m[2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+        m[3] = zero;
+        m[4] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        m[5] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        m[6] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+        m[7] = zero;
+        m[8] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        m[9] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        m[10] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+        m[11] = zero;
+        m[12] = _mm_loadu_ps(s.positionX + index);
+        m[13] = _mm_loadu_ps(s.positionY + index);
+        m[14] = _mm_loadu_ps(s.positionZ + index);
+        m[15] = one;
+
+        if (parent != nullptr)
+        {
+            const float* p = parent->dataPtr();
+            __m128 world[16];
+            for (std::size_t column = 0; column < 4; ++column)
+            {
+                const std::size_t c = column * 4;
+                for (std::size_t row = 0; row < 4; ++row)
+                {
+                    __m128 value = _mm_mul_ps(_mm_set1_ps(p[row]), m[c + 0]);
+                    value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(p[4 + row]), m[c + 1]));
+                    value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(p[8 + row]), m[c + 2]));
+                    value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(p[12 + row]), m[c + 3]));
+                    world[c + row] = value;
+                }
+            }
+            for (std::size_t element = 0; element < 16; ++element)
+            {
+                m[element] = world[element];
+            }
+        }
+
+        for (std::size_t group = 0; group < 16; group += 4)
+        {
+            __m128 r0 = m[group + 0];
+            __m128 r1 = m[group + 1];
+            __m128 r2 = m[group + 2];
+            __m128 r3 = m[group + 3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_store_ps(out[index + 0].dataPtr() + group, r0);
+            _mm_store_ps(out[index + 1].dataPtr() + group, r1);
+            _mm_store_ps(out[index + 2].dataPtr() + group, r2);
+            _mm_store_ps(out[index + 3].dataPtr() + group, r3);
+        }
+    }
+
+    if (index < count)
+    {
+        composeBatchScalar(parent, offsetStreams(s, index), out + index, count - index);
+    }
+}
+
+// Eight transforms per iteration: the 16 matrix entries are built in SoA registers and transposed on store.
+NRE_TARGET_AVX2 void composeBatchAVX2(const Matrix4* parent,
+                                      const TransformStreams& s,
+                                      Matrix4* out,
+                                      std::size_t count)
+{
+    const __m256 one = _mm256_set1_ps(1.0F);
+    const __m256 two = _mm256_set1_ps(2.0F);
+    const __m256 zero = _mm256_setzero_ps();
+
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(s.rotationX + index);
+        const __m256 y = _mm256_loadu_ps(s.rotationY + index);
+        const __m256 z = _mm256_loadu_ps(s.rotationZ + index);
+        const __m256 w = _mm256_loadu_ps(s.rotationW + index);
+        const __m256 sx = _mm256_loadu_ps(s.scaleX + index);
+        const __m256 sy = _mm256_loadu_ps(s.scaleY + index);
+        const __m256 sz = _mm256_loadu_ps(s.scaleZ + index);
+
+        const __m256 xx = _mm256_mul_ps(x, x);
+        const __m256 yy = _mm256_mul_ps(y, y);
+        const __m256 zz = _mm256_mul_ps(z, z);
+        const __m256 xy = _mm256_mul_ps(x, y);
+        const __m256 xz = _mm256_mul_ps(x, z);
+        const __m256 yz = _mm256_mul_ps(y, z);
+        const __m256 wx = _mm256_mul_ps(w, x);
+        const __m256 wy = _mm256_mul_ps(w, y);
+        const __m256 wz = _mm256_mul_ps(w, z);
+
+        __m256 m[16];
+        m[0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx);
+        m[1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+        m[2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+        m[3] = zero;
+        m[4] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+        m[5] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy);
+        m[6] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+        m[7] = zero;
+        m[8] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+        m[9] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+        m[10] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz);
+        m[11] = zero;
+        m[12] = _mm256_loadu_ps(s.positionX + index);
+        m[13] = _mm256_loadu_ps(s.positionY + index);
+        m[14] = _mm256_loadu_ps(s.positionZ + index);
+        m[15] = one;
+
+        if (parent != nullptr)
+        {
+            // The local matrix is affine, so its last row (0, 0, 0, 1) folds away.
+            const float* p = parent->dataPtr();
+            __m256 world[16];
+            for (std::size_t column = 0; column < 4; ++column)
+            {
+                const std::size_t c = column * 4;
+                for (std::size_t row = 0; row < 4; ++row)
+                {
+                    __m256 value = _mm256_mul_ps(_mm256_set1_ps(p[row]), m[c + 0]);
+                    value = _mm256_fmadd_ps(_mm256_set1_ps(p[4 + row]), m[c + 1], value);
+                    value = _mm256_fmadd_ps(_mm256_set1_ps(p[8 + row]), m[c + 2], value);
+                    if (column == 3)
+                    {
+                        value = _mm256_add_ps(value, _mm256_set1_ps(p[12 + row]));
+                    }
+                    world[c + row] = value;
+                }
+            }
+            for (std::size_t element = 0; element < 16; ++element)
+            {
+                m[element] = world[element];
+            }
+        }
+
+        __m256 low[8];
+        __m256 high[8];
+        simd::transpose8x8(m, low);
+        simd::transpose8x8(m + 8, high);
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            float* destination = out[index + lane].dataPtr();
+            _mm256_storeu_ps(destination, low[lane]);
+            _mm256_storeu_ps(destination + 8, high[lane]);
+        }
+    }
+
+    if (index < count)
+    {
+        composeBatchSSE(parent, offsetStreams(s, index), out + index, count - index);
+    }
+}
+#endif
+
+void composeBatch(const Matrix4* parent, const TransformStreams& streams, Matrix4* out, std::size_t count)
+{
+#if defined(NRE_SIMD_X86)
+    const SIMDLevel level = SIMDMath::activeLevel();
+    if (level >= SIMDLevel::AVX2)
+    {
+        composeBatchAVX2(parent, streams, out, count);
+        return;
+    }
+    if (level >= SIMDLevel::SSE41)
+    {
+        composeBatchSSE(parent, streams, out, count);
+        return;
+    }
+#endif
+    composeBatchScalar(parent, streams, out, count);
+}
+} // namespace
+
 Transform::Transform() : position_(0.0F, 0.0F, 0.0F), rotation_(0.0F, 0.0F, 0.0F, 1.0F), scale_(1.0F, 1.0F, 1.0F) {}
 
 void Transform::setPosition(const Vector3& position)
@@ -59,4 +337,17 @@ Matrix4 Transform::localMatrix() const
 
     return result;
 }
+
+void Transform::composeLocalMatrices(const TransformStreams& streams, Matrix4* out, std::size_t count)
+{
+    composeBatch(nullptr, streams, out, count);
+}
+
+void Transform::composeWorldMatrices(const Matrix4& parent,
+                                     const TransformStreams& streams,
+                                     Matrix4* out,
+                                     std::size_t count)
+{
+    composeBatch(&parent, streams, out, count);
+}
 } // namespace nre
@@ -0,0 +1,591 @@
+#include "Scene/TransformHierarchy.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Core/JobSystem.h"
+#include "Math/SIMD_Math.h"
+
+namespace nre
+{
+namespace
+{
+// Upper bound on the run of nodes composed and multiplied per batched kernel call.
+constexpr std::size_t kUpdateBatch = 64;
+// Subtrees up to this size are never split; larger ones leave their root in the serial upper part.
+constexpr std::uint32_t kTaskNodes = 2048;
+
+template <typename T>
+void permute(std::vector<T>& values, const std::vector<std::uint32_t>& order)
+{
+    std::vector<T> result;
+    result.reserve(values.size());
+    for (const std::uint32_t index : order)
+    {
+        result.push_back(values[index]);
+    }
+    values.swap(result);
+}
+
+template <typename T>
+void eraseElements(std::vector<T>& values, std::uint32_t begin, std::uint32_t end)
+{
+    const auto first = values.begin() + static_cast<std::ptrdiff_t>(begin);
+    values.erase(first, first + static_cast<std::ptrdiff_t>(end - begin));
+}
+
+void appendRange(std::vector<std::uint32_t>& indices, std::size_t begin, std::size_t count)
+{
+    for (std::size_t index = begin; index < begin + count; ++index)
+    {
+        indices.push_back(static_cast<std::uint32_t>(index));
+    }
+}
+} // namespace
+
+NodeHandle TransformHierarchy::create(NodeHandle parent)
+{
+    const std::uint32_t parentIndex = parent ? checkedIndex(parent) : kInvalidIndex;
+    const auto index = static_cast<std::uint32_t>(parent_.size());
+
+    std::uint32_t slot = 0;
+    if (!freeSlots_.empty())
+    {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        slotIndex_[slot] = index;
+    }
+    else
+    {
+        slot = static_cast<std::uint32_t>(slotIndex_.size());
+        slotIndex_.push_back(index);
+        slotGeneration_.push_back(1);
+    }
+
+    slot_.push_back(slot);
+    parent_.push_back(parentIndex);
+    subtreeEnd_.push_back(index + 1);
+    const std::uint32_t depth = parentIndex != kInvalidIndex ? depth_[parentIndex] + 1 : 0;
+    depth_.push_back(depth);
+    positionX_.push_back(0.0F);
+    positionY_.push_back(0.0F);
+    positionZ_.push_back(0.0F);
+    rotationX_.push_back(0.0F);
+    rotationY_.push_back(0.0F);
+    rotationZ_.push_back(0.0F);
+    rotationW_.push_back(1.0F);
+    scaleX_.push_back(1.0F);
+    scaleY_.push_back(1.0F);
+    scaleZ_.push_back(1.0F);
+    dirty_.push_back(1);
+    world_.emplace_back();
+
+    // Appending keeps the depth-first order while the parent's subtree is the last one, which is the
+    // common case of building a tree top-down; only the subtree ends go stale. Otherwise the order is
+    // rebuilt on the next update.
+    if (!orderDirty_)
+    {
+        if (parentIndex == kInvalidIndex
+            || (depth <= rightmostPath_.size() && rightmostPath_[depth - 1] == parentIndex))
+        {
+            rightmostPath_.resize(depth);
+            rightmostPath_.push_back(index);
+            subtreeEndsDirty_ = true;
+        }
+        else
+        {
+            orderDirty_ = true;
+        }
+    }
+    ++structureVersion_;
+    return {slot, slotGeneration_[slot]};
+}
+
+void TransformHierarchy::destroy(NodeHandle node)
+{
+    if (!valid(node))
+    {
+        return;
+    }
+    ensureOrder();
+    const std::uint32_t begin = slotIndex_[node.slot];
+    eraseRange(begin, subtreeEnd_[begin]);
+    ++structureVersion_;
+}
+
+void TransformHierarchy::setParent(NodeHandle node, NodeHandle parent)
+{
+    const std::uint32_t index = checkedIndex(node);
+    const std::uint32_t parentIndex = parent ? checkedIndex(parent) : kInvalidIndex;
+    for (std::uint32_t ancestor = parentIndex; ancestor != kInvalidIndex; ancestor = parent_[ancestor])
+    {
+        if (ancestor == index)
+        {
+            throw std::runtime_error("Scene node cannot be parented to itself or a descendant");
+        }
+    }
+    if (parent_[index] == parentIndex)
+    {
+        return;
+    }
+    // The local transform is kept, so the node moves with its new parent.
+    parent_[index] = parentIndex;
+    dirty_[index] = 1;
+    orderDirty_ = true;
+    ++structureVersion_;
+}
+
+void TransformHierarchy::clear()
+{
+    eraseRange(0, static_cast<std::uint32_t>(parent_.size()));
+    orderDirty_ = false;
+    subtreeEndsDirty_ = false;
+    ++structureVersion_;
+}
+
+bool TransformHierarchy::valid(NodeHandle node) const noexcept
+{
+    return node && node.slot < slotIndex_.size() && slotGeneration_[node.slot] == node.generation
+           && slotIndex_[node.slot] != kInvalidIndex;
+}
+
+NodeHandle TransformHierarchy::parent(NodeHandle node) const
+{
+    const std::uint32_t parentIndex = parent_[checkedIndex(node)];
+    return parentIndex != kInvalidIndex ? handleAt(parentIndex) : NodeHandle{};
+}
+
+void TransformHierarchy::setPosition(NodeHandle node, const Vector3& position)
+{
+    const std::uint32_t index = checkedIndex(node);
+    positionX_[index] = position.x;
+    positionY_[index] = position.y;
+    positionZ_[index] = position.z;
+    dirty_[index] = 1;
+}
+
+void TransformHierarchy::setRotation(NodeHandle node, const Quaternion& rotation)
+{
+    const std::uint32_t index = checkedIndex(node);
+    rotationX_[index] = rotation.x;
+    rotationY_[index] = rotation.y;
+    rotationZ_[index] = rotation.z;
+    rotationW_[index] = rotation.w;
+    dirty_[index] = 1;
+}
+
+void TransformHierarchy::setScale(NodeHandle node, const Vector3& scale)
+{
+    const std::uint32_t index = checkedIndex(node);
+    scaleX_[index] = scale.x;
+    scaleY_[index] = scale.y;
+    scaleZ_[index] = scale.z;
+    dirty_[index] = 1;
+}
+
+void TransformHierarchy::setLocalTransform(NodeHandle node, const Transform& transform)
+{
+    setPosition(node, transform.position());
+    setRotation(node, transform.rotation());
+    setScale(node, transform.scale());
+}
+
+Vector3 TransformHierarchy::position(NodeHandle node) const
+{
+    const std::uint32_t index = checkedIndex(node);
+    return {positionX_[index], positionY_[index], positionZ_[index]};
+}
+
+Quaternion TransformHierarchy::rotation(NodeHandle node) const
+{
+    const std::uint32_t index = checkedIndex(node);
+    return {rotationX_[index], rotationY_[index], rotationZ_[index], rotationW_[index]};
+}
+
+Vector3 TransformHierarchy::scale(NodeHandle node) const
+{
+    const std::uint32_t index = checkedIndex(node);
+    return {scaleX_[index], scaleY_[index], scaleZ_[index]};
+}
+
+Transform TransformHierarchy::localTransform(NodeHandle node) const
+{
+    Transform transform;
+    transform.setPosition(position(node));
+    transform.setRotation(rotation(node));
+    transform.setScale(scale(node));
+    return transform;
+}
+
+std::size_t TransformHierarchy::updateWorldMatrices(JobSystem* jobs)
+{
+    ensureOrder();
+    partition();
+
+    // Upper nodes are few; each is its own batch so their parents are always final.
+    Matrix4 parent;
+    Matrix4 local;
+    updated_.clear();
+    for (const std::uint32_t index : upperNodes_)
+    {
+        const std::uint32_t parentIndex = parent_[index];
+        if (parentIndex != kInvalidIndex && dirty_[parentIndex] != 0)
+        {
+            dirty_[index] = 1;
+        }
+        if (dirty_[index] != 0)
+        {
+            composeWorld(index, 1, &parent, &local);
+            updated_.push_back(index);
+        }
+    }
+
+    const std::size_t taskCount = subtreeTasks_.size();
+    if (jobs != nullptr && jobs->workerCount() > 0 && taskCount > 1)
+    {
+        // Each task records into its own list; they are appended in task order, so the result matches
+        // the serial update.
+        if (taskUpdated_.size() < taskCount)
+        {
+            taskUpdated_.resize(taskCount);
+        }
+        jobs->parallelFor(taskCount,
+                          [this](std::size_t task)
+                          {
+                              taskUpdated_[task].clear();
+                              updateRange(subtreeTasks_[task].begin, subtreeTasks_[task].end, taskUpdated_[task]);
+                          });
+        for (std::size_t task = 0; task < taskCount; ++task)
+        {
+            updated_.insert(updated_.end(), taskUpdated_[task].begin(), taskUpdated_[task].end());
+        }
+    }
+    else
+    {
+        for (const NodeRange& task : subtreeTasks_)
+        {
+            updateRange(task.begin, task.end, updated_);
+        }
+    }
+
+    // Upper flags are cleared last: the tasks read them to propagate into their roots.
+    for (const std::uint32_t index : upperNodes_)
+    {
+        dirty_[index] = 0;
+    }
+    return updated_.size();
+}
+
+const Matrix4& TransformHierarchy::worldMatrix(NodeHandle node) const
+{
+    return world_[checkedIndex(node)];
+}
+
+std::uint32_t TransformHierarchy::denseIndex(NodeHandle node) const
+{
+    return checkedIndex(node);
+}
+
+NodeHandle TransformHierarchy::handleAt(std::uint32_t index) const noexcept
+{
+    const std::uint32_t slot = slot_[index];
+    return {slot, slotGeneration_[slot]};
+}
+
+std::uint32_t TransformHierarchy::checkedIndex(NodeHandle node) const
+{
+    if (!valid(node))
+    {
+        throw std::runtime_error("Invalid scene node handle");
+    }
+    return slotIndex_[node.slot];
+}
+
+TransformStreams TransformHierarchy::streamsAt(std::size_t index) const noexcept
+{
+    TransformStreams streams;
+    streams.positionX = positionX_.data() + index;
+    streams.positionY = positionY_.data() + index;
+    streams.positionZ = positionZ_.data() + index;
+    streams.rotationX = rotationX_.data() + index;
+    streams.rotationY = rotationY_.data() + index;
+    streams.rotationZ = rotationZ_.data() + index;
+    streams.rotationW = rotationW_.data() + index;
+    streams.scaleX = scaleX_.data() + index;
+    streams.scaleY = scaleY_.data() + index;
+    streams.scaleZ = scaleZ_.data() + index;
+    return streams;
+}
+
+// Requires the depth-first order, so that [begin, end) is one or more complete subtrees.
+void TransformHierarchy::eraseRange(std::uint32_t begin, std::uint32_t end)
+{
+    for (std::uint32_t index = begin; index < end; ++index)
+    {
+        // Bumping the generation invalidates outstanding handles; 0 is reserved for the null handle.
+        const std::uint32_t slot = slot_[index];
+        slotIndex_[slot] = kInvalidIndex;
+        if (++slotGeneration_[slot] == 0)
+        {
+            slotGeneration_[slot] = 1;
+        }
+        freeSlots_.push_back(slot);
+    }
+
+    eraseElements(slot_, begin, end);
+    eraseElements(parent_, begin, end);
+    eraseElements(subtreeEnd_, begin, end);
+    eraseElements(depth_, begin, end);
+    eraseElements(positionX_, begin, end);
+    eraseElements(positionY_, begin, end);
+    eraseElements(positionZ_, begin, end);
+    eraseElements(rotationX_, begin, end);
+    eraseElements(rotationY_, begin, end);
+    eraseElements(rotationZ_, begin, end);
+    eraseElements(rotationW_, begin, end);
+    eraseElements(scaleX_, begin, end);
+    eraseElements(scaleY_, begin, end);
+    eraseElements(scaleZ_, begin, end);
+    eraseElements(dirty_, begin, end);
+    eraseElements(world_, begin, end);
+
+    // Survivors never point into the erased range, so every index at or past its end shifts down.
+    const std::uint32_t removed = end - begin;
+    for (std::size_t index = 0; index < parent_.size(); ++index)
+    {
+        if (parent_[index] != kInvalidIndex && parent_[index] >= end)
+        {
+            parent_[index] -= removed;
+        }
+        if (subtreeEnd_[index] >= end)
+        {
+            subtreeEnd_[index] -= removed;
+        }
+    }
+    for (std::size_t index = begin; index < slot_.size(); ++index)
+    {
+        slotIndex_[slot_[index]] = static_cast<std::uint32_t>(index);
+    }
+    rebuildRightmostPath();
+}
+
+void TransformHierarchy::ensureOrder()
+{
+    if (orderDirty_)
+    {
+        rebuildOrder();
+    }
+    else if (subtreeEndsDirty_)
+    {
+        refreshSubtreeEnds();
+    }
+}
+
+void TransformHierarchy::rebuildOrder()
+{
+    const std::size_t count = parent_.size();
+
+    // Children grouped per parent (counting sort), keeping their current relative order.
+    std::vector<std::uint32_t> childBegin(count + 1, 0);
+    for (const std::uint32_t parentIndex : parent_)
+    {
+        if (parentIndex != kInvalidIndex)
+        {
+            ++childBegin[parentIndex + 1];
+        }
+    }
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        childBegin[index + 1] += childBegin[index];
+    }
+    std::vector<std::uint32_t> children(childBegin[count]);
+    std::vector<std::uint32_t> cursor(childBegin.begin(), childBegin.end() - 1);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        if (parent_[index] != kInvalidIndex)
+        {
+            children[cursor[parent_[index]]++] = static_cast<std::uint32_t>(index);
+        }
+    }
+
+    // Pre-order walk; children are pushed in reverse so they come out in their original order.
+    std::vector<std::uint32_t> order;
+    order.reserve(count);
+    std::vector<std::uint32_t> stack;
+    for (std::size_t root = count; root-- > 0;)
+    {
+        if (parent_[root] == kInvalidIndex)
+        {
+            stack.push_back(static_cast<std::uint32_t>(root));
+        }
+    }
+    while (!stack.empty())
+    {
+        const std::uint32_t index = stack.back();
+        stack.pop_back();
+        order.push_back(index);
+        for (std::uint32_t child = childBegin[index + 1]; child-- > childBegin[index];)
+        {
+            stack.push_back(children[child]);
+        }
+    }
+
+    std::vector<std::uint32_t> newIndex(count);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        newIndex[order[index]] = static_cast<std::uint32_t>(index);
+    }
+
+    permute(slot_, order);
+    permute(parent_, order);
+    permute(positionX_, order);
+    permute(positionY_, order);
+    permute(positionZ_, order);
+    permute(rotationX_, order);
+    permute(rotationY_, order);
+    permute(rotationZ_, order);
+    permute(rotationW_, order);
+    permute(scaleX_, order);
+    permute(scaleY_, order);
+    permute(scaleZ_, order);
+    permute(dirty_, order);
+    permute(world_, order);
+
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const std::uint32_t parentIndex = parent_[index];
+        if (parentIndex != kInvalidIndex)
+        {
+            parent_[index] = newIndex[parentIndex];
+            depth_[index] = depth_[parent_[index]] + 1;
+        }
+        else
+        {
+            depth_[index] = 0;
+        }
+        slotIndex_[slot_[index]] = static_cast<std::uint32_t>(index);
+    }
+    orderDirty_ = false;
+    refreshSubtreeEnds();
+    rebuildRightmostPath();
+}
+
+// Requires the depth-first order: children follow their parents, so one backward pass suffices.
+void TransformHierarchy::refreshSubtreeEnds()
+{
+    const std::size_t count = parent_.size();
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        subtreeEnd_[index] = static_cast<std::uint32_t>(index + 1);
+    }
+    for (std::size_t index = count; index-- > 0;)
+    {
+        const std::uint32_t parentIndex = parent_[index];
+        if (parentIndex != kInvalidIndex)
+        {
+            subtreeEnd_[parentIndex] = std::max(subtreeEnd_[parentIndex], subtreeEnd_[index]);
+        }
+    }
+    subtreeEndsDirty_ = false;
+}
+
+void TransformHierarchy::rebuildRightmostPath()
+{
+    rightmostPath_.clear();
+    if (parent_.empty())
+    {
+        return;
+    }
+    for (auto index = static_cast<std::uint32_t>(parent_.size() - 1); index != kInvalidIndex; index = parent_[index])
+    {
+        rightmostPath_.push_back(index);
+    }
+    std::reverse(rightmostPath_.begin(), rightmostPath_.end());
+}
+
+void TransformHierarchy::partition()
+{
+    upperNodes_.clear();
+    subtreeTasks_.clear();
+    const auto count = static_cast<std::uint32_t>(parent_.size());
+    std::uint32_t index = 0;
+    while (index < count)
+    {
+        const std::uint32_t end = subtreeEnd_[index];
+        if (end - index > kTaskNodes)
+        {
+            upperNodes_.push_back(index);
+            ++index;
+            continue;
+        }
+        // Adjacent small subtrees (typically siblings) share one task.
+        if (!subtreeTasks_.empty() && subtreeTasks_.back().end == index
+            && end - subtreeTasks_.back().begin <= kTaskNodes)
+        {
+            subtreeTasks_.back().end = end;
+        }
+        else
+        {
+            subtreeTasks_.push_back({index, end});
+        }
+        index = end;
+    }
+}
+
+// [begin, end) holds complete subtrees whose roots have final parents, so one forward pass both
+// propagates the dirty flags down and sees every parent's world matrix finalized before its children
+// need it. Consecutive dirty nodes are batched until a node's parent is still pending in the batch.
+void TransformHierarchy::updateRange(std::size_t begin, std::size_t end, std::vector<std::uint32_t>& updated)
+{
+    Matrix4 parents[kUpdateBatch];
+    Matrix4 locals[kUpdateBatch];
+    std::size_t batchBegin = begin;
+    std::size_t batchCount = 0;
+    for (std::size_t index = begin; index < end; ++index)
+    {
+        const std::uint32_t parentIndex = parent_[index];
+        if (parentIndex != kInvalidIndex && dirty_[parentIndex] != 0)
+        {
+            dirty_[index] = 1;
+        }
+        if (dirty_[index] == 0)
+        {
+            continue;
+        }
+
+        if (batchCount > 0
+            && (batchBegin + batchCount != index || batchCount == kUpdateBatch
+                || (parentIndex != kInvalidIndex && parentIndex >= batchBegin)))
+        {
+            composeWorld(batchBegin, batchCount, parents, locals);
+            appendRange(updated, batchBegin, batchCount);
+            batchCount = 0;
+        }
+        if (batchCount == 0)
+        {
+            batchBegin = index;
+        }
+        ++batchCount;
+    }
+    if (batchCount > 0)
+    {
+        composeWorld(batchBegin, batchCount, parents, locals);
+        appendRange(updated, batchBegin, batchCount);
+    }
+
+    std::fill(dirty_.begin() + static_cast<std::ptrdiff_t>(begin), dirty_.begin() + static_cast<std::ptrdiff_t>(end),
+              std::uint8_t{0});
+}
+
+void TransformHierarchy::composeWorld(std::size_t begin, std::size_t count, Matrix4* parents, Matrix4* locals)
+{
+    Transform::composeLocalMatrices(streamsAt(begin), locals, count);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const std::uint32_t parentIndex = parent_[begin + index];
+        parents[index] = parentIndex != kInvalidIndex ? world_[parentIndex] : Matrix4{};
+    }
+    SIMDMath::multiply4x4Aligned(parents, locals, world_.data() + begin, count);
+}
+} // namespace nre
@@ -0,0 +1,471 @@
+#include "Scene/WorldPartition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "Renderer/MeshCache.h"
+
+namespace nre
+{
+namespace
+{
+std::size_t meshBytes(const MeshData& data)
+{
+    return data.vertices.size() * sizeof(Vertex) + data.indices.size() * sizeof(std::uint32_t);
+}
+
+float axisDistance(float value, float cellMin, float cellSize)
+{
+    return std::max({cellMin - value, value - (cellMin + cellSize), 0.0F});
+}
+} // namespace
+
+WorldPartition::WorldPartition(MeshCache& meshes, TextureLoader& textures, float cellSize)
+    : meshCache_(&meshes), textureLoader_(&textures), cellSize_(cellSize)
+{
+    if (!(cellSize > 0.0F))
+    {
+        throw std::runtime_error("WorldPartition cell size must be positive");
+    }
+    thread_ = std::thread([this] { streamingLoop(); });
+}
+
+WorldPartition::~WorldPartition()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+WorldPartition::CellCoord WorldPartition::cellAt(const Vector3& position) const noexcept
+{
+    return {static_cast<std::int32_t>(std::floor(position.x / cellSize_)),
+            static_cast<std::int32_t>(std::floor(position.z / cellSize_))};
+}
+
+std::uint32_t WorldPartition::addMesh(const CellCoord& cell, const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Cell& target = registerCell(cell);
+    target.meshPaths.push_back(path);
+    return static_cast<std::uint32_t>(target.meshPaths.size() - 1);
+}
+
+std::uint32_t WorldPartition::addTexture(const CellCoord& cell, const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Cell& target = registerCell(cell);
+    target.texturePaths.push_back(path);
+    return static_cast<std::uint32_t>(target.texturePaths.size() - 1);
+}
+
+void WorldPartition::setStreamingRadii(float loadRadius, float unloadRadius)
+{
+    if (!(loadRadius > 0.0F) || !(unloadRadius >= loadRadius))
+    {
+        throw std::runtime_error("WorldPartition radii must satisfy 0 < load radius <= unload radius");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loadRadius_ = loadRadius;
+        unloadRadius_ = unloadRadius;
+        ++version_;
+    }
+    wake_.notify_one();
+}
+
+void WorldPartition::setLookAhead(float seconds)
+{
+    if (!(seconds >= 0.0F))
+    {
+        throw std::runtime_error("WorldPartition look-ahead must not be negative");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lookAhead_ = seconds;
+        ++version_;
+    }
+    wake_.notify_one();
+}
+
+void WorldPartition::setMemoryBudget(std::size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = bytes;
+        ++version_;
+    }
+    wake_.notify_one();
+}
+
+void WorldPartition::update(const Vector3& cameraPosition, const Vector3& cameraVelocity)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        camera_ = cameraPosition;
+        velocity_ = cameraVelocity;
+        started_ = true;
+        ++version_;
+    }
+    wake_.notify_one();
+    applyResults();
+}
+
+void WorldPartition::flush()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!started_)
+            {
+                return;
+            }
+            idleChanged_.wait(lock, [this] { return idle_ && plannedVersion_ == version_; });
+            if (uploads_.empty() && evictions_.empty())
+            {
+                return;
+            }
+        }
+        applyResults();
+    }
+}
+
+bool WorldPartition::isResident(const CellCoord& cell) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Cell* found = findCell(cell);
+    return found != nullptr && (found->state == CellState::Resident || found->state == CellState::Evicting);
+}
+
+std::shared_ptr<Mesh> WorldPartition::residentMesh(const CellCoord& cell, std::uint32_t asset) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Cell* found = findCell(cell);
+    return found != nullptr && asset < found->meshes.size() ? found->meshes[asset] : nullptr;
+}
+
+std::shared_ptr<Texture> WorldPartition::residentTexture(const CellCoord& cell, std::uint32_t asset) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Cell* found = findCell(cell);
+    return found != nullptr && asset < found->textures.size() ? found->textures[asset] : nullptr;
+}
+
+std::size_t WorldPartition::residentCellCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(std::count_if(cells_.begin(),
+                                                  cells_.end(),
+                                                  [](const auto& entry)
+                                                  {
+                                                      return entry.second.state == CellState::Resident
+                                                             || entry.second.state == CellState::Evicting;
+                                                  }));
+}
+
+std::size_t WorldPartition::residentBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return committedBytes_;
+}
+
+std::uint64_t WorldPartition::cellKey(const CellCoord& cell) noexcept
+{
+    return (std::uint64_t{static_cast<std::uint32_t>(cell.x)} << 32U) | static_cast<std::uint32_t>(cell.z);
+}
+
+WorldPartition::Cell& WorldPartition::registerCell(const CellCoord& cell)
+{
+    // The streaming thread holds on to cells across unlocked decodes, so the map must not change once
+    // it runs.
+    if (started_)
+    {
+        throw std::runtime_error("WorldPartition cells cannot change once streaming has started");
+    }
+    Cell& target = cells_[cellKey(cell)];
+    target.coord = cell;
+    return target;
+}
+
+const WorldPartition::Cell* WorldPartition::findCell(const CellCoord& cell) const
+{
+    const auto it = cells_.find(cellKey(cell));
+    return it != cells_.end() ? &it->second : nullptr;
+}
+
+float WorldPartition::cellDistance(const Cell& cell) const noexcept
+{
+    const float minX = static_cast<float>(cell.coord.x) * cellSize_;
+    const float minZ = static_cast<float>(cell.coord.z) * cellSize_;
+    const auto distanceFrom = [&](float x, float z)
+    {
+        const float dx = axisDistance(x, minX, cellSize_);
+        const float dz = axisDistance(z, minZ, cellSize_);
+        return std::sqrt(dx * dx + dz * dz);
+    };
+    return std::min(distanceFrom(camera_.x, camera_.z),
+                    distanceFrom(camera_.x + velocity_.x * lookAhead_, camera_.z + velocity_.z * lookAhead_));
+}
+
+void WorldPartition::streamingLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        const std::uint64_t version = version_;
+        Cell* cell = planLocked();
+        if (cell == nullptr)
+        {
+            idle_ = true;
+            plannedVersion_ = version;
+            idleChanged_.notify_all();
+            wake_.wait(lock, [this, version] { return stopping_ || version_ != version; });
+            idle_ = false;
+            continue;
+        }
+
+        // Paths are immutable once streaming has started, so they can be read without the lock.
+        cell->state = CellState::Loading;
+        lock.unlock();
+        std::vector<MeshData> meshData;
+        meshData.reserve(cell->meshPaths.size());
+        for (const std::string& path : cell->meshPaths)
+        {
+            try
+            {
+                meshData.push_back(loadMeshFromFile(path));
+            }
+            catch (const std::exception& ex)
+            {
+                std::cerr << "WorldPartition: failed to load '" << path << "': " << ex.what() << '\n';
+                meshData.emplace_back();
+            }
+        }
+        std::vector<TextureImage> images;
+        images.reserve(cell->texturePaths.size());
+        for (const std::string& path : cell->texturePaths)
+        {
+            images.push_back(TextureLoader::decode(path));
+        }
+        lock.lock();
+        storeLocked(*cell, std::move(meshData), std::move(images));
+    }
+}
+
+WorldPartition::Cell* WorldPartition::planLocked()
+{
+    if (!started_)
+    {
+        return nullptr;
+    }
+
+    candidates_.clear();
+    for (auto& entry : cells_)
+    {
+        Cell& cell = entry.second;
+        const float distance = cellDistance(cell);
+        if ((cell.state == CellState::Resident || cell.state == CellState::Decoded) && distance > unloadRadius_)
+        {
+            evictLocked(cell);
+        }
+        else if (cell.state == CellState::Unloaded && distance <= loadRadius_)
+        {
+            candidates_.emplace_back(distance, &cell);
+        }
+    }
+    if (parked_ != nullptr && !settleParkedLocked())
+    {
+        return nullptr;
+    }
+
+    std::sort(candidates_.begin(),
+              candidates_.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    for (const auto& [distance, cell] : candidates_)
+    {
+        // Cells loaded before know their size; the others are checked once decoded. Cells that cannot fit
+        // are skipped so the ones behind them still load.
+        const Reservation reservation = cell->sized ? reserveLocked(cell->bytes, distance) : Reservation::Granted;
+        if (reservation == Reservation::Granted)
+        {
+            return cell;
+        }
+        if (reservation == Reservation::Pending)
+        {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+WorldPartition::Reservation WorldPartition::reserveLocked(std::size_t bytes, float distance)
+{
+    // Only cells farther than the requester may make room for it. Check that they can free enough before
+    // evicting any of them.
+    std::size_t evictable = 0;
+    for (const auto& entry : cells_)
+    {
+        const Cell& cell = entry.second;
+        if ((cell.state == CellState::Resident || cell.state == CellState::Decoded) && cellDistance(cell) > distance)
+        {
+            evictable += cell.bytes;
+        }
+    }
+    if (bytes > budget_ || committedBytes_ - evictingBytes_ - evictable > budget_ - bytes)
+    {
+        return Reservation::Refused;
+    }
+
+    // Evict the farthest of them until the request fits once evictions finish.
+    while (committedBytes_ - evictingBytes_ + bytes > budget_)
+    {
+        Cell* farthest = nullptr;
+        float farthestDistance = distance;
+        for (auto& entry : cells_)
+        {
+            Cell& cell = entry.second;
+            if (cell.state != CellState::Resident && cell.state != CellState::Decoded)
+            {
+                continue;
+            }
+            const float cellDistanceValue = cellDistance(cell);
+            if (cellDistanceValue > farthestDistance)
+            {
+                farthest = &cell;
+                farthestDistance = cellDistanceValue;
+            }
+        }
+        evictLocked(*farthest);
+    }
+    return committedBytes_ + bytes <= budget_ ? Reservation::Granted : Reservation::Pending;
+}
+
+void WorldPartition::evictLocked(Cell& cell)
+{
+    if (cell.state == CellState::Decoded)
+    {
+        // Never uploaded, so there is nothing for the render thread to release.
+        uploads_.erase(std::find(uploads_.begin(), uploads_.end(), &cell));
+        cell.meshData.clear();
+        cell.images.clear();
+        committedBytes_ -= cell.bytes;
+        cell.state = CellState::Unloaded;
+        return;
+    }
+    cell.state = CellState::Evicting;
+    evictingBytes_ += cell.bytes;
+    evictions_.push_back(&cell);
+}
+
+void WorldPartition::storeLocked(Cell& cell, std::vector<MeshData> meshData, std::vector<TextureImage> images)
+{
+    std::size_t bytes = 0;
+    for (const MeshData& data : meshData)
+    {
+        bytes += meshBytes(data);
+    }
+    for (const TextureImage& image : images)
+    {
+        bytes += image.rgba.size();
+    }
+    cell.bytes = bytes;
+    cell.sized = true;
+    cell.meshData = std::move(meshData);
+    cell.images = std::move(images);
+    cell.state = CellState::Parked;
+    parked_ = &cell;
+    settleParkedLocked();
+}
+
+bool WorldPartition::settleParkedLocked()
+{
+    // The camera may have moved on, or the budget may have filled up, while the cell was decoding.
+    Cell& cell = *parked_;
+    const float distance = cellDistance(cell);
+    const Reservation reservation =
+        stopping_ || distance > unloadRadius_ ? Reservation::Refused : reserveLocked(cell.bytes, distance);
+    if (reservation == Reservation::Pending)
+    {
+        return false;
+    }
+    parked_ = nullptr;
+    if (reservation == Reservation::Refused)
+    {
+        cell.meshData.clear();
+        cell.images.clear();
+        cell.state = CellState::Unloaded;
+        return true;
+    }
+    cell.state = CellState::Decoded;
+    committedBytes_ += cell.bytes;
+    uploads_.push_back(&cell);
+    return true;
+}
+
+void WorldPartition::applyResults()
+{
+    std::vector<Cell*> uploads;
+    std::vector<std::shared_ptr<Mesh>> releasedMeshes;
+    std::vector<std::shared_ptr<Texture>> releasedTextures;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uploads.swap(uploads_);
+        // From here on only the render thread touches these cells' payloads; the streaming thread can
+        // still evict them, which the next call handles.
+        for (Cell* cell : uploads)
+        {
+            cell->state = CellState::Resident;
+        }
+        for (Cell* cell : evictions_)
+        {
+            std::move(cell->meshes.begin(), cell->meshes.end(), std::back_inserter(releasedMeshes));
+            std::move(cell->textures.begin(), cell->textures.end(), std::back_inserter(releasedTextures));
+            cell->meshes.clear();
+            cell->textures.clear();
+            committedBytes_ -= cell->bytes;
+            evictingBytes_ -= cell->bytes;
+            cell->state = CellState::Unloaded;
+        }
+        if (!evictions_.empty())
+        {
+            evictions_.clear();
+            // Freed memory may let the streaming thread load what did not fit before.
+            ++version_;
+            wake_.notify_one();
+        }
+    }
+
+    for (Cell* cell : uploads)
+    {
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        meshes.reserve(cell->meshData.size());
+        for (std::size_t asset = 0; asset < cell->meshData.size(); ++asset)
+        {
+            const MeshData& data = cell->meshData[asset];
+            const bool loaded = !data.vertices.empty() && !data.indices.empty();
+            meshes.push_back(loaded ? meshCache_->loadFromData(cell->meshPaths[asset], data) : nullptr);
+        }
+        std::vector<std::shared_ptr<Texture>> textures;
+        textures.reserve(cell->images.size());
+        for (std::size_t asset = 0; asset < cell->images.size(); ++asset)
+        {
+            textures.push_back(textureLoader_->load(cell->texturePaths[asset], cell->images[asset]));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        cell->meshes = std::move(meshes);
+        cell->textures = std::move(textures);
+        cell->meshData.clear();
+        cell->images.clear();
+    }
+}
+} // namespace nre